@@ -0,0 +1,80 @@
+/**
+ * @file        atomic.h
+ * @brief       Atomic operations and memory barriers for the Cortex-A53 cores.
+ * @description This header declares atomic read-modify-write operations on 32-bit
+ *              words built on exclusive loads/stores, and the inner-shareable
+ *              memory barriers used to order accesses between cores.
+ * 
+ * @note        Exclusive accesses need the MMU and the caches to be enabled.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _ATOMIC_H_
+#define _ATOMIC_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Atomically adds a value to a word.
+ * 
+ * @param v Pointer to the word.
+ * @param i Value to add.
+ * 
+ * @return The new value of the word.
+ */
+extern uint32_t atomic_add_return(volatile uint32_t *v, uint32_t i);
+
+/**
+ * @brief Atomically subtracts a value from a word.
+ * 
+ * @param v Pointer to the word.
+ * @param i Value to subtract.
+ * 
+ * @return The new value of the word.
+ */
+extern uint32_t atomic_sub_return(volatile uint32_t *v, uint32_t i);
+
+/**
+ * @brief Atomically replaces a word.
+ * 
+ * @param v   Pointer to the word.
+ * @param val New value.
+ * 
+ * @return The previous value of the word.
+ */
+extern uint32_t atomic_xchg(volatile uint32_t *v, uint32_t val);
+
+/**
+ * @brief Atomically replaces a word if it holds an expected value.
+ * 
+ * @param v    Pointer to the word.
+ * @param old  Expected value.
+ * @param val  New value, stored only if the word equals `old`.
+ * 
+ * @return The previous value of the word (equal to `old` on success).
+ */
+extern uint32_t atomic_cmpxchg(volatile uint32_t *v, uint32_t old, uint32_t val);
+
+/**
+ * @brief Full memory barrier between cores (`dmb ish`).
+ */
+extern void smp_mb(void);
+
+/**
+ * @brief Store barrier between cores (`dmb ishst`).
+ * 
+ * Orders prior stores before later stores, e.g. ring buffer data before its index.
+ */
+extern void smp_wmb(void);
+
+/**
+ * @brief Load barrier between cores (`dmb ishld`).
+ * 
+ * Orders prior loads before later loads and stores, e.g. a ring buffer index
+ * before the data it publishes.
+ */
+extern void smp_rmb(void);
+
+#endif /* _ATOMIC_H_ */
@@ -15,9 +15,17 @@
 #ifndef _BASE_H_
 #define _BASE_H_
 
+// Macro for setting a bit at position x
+#define BIT_0(x)                    (0 << x)  // Set bit to 0 at position x
+#define BIT_1(x)                    (1 << x)  // Set bit to 1 at position x
+
 // Base address for the Raspberry Pi peripheral registers
 #define PIBASE  0x3F000000
 
-#define CORE_CLOCK_SPEED 150000000
+// Base address of the ARM local peripherals (local timers, mailboxes, interrupt routing)
+#define LOCAL_PIBASE  0x40000000
+
+// Number of Cortex-A53 cores of the BCM2837B0
+#define NR_CORES    4
 
 #endif /* _BASE_H_ */
\ No newline at end of file
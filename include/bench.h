@@ -0,0 +1,61 @@
+/**
+ * @file        bench.h
+ * @brief       On-target benchmark suite.
+ * @description This header declares the benchmark image, built with `make bench`
+ *              (BENCH=1). kernel_main runs the suite once the drivers are initialized,
+ *              instead of starting the tasks. The results are printed over UART between
+ *              a `BENCH begin` and a `BENCH end` line, one result per line:
+ * 
+ *                  BENCH name=<name> value=<number> unit=<unit>
+ * 
+ *              A failed measurement reports value=-1. The other output lines (padding
+ *              of the UART test) do not start with `BENCH `.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+// Benchmark image: off (0) or on (1), see the Makefile
+#ifndef BENCH
+#define BENCH                   0
+#endif
+
+// UART test: characters sent through uart_send()
+#define BENCH_UART_BYTES        2048
+
+// I2C test: bytes per write and writes per divider
+#define BENCH_I2C_BYTES         32
+#define BENCH_I2C_WRITES        8
+
+// LCD test: full-screen redraws
+#define BENCH_LCD_REDRAWS       4
+
+// IRQ latency test: local timer ticks sampled
+#define BENCH_IRQ_SAMPLES       32
+
+// Exception frame test: calls of each probe of entry.S
+#define BENCH_FRAME_CALLS       1024
+
+// Sleep test: samples per duration
+#define BENCH_DELAY_SAMPLES     16
+
+// memzero test: buffer size in pages and passes over it
+#define BENCH_MEMZERO_PAGES     64
+#define BENCH_MEMZERO_PASSES    16
+
+#if BENCH
+
+/**
+ * @brief Runs the benchmark suite and prints its results.
+ * 
+ * Runs on core 0 before the tasks and the other cores are started, with the UART,
+ * the timers, the I2C controller and the LCD initialized.
+ */
+extern void bench_run(void);
+
+#endif /* BENCH */
+
+#endif /* _BENCH_H_ */
@@ -0,0 +1,110 @@
+/**
+ * @file        clock.h
+ * @brief       ARM and VPU core clock control.
+ * @description This header declares the clock rates queried from the firmware through
+ *              the mailbox and the performance states of the ARM clock. The cores run
+ *              at the lowest ARM rate by default; code with a burst of work holds the
+ *              highest rate between clock_perf_get() and clock_perf_put(), and the rate
+ *              drops back when the last holder is done.
+ * 
+ *              Drivers clocked by the VPU core clock (mini UART) register a notifier,
+ *              called around every change of the core rate.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+#include <stdint.h>
+
+// Rates used when the firmware does not answer: the 400 MHz core clock is the one
+// the former fixed mini UART divisor (433) assumed, 600 MHz the lowest ARM rate
+#define CLOCK_CORE_DEFAULT_HZ   400000000
+#define CLOCK_ARM_DEFAULT_HZ    600000000
+
+// Core clock notifiers (see clock_register_notifier)
+#define CLOCK_MAX_NOTIFIERS     4
+
+// Notifier events
+#define CLOCK_PRE_CHANGE        0       // The core rate is about to change (rate: current one)
+#define CLOCK_POST_CHANGE       1       // The core rate changed (rate: new one)
+
+/**
+ * @brief Core clock notifier.
+ * 
+ * Called by clock_set_core_hz() with IRQs masked, before and after the change.
+ * 
+ * @param event   CLOCK_PRE_CHANGE or CLOCK_POST_CHANGE.
+ * @param core_hz Core rate in Hz.
+ */
+typedef void (*clock_notifier_t)(uint32_t event, uint32_t core_hz);
+
+/**
+ * @brief Queries the ARM and core clock rates and switches to the low performance state.
+ * 
+ * Polls the mailbox: usable before interrupts are set up. Must run before the
+ * drivers that depend on the core rate (uart_init).
+ */
+extern void clock_init(void);
+
+/**
+ * @brief Returns the current ARM clock rate.
+ * 
+ * @return Rate in Hz.
+ */
+extern uint32_t clock_get_arm_hz(void);
+
+/**
+ * @brief Returns the lowest and highest ARM clock rates allowed by the firmware.
+ * 
+ * @param[out] min_hz Lowest rate in Hz (rate of the low performance state).
+ * @param[out] max_hz Highest rate in Hz (rate of the high performance state).
+ */
+extern void clock_get_arm_range(uint32_t *min_hz, uint32_t *max_hz);
+
+/**
+ * @brief Returns the current VPU core clock rate.
+ * 
+ * @return Rate in Hz.
+ */
+extern uint32_t clock_get_core_hz(void);
+
+/**
+ * @brief Changes the VPU core clock rate.
+ * 
+ * The notifiers are called with CLOCK_PRE_CHANGE, the rate is set, then they are
+ * called with CLOCK_POST_CHANGE and the rate set by the firmware (also when the
+ * request failed, with the unchanged rate).
+ * 
+ * @param hz Requested rate in Hz.
+ * 
+ * @return 0, or -1 if the firmware rejected the rate.
+ */
+extern int clock_set_core_hz(uint32_t hz);
+
+/**
+ * @brief Registers a core clock notifier.
+ * 
+ * @param notifier Function called around every core rate change.
+ * 
+ * @return 0, or -1 if CLOCK_MAX_NOTIFIERS are already registered.
+ */
+extern int clock_register_notifier(clock_notifier_t notifier);
+
+/**
+ * @brief Enters a burst: the ARM clock runs at its highest rate until the matching
+ *        clock_perf_put().
+ * 
+ * Calls nest and may come from any core or task; only the first one changes the
+ * rate. Not from interrupt handlers: the change waits for the firmware.
+ */
+extern void clock_perf_get(void);
+
+/**
+ * @brief Leaves a burst: the ARM clock drops to its lowest rate once no burst is left.
+ */
+extern void clock_perf_put(void);
+
+#endif /* _CLOCK_H_ */
@@ -0,0 +1,55 @@
+/**
+ * @file        deferred_work.h
+ * @brief       Deferred work (bottom halves) for interrupt handlers.
+ * @description This header declares the facility used by interrupt handlers to move
+ *              slow processing out of IRQ context. A handler queues a `struct
+ *              deferred_work` and returns; the work then runs with interrupts enabled
+ *              on DEFERRED_WORK_CORE, or in the kernel_main loop of core 0 when that
+ *              core is not online. A work item that is already pending is not queued
+ *              a second time, so a slow job coalesces instead of piling up.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _DEFERRED_WORK_H_
+#define _DEFERRED_WORK_H_
+
+#include <stdint.h>
+#include "workqueue.h"
+
+// Core that runs the deferred work (falls back to core 0 when it is not online)
+#define DEFERRED_WORK_CORE      1
+
+/**
+ * @brief A deferred work item.
+ */
+struct deferred_work {
+    work_fn_t fn;                   // Function to run
+    void *arg;                      // Argument passed to the function
+    volatile uint32_t pending;      // 1 while queued and not yet started
+};
+
+// Static initializer of a deferred work item
+#define DEFERRED_WORK_INIT(f, a)    { (f), (a), 0 }
+
+/**
+ * @brief Queues a deferred work item.
+ * 
+ * Safe to call from interrupt handlers and from any core. If the item is already
+ * pending, the call does nothing.
+ * 
+ * @param work Pointer to the work item.
+ * 
+ * @return 0 if the item was queued or already pending, -1 if the queue is full.
+ */
+extern int deferred_work_schedule(struct deferred_work *work);
+
+/**
+ * @brief Returns the number of times a work item could not be queued.
+ * 
+ * @return The number of failed deferred_work_schedule() calls.
+ */
+extern uint32_t deferred_work_dropped(void);
+
+#endif /* _DEFERRED_WORK_H_ */
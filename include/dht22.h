@@ -7,9 +7,58 @@
 #define DHT22_OK             0
 #define DHT22_TIMEOUT_ERROR -1
 #define DHT22_CHECKSUM_ERROR -2
+#define DHT22_BUSY_ERROR    -3
+#define DHT22_RATE_ERROR    -4  // Less than DHT22_MIN_INTERVAL_US since the previous read
+#define DHT22_RANGE_ERROR   -5  // Valid checksum, implausible value
+#define DHT22_NO_DATA       -6  // No valid sample recorded yet
+
+// The sensor needs 2s between two reads (and after power-up)
+#define DHT22_MIN_INTERVAL_US   2000000
+
+// Number of valid samples kept for the moving statistics
+#define DHT22_HISTORY_SIZE      32
+
+// Sensor range, in 0.1 units
+#define DHT22_TEMP_MIN          (-400)  // -40.0 °C
+#define DHT22_TEMP_MAX          800     // 80.0 °C
+#define DHT22_HUM_MAX           1000    // 100.0 %RH
+
+// A timestamped sample, in fixed point (print with "%.1f").
+// 16 bytes, temperature at offset 8 and humidity at 10: see neon_sample_minmax (fpsimd.h)
+struct dht22_sample {
+    uint64_t timestamp;     // timer_get_ticks() at the start of the read (µs)
+    int16_t temperature;    // 0.1 °C
+    uint16_t humidity;      // 0.1 %RH
+};
+
+// Moving statistics over the last DHT22_HISTORY_SIZE valid samples
+struct dht22_stats {
+    uint32_t count;         // Number of samples in the window
+    int16_t temp_avg;       // 0.1 °C
+    int16_t temp_min;
+    int16_t temp_max;
+    uint16_t hum_avg;       // 0.1 %RH
+    uint16_t hum_min;
+    uint16_t hum_max;
+};
+
+// Result of a read: status, the raw 40-bit frame and the converted sample
+struct dht22_result {
+    int status;             // DHT22_OK, DHT22_TIMEOUT_ERROR, DHT22_CHECKSUM_ERROR or DHT22_RANGE_ERROR
+    uint32_t edges;         // Number of edges captured
+    uint8_t data[5];        // Humidity (2 bytes), temperature (2 bytes), checksum
+    struct dht22_sample sample; // Converted sample (valid if status is DHT22_OK)
+};
+
+// Completion callback of dht22_read_async(), run as deferred work (not in IRQ context)
+typedef void (*dht22_callback_t)(const struct dht22_result *result, void *arg);
 
 // Function prototypes
 extern void dht22_init(void); // Initialization function
-extern int dht22_read(float *temperature, float *humidity); // Read function
+extern int dht22_read_async(dht22_callback_t callback, void *arg); // Start a capture-based read
+extern int dht22_read(struct dht22_sample *sample); // Blocking read function
+extern int dht22_sampler_start(uint32_t period_us); // Periodic sampling into the history
+extern int dht22_get_latest(struct dht22_sample *sample); // Cached latest sample, O(1)
+extern int dht22_get_stats(struct dht22_stats *stats); // Cached moving statistics, O(1)
 
 #endif // DHT22_H
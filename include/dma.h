@@ -0,0 +1,255 @@
+/**
+ * @file        dma.h
+ * @brief       DMA controller driver interface for the BCM2837.
+ * @description This header defines the registers of the DMA engine, its control
+ *              blocks and the functions to allocate channels, run control-block
+ *              chains, copy or fill memory and pace transfers with a peripheral
+ *              DREQ. Addresses given to the engine are bus addresses: RAM is seen
+ *              through the uncached alias (DMA_BUS_RAM) and the ARM caches are
+ *              maintained by the driver around each transfer.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _DMA_H_
+#define _DMA_H_
+
+#include "base.h"
+#include <stdint.h>
+
+#define DMA_BASE_ADDR       (PIBASE + 0x7000)
+#define DMA_CHANNEL_STRIDE  0x100
+#define DMA_INT_STATUS_ADDR (DMA_BASE_ADDR + 0xFE0)
+#define DMA_ENABLE_ADDR     (DMA_BASE_ADDR + 0xFF0)
+
+// Channels 0-14 live in the DMA_BASE_ADDR block (channel 15 is elsewhere, not used)
+#define DMA_NR_CHANNELS     15
+
+// Channels the driver may allocate: free of the firmware and each with its own IRQ line.
+// Channels 0-6 are full channels, 7 and up are lite (no 2D mode, 64KB per control block).
+#define DMA_CHANNEL_MASK    ((1 << 0) | (1 << 2) | (1 << 4) | (1 << 5) | (1 << 8) | (1 << 9) | (1 << 10))
+#define DMA_LITE_FIRST      7
+
+// Largest length of one control block
+#define DMA_MAX_LEN         0x3FFFFFE0      // Full channel (30 bits, multiple of 32)
+#define DMA_LITE_MAX_LEN    0xFFE0          // Lite channel (16 bits, multiple of 32)
+
+// Control blocks per channel used by dma_memcpy()/dma_memset()/dma_fifo_*()
+#define DMA_CHAIN_MAX       4
+
+// Bus address views
+#define DMA_BUS_RAM         0xC0000000      // RAM through the L2-uncached alias
+#define DMA_BUS_PERIPHERAL  0x7E000000      // Peripheral window (PIBASE on the ARM side)
+
+// DMA channel registers
+struct DMA_Channel_Registers
+{
+    volatile uint32_t CS;           // Control and Status (offset 0x00)
+    volatile uint32_t CONBLK_AD;    // Control Block Address (offset 0x04)
+    volatile uint32_t TI;           // Transfer Information, from the control block (offset 0x08)
+    volatile uint32_t SOURCE_AD;    // Source Address (offset 0x0C)
+    volatile uint32_t DEST_AD;      // Destination Address (offset 0x10)
+    volatile uint32_t TXFR_LEN;     // Transfer Length (offset 0x14)
+    volatile uint32_t STRIDE;       // 2D Stride (offset 0x18)
+    volatile uint32_t NEXTCONBK;    // Next Control Block Address (offset 0x1C)
+    volatile uint32_t DEBUG;        // Debug (offset 0x20)
+};
+
+#define DMA_CHANNEL(n)  ((struct DMA_Channel_Registers *)(uint64_t)(DMA_BASE_ADDR + (n) * DMA_CHANNEL_STRIDE))
+#define DMA_INT_STATUS  ((volatile uint32_t *)(DMA_INT_STATUS_ADDR))
+#define DMA_ENABLE      ((volatile uint32_t *)(DMA_ENABLE_ADDR))
+
+// Bit definitions for the CS register
+#define DMA_CS_ACTIVE                       (1 << 0)    // Start / running
+#define DMA_CS_END                          (1 << 1)    // Transfer complete (write 1 to clear)
+#define DMA_CS_INT                          (1 << 2)    // Interrupt status (write 1 to clear)
+#define DMA_CS_ERROR                        (1 << 8)    // Error, details in DEBUG
+#define DMA_CS_PRIORITY(p)                  (((p) & 0xF) << 16)  // AXI priority
+#define DMA_CS_PANIC_PRIORITY(p)            (((p) & 0xF) << 20)  // AXI panic priority
+#define DMA_CS_WAIT_FOR_OUTSTANDING_WRITES  (1 << 28)   // END only once the writes landed
+#define DMA_CS_ABORT                        (1 << 30)   // Abort the current control block
+#define DMA_CS_RESET                        (1U << 31)  // Reset the channel
+
+// Bit definitions for the TI field of a control block
+#define DMA_TI_INTEN                        (1 << 0)    // Interrupt when this block completes
+#define DMA_TI_WAIT_RESP                    (1 << 3)    // Wait for the write response
+#define DMA_TI_DEST_INC                     (1 << 4)    // Increment the destination
+#define DMA_TI_DEST_WIDTH                   (1 << 5)    // 128-bit destination writes
+#define DMA_TI_DEST_DREQ                    (1 << 6)    // Pace writes with PERMAP's DREQ
+#define DMA_TI_SRC_INC                      (1 << 8)    // Increment the source
+#define DMA_TI_SRC_WIDTH                    (1 << 9)    // 128-bit source reads
+#define DMA_TI_SRC_DREQ                     (1 << 10)   // Pace reads with PERMAP's DREQ
+#define DMA_TI_PERMAP(p)                    (((p) & 0x1F) << 16)  // Peripheral DREQ
+#define DMA_TI_NO_WIDE_BURSTS               (1 << 26)
+
+// Bit definitions for the DEBUG register (write 1 to clear)
+#define DMA_DEBUG_READ_LAST_NOT_SET_ERROR   (1 << 0)
+#define DMA_DEBUG_FIFO_ERROR                (1 << 1)
+#define DMA_DEBUG_READ_ERROR                (1 << 2)
+#define DMA_DEBUG_ERRORS                    (DMA_DEBUG_READ_LAST_NOT_SET_ERROR | DMA_DEBUG_FIFO_ERROR | DMA_DEBUG_READ_ERROR)
+
+// Peripheral DREQ numbers (TI.PERMAP).
+// The BSC masters have no DREQ: only the BSC/SPI slave does (DMA_DREQ_BSC_SLAVE_*).
+#define DMA_DREQ_NONE               0
+#define DMA_DREQ_BSC_SLAVE_TX       2
+#define DMA_DREQ_BSC_SLAVE_RX       3
+#define DMA_DREQ_SPI_TX             6
+#define DMA_DREQ_SPI_RX             7
+#define DMA_DREQ_UART_TX            12      // PL011 transmit FIFO
+#define DMA_DREQ_UART_RX            14      // PL011 receive FIFO
+
+// Return codes
+#define DMA_OK          0
+#define DMA_EINVAL      -1      // Invalid argument
+#define DMA_EBUSY       -2      // No free channel / channel running
+#define DMA_EBUS        -3      // The engine reported an error (DEBUG)
+#define DMA_PENDING     1       // Transfer in progress
+
+/**
+ * @brief A DMA control block.
+ * 
+ * Read by the engine from memory: must be 32-byte aligned, addresses are bus
+ * addresses (dma_bus_addr()) and nextconbk links the chain (0 ends it).
+ */
+struct dma_cb {
+    uint32_t ti;                    // Transfer information (DMA_TI_*)
+    uint32_t source_ad;             // Source bus address
+    uint32_t dest_ad;               // Destination bus address
+    uint32_t txfr_len;              // Transfer length (bytes)
+    uint32_t stride;                // 2D stride (full channels only)
+    uint32_t nextconbk;             // Bus address of the next control block, or 0
+    uint32_t reserved[2];
+} __attribute__((aligned(32)));
+
+// Completion callback, called from the DMA interrupt with the channel and its status
+typedef void (*dma_callback_t)(int channel, int status, void *arg);
+
+/**
+ * @brief Initializes the DMA driver.
+ * 
+ * Resets the channels of DMA_CHANNEL_MASK, enables them and registers their
+ * interrupts.
+ */
+extern void dma_init(void);
+
+/**
+ * @brief Converts an ARM address into the bus address seen by the DMA engine.
+ * 
+ * @param addr ARM physical address (RAM or peripheral).
+ * @return     Bus address.
+ */
+extern uint32_t dma_bus_addr(const volatile void *addr);
+
+/**
+ * @brief Allocates a DMA channel.
+ * 
+ * @return The channel number, or DMA_EBUSY if none is free.
+ */
+extern int dma_channel_alloc(void);
+
+/**
+ * @brief Releases a channel from dma_channel_alloc().
+ * 
+ * @param channel The channel; must not be running.
+ */
+extern void dma_channel_free(int channel);
+
+/**
+ * @brief Starts a control-block chain on a channel.
+ * 
+ * The control blocks are cleaned from the data cache first; the data buffers are
+ * the caller's responsibility (dcache_clean_range() before, dcache_invalidate_range()
+ * after). The last block should set DMA_TI_INTEN: the callback runs from its
+ * interrupt.
+ * 
+ * @param channel  An allocated channel.
+ * @param cb       First control block of the chain.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL, or DMA_EBUSY if the channel is running.
+ */
+extern int dma_start(int channel, struct dma_cb *cb, dma_callback_t callback, void *arg);
+
+/**
+ * @brief Waits for the transfer of a channel to complete.
+ * 
+ * Sleeps until the completion interrupt (a task yields the CPU meanwhile); polls the
+ * channel in IRQ context.
+ * 
+ * @param channel The channel.
+ * @return        DMA_OK or DMA_EBUS.
+ */
+extern int dma_wait(int channel);
+
+/**
+ * @brief Copies memory with the DMA engine.
+ * 
+ * Worth it for large buffers: the cache maintenance and the setup cost about as
+ * much as a CPU copy of a few hundred bytes.
+ * 
+ * @param dst Destination.
+ * @param src Source.
+ * @param n   Number of bytes.
+ * 
+ * @return DMA_OK, DMA_EBUSY if no channel is free, or DMA_EBUS.
+ */
+extern int dma_memcpy(void *dst, const void *src, uint32_t n);
+
+/**
+ * @brief Fills memory with the DMA engine.
+ * 
+ * @param dst   Destination.
+ * @param value Byte value to store.
+ * @param n     Number of bytes.
+ * 
+ * @return DMA_OK, DMA_EBUSY if no channel is free, or DMA_EBUS.
+ */
+extern int dma_memset(void *dst, uint8_t value, uint32_t n);
+
+/**
+ * @brief Writes a buffer to a peripheral FIFO, paced by its DREQ.
+ * 
+ * Starts the transfer and returns: the CPU is not involved until the completion
+ * callback. Every FIFO access is a 32-bit word, so the buffer holds one FIFO entry
+ * per word (for the PL011, one character in the low byte of each word).
+ * 
+ * @param channel  An allocated channel.
+ * @param fifo     ARM address of the FIFO register.
+ * @param src      Data to write, kept untouched until completion.
+ * @param n        Number of bytes, a multiple of 4.
+ * @param dreq     DMA_DREQ_* of the peripheral.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL or DMA_EBUSY.
+ */
+extern int dma_fifo_write(int channel, volatile uint32_t *fifo, const void *src, uint32_t n,
+                          uint8_t dreq, dma_callback_t callback, void *arg);
+
+/**
+ * @brief Reads a peripheral FIFO into a buffer, paced by its DREQ.
+ * 
+ * The buffer is invalidated from the data cache when the transfer completes,
+ * before the callback runs. It receives one FIFO entry per 32-bit word.
+ * 
+ * @param channel  An allocated channel.
+ * @param fifo     ARM address of the FIFO register.
+ * @param dst      Destination buffer.
+ * @param n        Number of bytes, a multiple of 4.
+ * @param dreq     DMA_DREQ_* of the peripheral.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL or DMA_EBUSY.
+ */
+extern int dma_fifo_read(int channel, volatile uint32_t *fifo, void *dst, uint32_t n,
+                         uint8_t dreq, dma_callback_t callback, void *arg);
+
+/**
+ * @brief DMA interrupt handler: completes the transfers of the signalling channels.
+ */
+extern void handle_dma_irq(void);
+
+#endif /* _DMA_H_ */
@@ -17,12 +17,22 @@
  * 
  * ## S_FRAME_SIZE:
  * - The macro `S_FRAME_SIZE` defines the size of the exception frame, which is used 
- *   during the context saving/restoring process when an exception occurs.
+ *   during the context saving/restoring process when an exception occurs. The frame 
+ *   holds x0-x30, ELR_EL1 and SPSR_EL1. It is used by the synchronous and error paths.
+ * 
+ * ## IRQ_FRAME_SIZE:
+ * - IRQs save only the caller-saved registers (x0-x18, x30), ELR_EL1 and SPSR_EL1:
+ *   handle_irq preserves x19-x29 itself (AAPCS64). The frame stays on the interrupted
+ *   stack and the handler runs on the per-core IRQ stack (see mm.h).
+ * - FPU builds extend it with the lazy FP/SIMD state (see fpsimd.h): the CPACR_EL1
+ *   of the interrupted code, the enclosing IRQ frame, and room for q0-q31, FPSR and
+ *   FPCR, filled only if the handler touches the FP/SIMD registers.
  */
 
 #ifndef _ENTRY_H_
 #define _ENTRY_H_
 
+#include "fpsimd.h"
 
 // Exception vector definitions for invalid exceptions
 #define VECTOR_INVALID_SYN_EL1_SP_EL0       0    // Synchronous exception at EL1, SP at EL0
@@ -43,6 +53,40 @@
 #define VECTOR_INVALID_SER_EL0_AARCH32      15   // SError exception at EL0, AArch32 mode
 
 // Size of the exception frame used for context saving/restoring
-#define S_FRAME_SIZE			256    // Size of exception frame in bytes
+#define S_FRAME_SIZE			272    // Size of exception frame in bytes (x0-x30, ELR_EL1, SPSR_EL1, 16-byte aligned)
+
+// Size of the FIQ fast path frame (caller-saved registers only)
+#define FIQ_FRAME_SIZE			160    // Size of FIQ frame in bytes (x0-x18, x30)
+
+// Size of the IRQ frame (caller-saved registers and the exception return state)
+#if FPU
+// Lazy FP/SIMD state of the IRQ frame (offsets from the frame base)
+#define IRQ_FRAME_FP_LINK		176    // Enclosing IRQ frame (TPIDRRO_EL0) and interrupted CPACR_EL1
+#define IRQ_FRAME_FP_SAVED		192    // Non-zero once q0-q31, FPSR and FPCR are saved
+#define IRQ_FRAME_FP_REGS		208    // q0-q31 (512 bytes)
+#define IRQ_FRAME_FP_CTRL		720    // FPSR and FPCR
+
+#define IRQ_FRAME_SIZE			736    // Size of IRQ frame in bytes (x0-x18, x30, ELR_EL1, SPSR_EL1, FP/SIMD state)
+#else
+#define IRQ_FRAME_SIZE			176    // Size of IRQ frame in bytes (x0-x18, x30, ELR_EL1, SPSR_EL1)
+#endif
+
+#ifndef __ASSEMBLER__
+
+/**
+ * @brief       Save and restore a full exception frame (x0-x30, ELR_EL1, SPSR_EL1).
+ * @description Runs the kernel_exception_enter/exit sequences without taking an
+ *              exception, to measure their cost (e.g. with CNTPCT_EL0 or the PMU).
+ */
+extern void exception_frame_probe_full(void);
+
+/**
+ * @brief       Save and restore an IRQ frame, including the IRQ stack switch.
+ * @description Runs the irq_entry/irq_exit sequences without taking an exception,
+ *              to compare their cost with exception_frame_probe_full().
+ */
+extern void exception_frame_probe_irq(void);
+
+#endif
 
 #endif  /* _ENTRY_H_ */
@@ -0,0 +1,138 @@
+/**
+ * @file        format.h
+ * @brief       Integer, hexadecimal and fixed-point formatting core.
+ * @description This header declares the conversion kernels and the printf-style
+ *              engine shared by uart_printf(), the deferred log and the LCD text
+ *              helpers. Decimal conversion emits two digits per step (one multiply by
+ *              a reciprocal instead of one divide per digit), hexadecimal conversion
+ *              uses shifts and masks on unsigned values, and `%f` is fixed-point, so
+ *              no FP/SIMD register is ever touched (the kernel is built with
+ *              -mgeneral-regs-only).
+ * 
+ * Supported conversions: `%c %d %i %u %x %X %s %p %f %%`, with the flags `-` (left
+ * align) and `0` (zero padding), a field width, a precision, and the length
+ * modifiers `l`, `ll` and `z` (64-bit argument; `h`/`hh` are accepted and ignored).
+ * 
+ * Fixed-point `%f`: the argument is a signed integer holding the value multiplied
+ * by 10^precision, e.g. `%.1f` with 235 prints `23.5` and `%.2f` with -5 prints
+ * `-0.05`. Without a precision the integer is printed as is.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _FORMAT_H_
+#define _FORMAT_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+// Maximum number of characters produced by format_udec() (2^64 - 1)
+#define FORMAT_DEC_MAX          20
+
+// Maximum number of characters produced by format_hex() (64 bits)
+#define FORMAT_HEX_MAX          16
+
+// Maximum precision of the fixed-point conversion
+#define FORMAT_FIXED_MAX_PREC   18
+
+// Maximum number of characters produced by format_fixed() (sign, digits, point)
+#define FORMAT_FIXED_MAX        (FORMAT_DEC_MAX + 3)
+
+/**
+ * @brief Output callback of the formatting engine.
+ * 
+ * @param ctx Caller context.
+ * @param s   Characters to output (not NUL-terminated).
+ * @param len Number of characters.
+ */
+typedef void (*format_out_t)(void *ctx, const char *s, uint32_t len);
+
+/**
+ * @brief Writes the decimal representation of an unsigned value.
+ * 
+ * @param buf   Destination, at least FORMAT_DEC_MAX characters (not NUL-terminated).
+ * @param value Value to convert.
+ * 
+ * @return The number of characters written.
+ */
+extern uint32_t format_udec(char *buf, uint64_t value);
+
+/**
+ * @brief Writes the hexadecimal representation of an unsigned value.
+ * 
+ * @param buf       Destination, at least FORMAT_HEX_MAX characters (not NUL-terminated).
+ * @param value     Value to convert.
+ * @param uppercase Non-zero for `A-F`, zero for `a-f`.
+ * 
+ * @return The number of characters written.
+ */
+extern uint32_t format_hex(char *buf, uint64_t value, uint8_t uppercase);
+
+/**
+ * @brief Writes a fixed-point value.
+ * 
+ * @param buf       Destination, at least FORMAT_FIXED_MAX characters (not NUL-terminated).
+ * @param value     Value multiplied by 10^precision.
+ * @param precision Number of fractional digits (capped to FORMAT_FIXED_MAX_PREC).
+ * 
+ * @return The number of characters written.
+ */
+extern uint32_t format_fixed(char *buf, int64_t value, uint32_t precision);
+
+/**
+ * @brief Formats a string with a variable argument list.
+ * 
+ * @param out    Output callback.
+ * @param ctx    Context passed to the callback.
+ * @param format Format string.
+ * @param ap     Arguments.
+ * 
+ * @return The number of characters produced.
+ */
+extern uint32_t format_vformat(format_out_t out, void *ctx, const char *format, va_list ap);
+
+/**
+ * @brief Formats a string with raw 64-bit arguments.
+ * 
+ * Each argument is converted back to the type expected by its conversion
+ * (the replay path of the deferred log). Missing arguments read as 0.
+ * 
+ * @param out    Output callback.
+ * @param ctx    Context passed to the callback.
+ * @param format Format string.
+ * @param args   Raw arguments.
+ * @param nargs  Number of raw arguments.
+ * 
+ * @return The number of characters produced.
+ */
+extern uint32_t format_rawformat(format_out_t out, void *ctx, const char *format, const uint64_t *args, uint32_t nargs);
+
+/**
+ * @brief Formats a string into a buffer.
+ * 
+ * The output is truncated to `size - 1` characters and always NUL-terminated
+ * (when `size` is not 0).
+ * 
+ * @param buf    Destination buffer.
+ * @param size   Size of the buffer.
+ * @param format Format string.
+ * @param ap     Arguments.
+ * 
+ * @return The length of the untruncated output.
+ */
+extern uint32_t format_vsnprintf(char *buf, uint32_t size, const char *format, va_list ap);
+
+/**
+ * @brief Formats a string into a buffer (variadic form of format_vsnprintf).
+ * 
+ * @param buf    Destination buffer.
+ * @param size   Size of the buffer.
+ * @param format Format string.
+ * @param ...    Arguments.
+ * 
+ * @return The length of the untruncated output.
+ */
+extern uint32_t format_snprintf(char *buf, uint32_t size, const char *format, ...);
+
+#endif /* _FORMAT_H_ */
@@ -0,0 +1,96 @@
+/**
+ * @file        fpsimd.h
+ * @brief       Opt-in FP/SIMD support and NEON kernels.
+ * @description The kernel is normally built with -mgeneral-regs-only: the compiler
+ *              never touches the FP/SIMD registers, so exception entry does not save
+ *              them. Building with FPU=1 (make FPU=1) lets C code use float, double
+ *              and the NEON kernels below.
+ * 
+ *              FP/SIMD state is then saved lazily. irq_entry records CPACR_EL1 in the
+ *              IRQ frame and traps FP/SIMD (CPACR_EL1.FPEN); the first FP/SIMD
+ *              instruction of the handler is trapped, q0-q31, FPSR and FPCR are saved
+ *              in the IRQ frame and FP/SIMD is enabled again. irq_exit restores them
+ *              only if they were saved. Handlers that do not use FP/SIMD pay for two
+ *              CPACR_EL1 writes and nothing else.
+ *              The current IRQ frame of a core is kept in TPIDRRO_EL0 (0 outside of
+ *              IRQ handlers).
+ * 
+ *              The FIQ fast path does not take part: the FIQ handler must be built
+ *              with FPSIMD_GENERAL_REGS_ONLY.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _FPSIMD_H_
+#define _FPSIMD_H_
+
+// FP/SIMD support: off (0, -mgeneral-regs-only) or on (1), see the Makefile
+#ifndef FPU
+#define FPU                     0
+#endif
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+// Functions that must not touch the FP/SIMD registers in FPU builds (FIQ handler)
+#if FPU
+#define FPSIMD_GENERAL_REGS_ONLY    __attribute__((target("general-regs-only")))
+#else
+#define FPSIMD_GENERAL_REGS_ONLY
+#endif
+
+#if FPU
+
+/**
+ * @brief Copies memory in 64-byte blocks with NEON loads and stores.
+ * 
+ * @param dst Destination, 16-byte aligned.
+ * @param src Source, 16-byte aligned.
+ * @param n   Number of bytes, a multiple of 64.
+ */
+extern void neon_block_copy(void *dst, const void *src, uint64_t n);
+
+/**
+ * @brief Zeroes memory in 64-byte blocks with NEON stores.
+ * 
+ * For normal memory with the caches on, memset() (DC ZVA) is faster; this works
+ * on any memory type.
+ * 
+ * @param dst Destination, 16-byte aligned.
+ * @param n   Number of bytes, a multiple of 64.
+ */
+extern void neon_block_zero(void *dst, uint64_t n);
+
+/**
+ * @brief Minimum and maximum of the temperature and humidity of DHT22 samples.
+ * 
+ * Deinterleaves four samples per iteration (struct dht22_sample: 16 bytes, the
+ * temperature at offset 8 and the humidity at offset 10).
+ * 
+ * @param samples Samples (struct dht22_sample).
+ * @param count   Number of samples, at least 1.
+ * @param out     Temperature min and max (int16_t), then humidity min and max (uint16_t).
+ */
+extern void neon_sample_minmax(const void *samples, uint32_t count, uint16_t out[4]);
+
+/**
+ * @brief Saves q0-q31, FPSR and FPCR (task preemption, see sched.c).
+ * 
+ * @param state 528 bytes, 16-byte aligned.
+ */
+extern void fpsimd_save_state(uint64_t *state);
+
+/**
+ * @brief Restores the registers saved by fpsimd_save_state().
+ * 
+ * @param state The saved state.
+ */
+extern void fpsimd_restore_state(const uint64_t *state);
+
+#endif /* FPU */
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* _FPSIMD_H_ */
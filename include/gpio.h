@@ -117,6 +117,45 @@ struct GPIO_Registers {
 #define GPIO_PUD_OFF   0b00  // No pull-up/down: 00 (2-bit binary) - The pin is not connected to a pull-up or pull-down resistor.
 #define GPIO_PUD_DOWN  0b01  // Pull-down: 01 (2-bit binary) - The pin is connected to a pull-down resistor, keeping it low when not driven.
 #define GPIO_PUD_UP    0b10  // Pull-up: 10 (2-bit binary) - The pin is connected to a pull-up resistor, keeping it high when not driven.
+#define GPIO_PUD_KEEP  0xFF  // gpio_config_pins(): leave the pull-up/down of the pin as it is.
+
+// Pins per bank of the 32-bit registers (GPSET, GPCLR, GPLEV, GPPUDCLK, event detect)
+#define GPIO_BANK_PINS 32
+
+/**
+ * @brief Precomputed register positions of one pin.
+ * 
+ * Built at compile time by GPIO_PIN_DESC(), so that pin accesses on hot paths
+ * (bit-banging, edge capture) are one MMIO store or load with no division.
+ */
+struct gpio_pin {
+    uint8_t fsel;       // GPFSEL register index (pin / 10)
+    uint8_t shift;      // Bit of the 3-bit function field in GPFSEL (pin % 10 * 3)
+    uint8_t bank;       // Index in the 32-bit registers (pin / 32)
+    uint32_t mask;      // Bit of the pin in its bank (1 << pin % 32)
+};
+
+// Static initializer of a struct gpio_pin for a constant BCM pin number
+#define GPIO_PIN_DESC(pin) { \
+    .fsel = (pin) / 10, \
+    .shift = ((pin) % 10) * 3, \
+    .bank = (pin) / GPIO_BANK_PINS, \
+    .mask = 1U << ((pin) % GPIO_BANK_PINS), \
+}
+
+// Single-store output and single-load input through a pin descriptor
+#define gpio_pin_set(desc)      (GPIO->GPSET[(desc)->bank] = (desc)->mask)
+#define gpio_pin_clear(desc)    (GPIO->GPCLR[(desc)->bank] = (desc)->mask)
+#define gpio_pin_read(desc)     ((GPIO->GPLEV[(desc)->bank] & (desc)->mask) ? 1 : 0)
+
+/**
+ * @brief One entry of a pin configuration table (see gpio_config_pins).
+ */
+struct gpio_pin_config {
+    uint8_t pin;        // BCM pin number (0 to 53)
+    uint8_t function;   // GPIO_INPUT, GPIO_OUTPUT or GPIO_ALTn
+    uint8_t pud;        // GPIO_PUD_* or GPIO_PUD_KEEP
+};
 
 // GPIO Functions
 /**
@@ -181,6 +220,67 @@ extern uint8_t gpio_read_pin(uint8_t pin);
  * @param pin     The GPIO pin number (e.g., 0 to 53 on Raspberry Pi).
  * @param pud     The pull-up/down mode (e.g., 0 = none, 1 = pull-up, 2 = pull-down).
  */
-extern void gpio_pull_up_down(uint8_t pin, uint8_t pud); 
+extern void gpio_pull_up_down(uint8_t pin, uint8_t pud);
+
+/**
+ * @brief Sets the function of a pin through its descriptor.
+ * 
+ * One read-modify-write of the GPFSEL register of the pin, with no arithmetic on
+ * the pin number.
+ * 
+ * @param desc     Descriptor of the pin (GPIO_PIN_DESC).
+ * @param function The function to set the pin to (GPIO_INPUT, GPIO_OUTPUT, GPIO_ALTn).
+ */
+extern void gpio_pin_set_function(const struct gpio_pin *desc, uint8_t function);
+
+/**
+ * @brief Drives high every pin of a bank set in a mask, in one GPSET store.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * @param mask    One bit per pin of the bank.
+ */
+extern void gpio_set_mask(uint8_t bank, uint32_t mask);
+
+/**
+ * @brief Drives low every pin of a bank set in a mask, in one GPCLR store.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * @param mask    One bit per pin of the bank.
+ */
+extern void gpio_clear_mask(uint8_t bank, uint32_t mask);
+
+/**
+ * @brief Reads the levels of a whole bank in one GPLEV load.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * 
+ * @return        One bit per pin of the bank, set for a high level.
+ */
+extern uint32_t gpio_read_mask(uint8_t bank);
+
+/**
+ * @brief Configures the pull-up or pull-down resistor of many pins at once.
+ * 
+ * Runs the GPPUD/GPPUDCLK sequence (and its two waits) once for every pin of the
+ * mask, instead of once per pin.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * @param mask    One bit per pin of the bank.
+ * @param pud     The pull-up/down mode (GPIO_PUD_OFF, GPIO_PUD_DOWN or GPIO_PUD_UP).
+ */
+extern void gpio_pull_mask(uint8_t bank, uint32_t mask, uint8_t pud);
+
+/**
+ * @brief Applies a pin configuration table.
+ * 
+ * The functions are merged per GPFSEL register, which is written once however
+ * many of its pins the table holds, and the pins sharing a pull mode share one
+ * pull sequence: configuring the two pins of a UART or of the I2C bus costs one
+ * GPFSEL read-modify-write and one pull sequence.
+ * 
+ * @param table   Pins to configure.
+ * @param count   Entries in the table.
+ */
+extern void gpio_config_pins(const struct gpio_pin_config *table, uint32_t count);
 
 #endif /* _GPIO_H_ */
@@ -21,6 +21,25 @@
 
 #define I2C_SPEED 100000
 
+// Depth of the BSC FIFO (bytes)
+#define I2C_FIFO_DEPTH  16
+
+// Number of BSC controllers
+#define I2C_NR_CONTROLLERS  3
+
+// Bus speeds
+#define I2C_SPEED_STANDARD  100000  // Standard mode (e.g. PCF8574 LCD backpack)
+#define I2C_SPEED_FAST      400000  // Fast mode
+
+// Devices with their own bus speed, per controller (see i2c_set_device_speed)
+#define I2C_MAX_DEVICES     8
+
+// Consecutive transactions for one device before the scheduler goes back to FIFO order
+#define I2C_BATCH_MAX       8
+
+// Bounded wait for TA after the write phase of a combined transfer starts (STATUS reads)
+#define I2C_TA_SPIN_MAX     1000
+
 // I2C register structure definition
 struct I2C_Registers
 {
@@ -120,20 +139,119 @@ typedef enum {
 #define I2C_STAT_TA_Active      (1 << I2C_STAT_TA_Pos)   // Transfer active
 
 
+// Transaction status codes (also returned by i2c_write/i2c_read)
+#define I2C_OK          0       // Transfer completed
+#define I2C_EINVAL      (-1)    // Invalid controller, length or buffer
+#define I2C_ENACK       (-2)    // ACK error (no device, or NACK)
+#define I2C_ECLKT       (-3)    // Clock stretch timeout
+#define I2C_ETIMEOUT    (-4)    // Write phase of a combined transfer not seen active (read not started)
+#define I2C_PENDING     1       // Queued or in progress
+
+// Transaction flags
+#define I2C_TXN_WRITE       0   // Write `length` bytes from `buffer`
+#define I2C_TXN_READ        1   // Read `length` bytes into `buffer`
+#define I2C_TXN_WRITE_READ  2   // Write `length` (<= I2C_FIFO_DEPTH) bytes, repeated start,
+                                // then read `rx_length` bytes into `rx_buffer`
+
+// Transaction priorities: a lower value is scheduled first
+#define I2C_PRIO_HIGH       0
+#define I2C_PRIO_NORMAL     1
+#define I2C_PRIO_LOW        2
+#define I2C_NR_PRIO         3
+
+struct i2c_txn;
+
+/**
+ * @brief Completion callback of an I2C transaction.
+ * 
+ * Runs in IRQ context (the BSC interrupt) once `txn->status` is final, or in the
+ * context that polls the bus (see i2c_write()). It may submit a new transaction.
+ * 
+ * @param txn The completed transaction.
+ */
+typedef void (*i2c_callback_t)(struct i2c_txn *txn);
+
+/**
+ * @brief An I2C transaction, owned by the caller until it completes.
+ */
+struct i2c_txn {
+    uint8_t slave_addr;             // 7-bit slave address
+    uint8_t flags;                  // I2C_TXN_WRITE, I2C_TXN_READ or I2C_TXN_WRITE_READ
+    uint8_t priority;               // I2C_PRIO_HIGH, I2C_PRIO_NORMAL or I2C_PRIO_LOW
+    uint8_t *buffer;                // Data to send, or storage for the received data
+    uint32_t length;                // Number of bytes (1 to 65535)
+    uint8_t *rx_buffer;             // Storage for the received data (I2C_TXN_WRITE_READ)
+    uint32_t rx_length;             // Number of bytes to read (I2C_TXN_WRITE_READ)
+    void *arg;                      // Free for the caller (e.g. the callback context)
+    volatile int status;            // I2C_PENDING, then I2C_OK or an error code
+    i2c_callback_t callback;        // Set by i2c_submit()
+    struct i2c_txn *next;           // Queue link, used by the driver
+};
+
 /**
  * @brief Initializes the specified I2C controller.
  * 
  * Configures the I2C peripheral with a clock divider to set the communication speed.
  * 
  * @param index      The I2C controller index (I2C_CONTROLLER_0, I2C_CONTROLLER_1, I2C_CONTROLLER_2).
- * @param clock_div  The clock divider value to configure the I2C speed.
+ * @param clock_div  The clock divider value to configure the I2C speed (see
+ *                   i2c_speed_to_div); its SCL frequency is kept across core clock changes.
  */
 extern void i2c_init(I2C_Controller_Index index, uint16_t clock_div);
 
+/**
+ * @brief Sets the bus speed used for one device.
+ * 
+ * The divider is computed from the VPU core clock (clock_get_core_hz), recomputed
+ * when clock_set_core_hz() changes it, and written to DIV between two transfers,
+ * when the scheduler switches to that device. Other devices use the divider given
+ * to i2c_init().
+ * 
+ * @param index       The I2C controller index, initialized with i2c_init().
+ * @param slave_addr  The address of the I2C slave device.
+ * @param speed_hz    SCL frequency (e.g. I2C_SPEED_STANDARD, I2C_SPEED_FAST).
+ * @return int        I2C_OK, or I2C_EINVAL if the table is full or the speed is 0.
+ */
+extern int i2c_set_device_speed(I2C_Controller_Index index, uint8_t slave_addr, uint32_t speed_hz);
+
+/**
+ * @brief Returns the divider of an SCL frequency at the current core clock.
+ * 
+ * For i2c_init(): the controller keeps that frequency when the core clock changes.
+ * 
+ * @param speed_hz SCL frequency in Hz (e.g. I2C_SPEED_STANDARD).
+ * @return         DIV value, rounded up to an even value (never faster than asked),
+ *                 0 if the speed is 0.
+ */
+extern uint16_t i2c_speed_to_div(uint32_t speed_hz);
+
+/**
+ * @brief Queues an I2C transaction.
+ * 
+ * Returns immediately: the transfer is driven by the BSC interrupt (INTD, and INTT
+ * or INTR to refill or drain the FIFO). The controller's scheduler picks the most
+ * urgent priority first; within a priority, queued transactions for the device just
+ * served are batched (up to I2C_BATCH_MAX) before the others, in FIFO order.
+ * Safe to call from any core and from IRQ context.
+ * 
+ * @param index     The I2C controller index, initialized with i2c_init().
+ * @param txn       The transaction; must stay valid until its callback has run.
+ * @param callback  Function called on completion, or NULL.
+ * @return int      I2C_OK if the transaction was queued, I2C_EINVAL otherwise.
+ */
+extern int i2c_submit(I2C_Controller_Index index, struct i2c_txn *txn, i2c_callback_t callback);
+
+/**
+ * @brief BSC interrupt handler: services the active transaction of every controller.
+ */
+extern void handle_i2c_irq(void);
+
 /**
  * @brief Writes data to an I2C slave device.
  * 
  * Sends a buffer of data to the specified I2C slave device using the I2C controller.
+ * The call submits a transaction and sleeps until it completes; in IRQ context or
+ * with IRQs masked, it polls the controller instead.
  * 
  * @param index       The I2C controller index (I2C_CONTROLLER_0, I2C_CONTROLLER_1, I2C_CONTROLLER_2).
  * @param slave_addr  The address of the I2C slave device.
@@ -148,6 +266,7 @@ extern int i2c_write(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *da
  * @brief Reads data from an I2C slave device.
  * 
  * Reads a buffer of data from the specified I2C slave device using the I2C controller.
+ * Blocks like i2c_write().
  * 
  * @param index       The I2C controller index (I2C_CONTROLLER_0, I2C_CONTROLLER_1, I2C_CONTROLLER_2).
  * @param slave_addr  The address of the I2C slave device.
@@ -158,4 +277,23 @@ extern int i2c_write(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *da
  */
 extern int i2c_read(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *buffer, uint32_t length);
 
+/**
+ * @brief Writes then reads an I2C slave device with a repeated start.
+ * 
+ * Typically a register address followed by its value: one transaction and no STOP
+ * in between, so no other access can come between the two phases. Blocks like
+ * i2c_write().
+ * 
+ * @param index       The I2C controller index.
+ * @param slave_addr  The address of the I2C slave device.
+ * @param data        Data to send (e.g. the register address).
+ * @param length      Number of bytes to send (1 to I2C_FIFO_DEPTH).
+ * @param buffer      Pointer to the buffer where the received data will be stored.
+ * @param rx_length   Number of bytes to read.
+ * @return int        Returns 0 on success, -1 for invalid input, -2 for ACK errors,
+ *                    -3 for clock stretch timeouts and -4 if the read phase could not
+ *                    be chained (I2C_ETIMEOUT).
+ */
+extern int i2c_write_read(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *data, uint32_t length, uint8_t *buffer, uint32_t rx_length);
+
 #endif // I2C_H
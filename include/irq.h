@@ -19,9 +19,6 @@
 // Base address for the ARM interrupt registers.
 #define IRQ_BASE_ADDR   (PIBASE + 0xB200)
 
-#define BIT_0(x)                    (0 << x)  // Set bit to 0 at position x
-#define BIT_1(x)                    (1 << x)  // Set bit to 1 at position x
-
 /**
  * @brief Structure representing the ARM interrupt registers.
  */
@@ -56,6 +53,79 @@ struct IRQ_Registers{
 // Bit 29 corresponds to AUX IRQ
 #define AUX_IRQ         BIT_1(29)
 
+// IRQ numbers used by irq_register():
+// 0-63 GPU sources (IRQPending1/2), 64-71 ARM basic sources (IRQBasicPending bits 0-7),
+// 72-83 ARM local sources of the calling core (local IRQ source bits 0-11)
+#define IRQ_GPU(n)          (n)
+#define IRQ_BASIC(n)        (64 + (n))
+#define IRQ_LOCAL(n)        (72 + (n))
+#define NR_IRQS             IRQ_LOCAL(12)
+
+#define IRQ_SYSTEM_TIMER_1  IRQ_GPU(1)      // System Timer compare 1
+#define IRQ_SYSTEM_TIMER_3  IRQ_GPU(3)      // System Timer compare 3
+#define IRQ_DMA(n)          IRQ_GPU(16 + (n)) // DMA channel n (0-10; 11-14 share IRQ_GPU(27))
+#define IRQ_AUX             IRQ_GPU(29)     // Mini UART and SPI1/2
+#define IRQ_GPIO_BANK0      IRQ_GPU(49)     // gpio_int[0]: events of GPIO 0-27
+#define IRQ_I2C             IRQ_GPU(53)     // i2c_int: BSC controllers
+#define IRQ_PL011           IRQ_GPU(57)     // uart_int: PL011
+#define IRQ_LOCAL_CNTPNS    IRQ_LOCAL(1)    // Non-secure physical timer of the core
+
+// IRQBasicPending: bits 8 and 9 flag pending registers 1 and 2, bits 10-20 are
+// shortcuts to frequently used GPU sources
+#define IRQ_BASIC_ARM_MASK      0xFF
+#define IRQ_BASIC_PENDING1      BIT_1(8)
+#define IRQ_BASIC_PENDING2      BIT_1(9)
+#define IRQ_BASIC_SHORTCUT_SHIFT 10
+#define IRQ_BASIC_SHORTCUTS     11
+
+// Local IRQ source bits that are dispatchable sources (bit 8 only flags a GPU interrupt)
+#define IRQ_LOCAL_SOURCE_MASK   0xEFF
+
+// Local sources a core can mask in its own control registers: the core timers
+// (bits 0-3, TIMER_IRQ_CTRL) and the mailboxes (bits 4-7, MAILBOX_IRQ_CTRL)
+#define IRQ_LOCAL_MASKABLE      0xFF
+#define IRQ_LOCAL_TIMER_BITS    0x0F
+#define IRQ_LOCAL_MAILBOX_BITS  0xF0
+#define IRQ_LOCAL_MAILBOX_SHIFT 4
+
+// Priorities: a lower value is more urgent
+#define IRQ_PRIO_HIGHEST    0               // Never nested over (e.g. per-core timer tick)
+#define IRQ_PRIO_HIGH       1               // e.g. UART
+#define IRQ_PRIO_NORMAL     2
+#define IRQ_PRIO_LOW        3               // Long handlers
+#define NR_IRQ_PRIO         4
+
+// Source routed to the FIQ fast path (FIQControl numbering: 0-63 GPU, 64-71 ARM basic).
+// Default: GPIO bank 0 edge interrupt (gpio_int[0], DHT22 data line).
+// Use IRQ_SYSTEM_TIMER_3 for a System Timer compare instead.
+#ifndef IRQ_FIQ_SOURCE
+#define IRQ_FIQ_SOURCE      IRQ_GPIO_BANK0
+#endif
+
+// FIQControl: source select in bits 0-6, FIQ enable in bit 7
+#define FIQ_CONTROL_SOURCE_MASK     0x7F
+#define FIQ_CONTROL_ENABLE          BIT_1(7)
+
+// Nested interrupts: 1 lets a more urgent source preempt a running handler
+#ifndef IRQ_NESTING
+#define IRQ_NESTING         1
+#endif
+
+/**
+ * @brief IRQ handler type.
+ */
+typedef void (*irq_handler_t)(void);
+
+/**
+ * @brief Statistics of one IRQ source, in generic counter ticks (CNTFRQ_EL0).
+ */
+struct irq_stats {
+    uint32_t count;                 // Number of times the handler ran
+    uint64_t total_ticks;           // Time spent in the handler
+    uint64_t max_ticks;             // Longest run of the handler
+    uint64_t max_latency;           // Longest delay between IRQ entry and the handler start
+};
+
 /**
  * @brief       Initialize the IRQ vector table.
  * @description Sets the Vector Base Address Register (VBAR_EL1) to point to 
@@ -79,6 +149,43 @@ extern void irq_enable(void);
  */
 extern void irq_disable(void);
 
+/**
+ * @brief       Enable FIQs at EL1.
+ * @description Clears the FIQ disable bit in the DAIF register. IRQ handlers also run
+ *              with FIQs enabled (see entry.S), so the FIQ source preempts them.
+ */
+extern void fiq_enable(void);
+
+/**
+ * @brief       Disable FIQs at EL1.
+ * @description Sets the FIQ disable bit in the DAIF register.
+ */
+extern void fiq_disable(void);
+
+/**
+ * @brief       Tell whether IRQs are masked at EL1.
+ * 
+ * @return      1 if the IRQ disable bit is set in DAIF, 0 otherwise.
+ */
+extern uint32_t irq_masked(void);
+
+/**
+ * @brief       Save the interrupt mask state and disable IRQs at EL1.
+ * @description Returns the current DAIF value and sets the IRQ disable bit, so that
+ *              a critical section can be nested inside code that already runs with
+ *              IRQs masked.
+ * 
+ * @return      The previous DAIF value, to be passed to irq_restore().
+ */
+extern uint64_t irq_save(void);
+
+/**
+ * @brief       Restore the interrupt mask state saved by irq_save().
+ * 
+ * @param flags The DAIF value returned by irq_save().
+ */
+extern void irq_restore(uint64_t flags);
+
 /**
  * @brief       Show an invalid entry message.
  * @description Prints a detailed error message when an invalid exception vector
@@ -91,16 +198,93 @@ extern void irq_disable(void);
 extern void show_invalid_entry_message(uint32_t type, uint64_t esr, uint64_t address);
 
 /**
- * @brief       Enable the interrupt controller for auxiliary devices.
- * @description This function configures the interrupt controller to enable
- *              interrupts for auxiliary devices, such as Mini UART.
+ * @brief       Reset the interrupt controller.
+ * @description This function masks every GPU and ARM basic source. Drivers enable
+ *              their own sources with irq_register().
  */
 extern void enable_interrupt_controller(void);
 
+/**
+ * @brief       Register the handler of an IRQ source.
+ * @description Installs the handler and its priority, then enables the source in the
+ *              interrupt controller (GPU and basic sources). Local sources are enabled
+ *              by their driver in the local peripheral block of each core. The local
+ *              sources the cores cannot mask (PMU, AXI, local timer) must be registered
+ *              at IRQ_PRIO_HIGHEST.
+ * 
+ * @param irq_no    IRQ number (IRQ_GPU(n), IRQ_BASIC(n) or IRQ_LOCAL(n)).
+ * @param handler   Handler, called with IRQs masked unless nesting applies.
+ * @param priority  IRQ_PRIO_HIGHEST to IRQ_PRIO_LOW.
+ * 
+ * @return      0 on success, -1 if the IRQ number or the priority is invalid.
+ */
+extern int irq_register(uint32_t irq_no, irq_handler_t handler, uint8_t priority);
+
+/**
+ * @brief       Route IRQ_FIQ_SOURCE to the FIQ fast path.
+ * @description The source is removed from the IRQ dispatcher and selected in
+ *              FIQControl. Its handler is called from a minimal-save entry (caller-saved
+ *              registers only) with IRQs and FIQs masked, and must be short: clear the
+ *              source, record what is needed (e.g. a timestamp) and defer the rest.
+ *              FP/SIMD state is not saved: FPU builds must declare the handler
+ *              FPSIMD_GENERAL_REGS_ONLY (fpsimd.h).
+ *              Call fiq_enable() afterwards to unmask FIQs on the calling core.
+ * 
+ * @param handler   FIQ handler.
+ */
+extern void fiq_register(irq_handler_t handler);
+
+/**
+ * @brief       Stop the FIQ fast path.
+ * @description Clears FIQControl; the source stays disabled until it is registered
+ *              again with irq_register() or fiq_register().
+ */
+extern void fiq_release(void);
+
+/**
+ * @brief       Tell whether the calling core cannot wait for an interrupt.
+ * @description True inside an IRQ handler (including a nested one running with IRQs
+ *              enabled) and whenever IRQs are masked. Code that blocks until a timer
+ *              or device interrupt must not run in that state.
+ * 
+ * @return      1 in interrupt context or with IRQs masked, 0 otherwise.
+ */
+extern uint8_t irq_in_handler(void);
+
+/**
+ * @brief       Read the entry time of the last IRQ taken by the calling core.
+ * @description Sampled by the first statement of handle_irq(); a handler compares it
+ *              with the time its source fired to get the IRQ entry latency.
+ * 
+ * @return      CNTPCT_EL0 at the start of the last handle_irq() on this core.
+ */
+extern uint64_t irq_entry_time(void);
+
+/**
+ * @brief       Read the statistics of an IRQ source, summed over the cores.
+ * @description Each core accounts the runs it dispatched in its own copy; counts and
+ *              times are added, the maxima are the largest of the cores.
+ * 
+ * @param irq_no     IRQ number.
+ * @param[out] stats Statistics of the source.
+ * 
+ * @return      0, or -1 if the IRQ number is invalid.
+ */
+extern int irq_get_stats(uint32_t irq_no, struct irq_stats *stats);
+
+/**
+ * @brief       Print the statistics of the registered IRQ sources over UART.
+ */
+extern void irq_dump_stats(void);
+
 /**
  * @brief       Handle pending IRQs.
- * @description This function processes pending interrupts and handles auxiliary
- *              device IRQs, such as UART data reception.
+ * @description This function dispatches the pending sources of the calling core in
+ *              priority order through the table filled by irq_register(). With
+ *              IRQ_NESTING, a GPU or basic handler below IRQ_PRIO_HIGHEST runs with IRQs
+ *              enabled and the sources of its priority and below masked: GPU and basic
+ *              sources in the controller, core timers and mailboxes in the local control
+ *              registers of the core.
  */
 extern void handle_irq(void);
 
@@ -0,0 +1,100 @@
+/**
+ * @file        klog.h
+ * @brief       Deferred binary kernel log.
+ * @description This header declares the `klog()` logging call. In deferred mode
+ *              (KLOG_DEFERRED=1, the default) a call only stores a timestamp, the
+ *              format pointer and up to KLOG_MAX_ARGS raw 64-bit arguments in a ring
+ *              owned by the calling core; klog_drain() formats the records later
+ *              through uart_printf_args(). Logging from IRQ context therefore costs a
+ *              few stores instead of the whole UART conversion.
+ *              With KLOG_DEFERRED=0, klog() is a plain uart_printf() call.
+ * 
+ * @note        The format string must stay valid until the record is drained (string
+ *              literals), and so must the strings passed to `%s`. `%f` takes a
+ *              fixed-point integer (see format.h), like every other conversion.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _KLOG_H_
+#define _KLOG_H_
+
+#include <stdint.h>
+#include "uart_printf.h"
+
+// Deferred mode by default, the Makefile may override it (make KLOG_DEFERRED=0)
+#ifndef KLOG_DEFERRED
+#define KLOG_DEFERRED       1
+#endif
+
+// Maximum number of arguments of a log record
+#define KLOG_MAX_ARGS       6
+
+// Number of records per core (power of two)
+#define KLOG_RING_SIZE      64
+
+/**
+ * @brief A deferred log record.
+ */
+struct klog_record {
+    uint64_t timestamp;                 // timer_get_ticks() at the call
+    const char *format;                 // Format string (not copied)
+    uint32_t nargs;                     // Number of valid entries in args
+    uint64_t args[KLOG_MAX_ARGS];       // Raw arguments
+};
+
+/**
+ * @brief Stores a log record in the ring of the calling core.
+ * 
+ * The record is dropped (and counted) when the ring is full.
+ * Use the klog() macro rather than calling this function directly.
+ * 
+ * @param format Format string.
+ * @param nargs  Number of arguments (at most KLOG_MAX_ARGS).
+ * @param args   Raw arguments.
+ */
+extern void klog_write(const char *format, uint32_t nargs, const uint64_t *args);
+
+/**
+ * @brief Formats and prints the pending records of all cores.
+ * 
+ * Records are printed in timestamp order, each prefixed with its timestamp.
+ * Called from the idle loop of core 0; any core may call it, concurrent calls
+ * return immediately.
+ * 
+ * @return The number of records printed.
+ */
+extern uint32_t klog_drain(void);
+
+// Argument counting (0 to KLOG_MAX_ARGS arguments after the format)
+#define KLOG_NARGS(...)             KLOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define KLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, N, ...)   N
+
+// Conversion of each argument to a raw 64-bit value
+#define KLOG_RAW(a)                 ((uint64_t)(uintptr_t)(a))
+#define KLOG_ARGS_0()               0
+#define KLOG_ARGS_1(a)              KLOG_RAW(a)
+#define KLOG_ARGS_2(a, ...)         KLOG_RAW(a), KLOG_ARGS_1(__VA_ARGS__)
+#define KLOG_ARGS_3(a, ...)         KLOG_RAW(a), KLOG_ARGS_2(__VA_ARGS__)
+#define KLOG_ARGS_4(a, ...)         KLOG_RAW(a), KLOG_ARGS_3(__VA_ARGS__)
+#define KLOG_ARGS_5(a, ...)         KLOG_RAW(a), KLOG_ARGS_4(__VA_ARGS__)
+#define KLOG_ARGS_6(a, ...)         KLOG_RAW(a), KLOG_ARGS_5(__VA_ARGS__)
+#define KLOG_CAT(a, b)              KLOG_CAT_(a, b)
+#define KLOG_CAT_(a, b)             a##b
+#define KLOG_ARGS(n, ...)           KLOG_CAT(KLOG_ARGS_, n)(__VA_ARGS__)
+
+/**
+ * @brief Logs a message.
+ * 
+ * Same format specifiers as uart_printf(), with at most KLOG_MAX_ARGS arguments.
+ */
+#if KLOG_DEFERRED
+#define klog(format, ...) \
+    klog_write((format), KLOG_NARGS(__VA_ARGS__), \
+               (const uint64_t[]){ KLOG_ARGS(KLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__) })
+#else
+#define klog(format, ...)           uart_printf((format), ##__VA_ARGS__)
+#endif
+
+#endif /* _KLOG_H_ */
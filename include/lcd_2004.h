@@ -4,7 +4,7 @@
  * @description This header file defines the interface for the 20x4 character LCD module
  *              driver, including macros, data structures, and function prototypes for
  *              initializing and controlling the LCD module.
- *
+ * 
  * @version     1.0
  * @date        2024-12-19
  */
@@ -18,7 +18,18 @@
 #define SDA_PIN                     2 ///< Define the pin used for SDA (data line) in I2C communication, typically pin 2
 #define SCL_PIN                     3 ///< Define the pin used for SCL (clock line) in I2C communication, typically pin 3
 #define LCD_I2C_ADDRESS             0x27 ///< Define the default I2C address for the LCD module, commonly 0x27 for many LCD I2C modules
-#define LCD_I2C_DIVIDER             1500
+#define LCD_I2C_SPEED               100000 ///< SCL frequency of the PCF8574 backpack (100 kHz max)
+
+#define LCD_COLUMNS                 20 ///< Number of characters per row
+#define LCD_ROWS                    4 ///< Number of rows
+
+#define LCD_BYTES_PER_CHAR          6 ///< Expander writes per LCD byte (two nibbles, three writes each)
+#define LCD_BURST_CHARS             LCD_COLUMNS ///< LCD bytes per I2C transfer (one row)
+
+#define LCD_FLUSH_MAX_GAP           1 ///< Clean cells merged into a dirty run (cost of a cursor move)
+#define LCD_FLUSH_BURST_MAX         ((LCD_COLUMNS + LCD_COLUMNS / 2) * LCD_BYTES_PER_CHAR) ///< One row with its cursor moves
+#define LCD_REFRESH_MIN_US          20000 ///< Shortest refresh period (a full row takes about 11 ms at 100 kHz)
+#define LCD_POWER_UP_US             50000 ///< Power-up wait before the wake-up sequence
 
 // LCD Commands
 #define LCD_CMD_CLEAR_DISPLAY       0x01 ///< Clear display command
@@ -68,13 +79,26 @@
 // Function prototypes
 
 /**
- * @brief Initializes the 20x4 LCD module.
+ * @brief Starts the initialization of the 20x4 LCD module.
  * 
  * This function initializes the GPIO pins, configures the I2C interface,
- * and sets up the LCD module in 4-bit mode with the desired display settings.
+ * and starts setting up the LCD module in 4-bit mode with the desired display
+ * settings. It does not wait: the power-up and wake-up delays (about 60 ms) run
+ * from the software timers, and the commands as deferred work, overlapping the
+ * rest of the boot. The drawing functions can be used at once; the display
+ * shows their result at the first lcd_flush() after lcd_ready_time().
+ * Needs timer_init() first.
  */
 extern void lcd_init(void);
 
+/**
+ * @brief Returns the end time of the initialization.
+ * 
+ * @return The generic counter value (CNTPCT_EL0) when the init sequence ended,
+ *         0 while it is in progress.
+ */
+extern uint64_t lcd_ready_time(void);
+
 /**
  * @brief Controls the LCD backlight.
  * 
@@ -87,23 +111,23 @@ extern void lcd_backlight(uint8_t on);
 /**
  * @brief Clears the LCD display.
  * 
- * This function clears the display and resets the cursor to the home position.
+ * This function clears the shadow and resets the cursor to the home position.
+ * The next flush blanks only the cells that were not already blank.
  */
 extern void lcd_clear(void);
 
 /**
  * @brief Moves the cursor to the home position on the LCD.
  * 
- * This function sends the "Return Home" command to the LCD, which resets the
- * cursor to the top-left corner (position 0,0) of the display. It also resets 
- * any shifted display settings to their default state.
+ * This function resets the shadow cursor to the top-left corner (position 0,0)
+ * of the display.
  */
 extern void lcd_home(void);
 
 /**
  * @brief Sets the cursor position on the LCD.
  * 
- * This function moves the cursor to the specified column and row.
+ * This function moves the shadow cursor to the specified column and row.
  * 
  * @param col The column position (0-19).
  * @param row The row position (0-3).
@@ -113,11 +137,45 @@ extern void lcd_set_cursor(uint8_t col, uint8_t row);
 /**
  * @brief Prints a string to the LCD.
  * 
- * This function writes a null-terminated string to the LCD starting
- * from the current cursor position.
+ * This function writes a null-terminated string into the shadow starting
+ * from the current cursor position. Characters past the end of the row
+ * are dropped. Nothing is sent until the next lcd_flush().
  * 
  * @param str Pointer to the string to print.
  */
 extern void lcd_print(const char *str);
 
+/**
+ * @brief Sends the changed cells to the LCD.
+ * 
+ * Only the dirty runs of the shadow are sent, one I2C transfer per changed row.
+ * Must not be called from interrupt handlers: the transfers sleep.
+ * 
+ * @return Number of characters sent.
+ */
+extern uint32_t lcd_flush(void);
+
+/**
+ * @brief Starts the periodic refresh of the LCD.
+ * 
+ * The shadow is flushed (as deferred work) at most once per period, and only
+ * when it changed.
+ * 
+ * @param period_us Refresh period (µs), raised to LCD_REFRESH_MIN_US if shorter.
+ * 
+ * @return int 0, or -1 if no timer is available.
+ */
+extern int lcd_refresh_start(uint32_t period_us);
+
+/**
+ * @brief Prints a formatted string to the LCD.
+ * 
+ * This function formats the string like uart_printf (see format.h) and writes 
+ * it to the LCD from the current cursor position, truncated to one row.
+ * 
+ * @param format The format string.
+ * @param ...    The values to format.
+ */
+extern void lcd_printf(const char *format, ...);
+
 #endif /* _LCD_2004_H_ */
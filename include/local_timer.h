@@ -0,0 +1,164 @@
+/**
+ * @file        local_timer.h
+ * @brief       ARMv8 generic timer and ARM local peripheral interface.
+ * @description This header declares the driver for the per-core ARMv8 generic timer
+ *              (CNTPCT_EL0 / CNTP_TVAL_EL0 / CNTP_CTL_EL0) and the register map of the
+ *              ARM local peripheral block at LOCAL_PIBASE, which routes the timer
+ *              interrupts of each core. Reading the counter is one system-register
+ *              access, compared to two uncached MMIO reads for the System Timer.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _LOCAL_TIMER_H_
+#define _LOCAL_TIMER_H_
+
+#include <stdint.h>
+#include "base.h"
+
+/**
+ * @brief Structure representing the ARM local peripheral registers.
+ */
+struct LOCAL_Registers {
+    volatile uint32_t CONTROL;              // 0x00: Timer clock source and increment
+    volatile uint32_t reserved1;            // 0x04: Unused
+    volatile uint32_t PRESCALER;            // 0x08: Core timer prescaler
+    volatile uint32_t GPU_IRQ_ROUTING;      // 0x0C: GPU interrupt routing
+    volatile uint32_t PMU_IRQ_SET;          // 0x10: Performance monitor interrupt routing set
+    volatile uint32_t PMU_IRQ_CLEAR;        // 0x14: Performance monitor interrupt routing clear
+    volatile uint32_t reserved2;            // 0x18: Unused
+    volatile uint32_t CORE_TIMER_LS;        // 0x1C: Core timer access, lower 32 bits
+    volatile uint32_t CORE_TIMER_MS;        // 0x20: Core timer access, upper 32 bits
+    volatile uint32_t LOCAL_IRQ_ROUTING;    // 0x24: Local interrupt 0 routing
+    volatile uint32_t reserved3;            // 0x28: Unused
+    volatile uint32_t AXI_COUNTERS;         // 0x2C: AXI outstanding counters
+    volatile uint32_t AXI_IRQ;              // 0x30: AXI outstanding interrupt
+    volatile uint32_t LOCAL_TIMER_CTRL;     // 0x34: Local timer control and status
+    volatile uint32_t LOCAL_TIMER_FLAGS;    // 0x38: Local timer write flags
+    volatile uint32_t reserved4;            // 0x3C: Unused
+    volatile uint32_t TIMER_IRQ_CTRL[4];    // 0x40-0x4C: Core 0-3 timers interrupt control
+    volatile uint32_t MAILBOX_IRQ_CTRL[4];  // 0x50-0x5C: Core 0-3 mailboxes interrupt control
+    volatile uint32_t IRQ_SOURCE[4];        // 0x60-0x6C: Core 0-3 IRQ source
+    volatile uint32_t FIQ_SOURCE[4];        // 0x70-0x7C: Core 0-3 FIQ source
+};
+
+// Pointer to the ARM local peripheral registers
+#define LOCAL           ((struct LOCAL_Registers *)(LOCAL_PIBASE))
+
+// CONTROL: timer clocked by the 19.2MHz crystal, incremented by 1
+#define LOCAL_CONTROL_CRYSTAL       BIT_0(8)
+
+// PRESCALER: 2^31 gives a divide ratio of 1 (timer runs at the crystal frequency)
+#define LOCAL_PRESCALER_DIV1        0x80000000
+
+// TIMER_IRQ_CTRL / IRQ_SOURCE bits
+#define LOCAL_CNTPSIRQ              BIT_1(0)    // Secure physical timer
+#define LOCAL_CNTPNSIRQ             BIT_1(1)    // Non-secure physical timer (used at EL1)
+#define LOCAL_CNTHPIRQ              BIT_1(2)    // Hypervisor timer
+#define LOCAL_CNTVIRQ               BIT_1(3)    // Virtual timer
+
+// IRQ_SOURCE bits of the other sources
+#define LOCAL_IRQ_MAILBOX(n)        BIT_1(4 + (n))  // Mailbox n of the core
+#define LOCAL_IRQ_GPU               BIT_1(8)    // GPU interrupt (only one core receives it)
+#define LOCAL_IRQ_PMU               BIT_1(9)    // Performance monitor
+#define LOCAL_IRQ_AXI               BIT_1(10)   // AXI outstanding (core 0 only)
+#define LOCAL_IRQ_LOCAL_TIMER       BIT_1(11)   // Local timer
+
+// CNTP_CTL_EL0 bits
+#define CNTP_CTL_ENABLE             BIT_1(0)    // Timer enabled
+#define CNTP_CTL_IMASK              BIT_1(1)    // Interrupt masked
+#define CNTP_CTL_ISTATUS            BIT_1(2)    // Timer condition met
+
+// Period of the per-core tick in microseconds (100Hz)
+#define LOCAL_TIMER_TICK_US         10000
+
+/**
+ * @brief Reads the physical counter (CNTPCT_EL0).
+ * 
+ * @return The current counter value, in counter ticks.
+ */
+extern uint64_t local_timer_get_counter(void);
+
+/**
+ * @brief Reads the counter frequency (CNTFRQ_EL0), programmed at EL3 in boot.S.
+ * 
+ * @return The counter frequency in Hz.
+ */
+extern uint64_t local_timer_get_freq(void);
+
+/**
+ * @brief Writes the physical timer value register (CNTP_TVAL_EL0).
+ * 
+ * The timer fires once the counter has advanced by `ticks`.
+ * 
+ * @param ticks Number of counter ticks until the next interrupt.
+ */
+extern void local_timer_set_tval(uint32_t ticks);
+
+/**
+ * @brief Writes the physical timer control register (CNTP_CTL_EL0).
+ * 
+ * @param ctl Combination of CNTP_CTL_ENABLE and CNTP_CTL_IMASK.
+ */
+extern void local_timer_set_ctl(uint32_t ctl);
+
+/**
+ * @brief Reads the physical timer compare value (CNTP_CVAL_EL0).
+ * 
+ * Writing the value register sets it to the counter plus the value: in the timer
+ * handler it is the counter value at which the interrupt fired.
+ * 
+ * @return The compare value, in counter ticks.
+ */
+extern uint64_t local_timer_get_cval(void);
+
+/**
+ * @brief Initializes the generic timer time base.
+ * 
+ * Programs the core timer clock (crystal, divide by 1), computes the counter to
+ * microsecond conversion and aligns the time base on the System Timer epoch, so
+ * that timer_get_ticks() keeps returning System Timer microseconds.
+ * Must be called once by core 0 before the other cores are released.
+ */
+extern void local_timer_init(void);
+
+/**
+ * @brief Starts the periodic tick of the calling core.
+ * 
+ * Arms the non-secure physical timer for LOCAL_TIMER_TICK_US and routes its
+ * interrupt to the calling core as an IRQ.
+ */
+extern void local_timer_core_init(void);
+
+/**
+ * @brief Handles the tick interrupt of the calling core.
+ * 
+ * Re-arms the timer for the next period and counts the tick.
+ */
+extern void handle_local_timer(void);
+
+/**
+ * @brief Tells whether the generic time base has been initialized.
+ * 
+ * @return 1 once local_timer_init() has run, 0 before.
+ */
+extern uint8_t local_timer_ready(void);
+
+/**
+ * @brief Converts the physical counter to System Timer microseconds.
+ * 
+ * @return The current time in microseconds, on the System Timer epoch.
+ */
+extern uint64_t local_timer_get_us(void);
+
+/**
+ * @brief Returns the number of ticks handled by a core.
+ * 
+ * @param core Core number.
+ * 
+ * @return The tick count of the core.
+ */
+extern uint64_t local_timer_get_tick_count(uint8_t core);
+
+#endif /* _LOCAL_TIMER_H_ */
@@ -0,0 +1,177 @@
+/**
+ * @file        mailbox.h
+ * @brief       VideoCore mailbox property interface.
+ * @description This header defines the mailbox 0 registers of the BCM2837 and the
+ *              property channel used to query the firmware (memory split, clocks...).
+ *              A property message is a sequence of 32-bit words: total size, request
+ *              code, tags, end tag. The firmware writes its response in place.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _MAILBOX_H_
+#define _MAILBOX_H_
+
+#include <stdint.h>
+#include "base.h"
+
+#define MBOX_BASE_ADDRESS       (PIBASE + 0xB880)
+
+// Mailbox 0 (VideoCore to ARM) and mailbox 1 (ARM to VideoCore) registers
+struct MBOX_Registers {
+    volatile uint32_t READ;         // 0x00 - Mailbox 0 read (channel in [3:0])
+    volatile uint32_t reserved1[3]; // 0x04 - 0x0C
+    volatile uint32_t PEEK;         // 0x10
+    volatile uint32_t SENDER;       // 0x14
+    volatile uint32_t STATUS;       // 0x18 - Mailbox 0 status
+    volatile uint32_t CONFIG;       // 0x1C
+    volatile uint32_t WRITE;        // 0x20 - Mailbox 1 write (channel in [3:0])
+    volatile uint32_t reserved2[5]; // 0x24 - 0x34
+    volatile uint32_t STATUS1;      // 0x38 - Mailbox 1 status
+};
+
+#define MBOX ((struct MBOX_Registers *)(MBOX_BASE_ADDRESS))
+
+// Status bits
+#define MBOX_STATUS_FULL        0x80000000  // No room to write
+#define MBOX_STATUS_EMPTY       0x40000000  // Nothing to read
+
+// Property channel (ARM to VideoCore)
+#define MBOX_CH_PROP            8
+
+// Message codes
+#define MBOX_REQUEST            0x00000000
+#define MBOX_RESPONSE_OK        0x80000000
+#define MBOX_TAG_RESPONSE       0x80000000  // Set in a tag's length word by the firmware
+
+// Property tags
+#define MBOX_TAG_END                0x00000000
+#define MBOX_TAG_GET_BOARD_REVISION 0x00010002  // Response: revision code
+#define MBOX_TAG_GET_ARM_MEMORY     0x00010005  // Response: base, size (bytes)
+#define MBOX_TAG_GET_VC_MEMORY      0x00010006  // Response: base, size (bytes)
+#define MBOX_TAG_GET_CLOCK_RATE     0x00030002  // Request: clock id; response: clock id, rate (Hz)
+#define MBOX_TAG_GET_MAX_CLOCK_RATE 0x00030004  // Request: clock id; response: clock id, rate (Hz)
+#define MBOX_TAG_GET_MIN_CLOCK_RATE 0x00030007  // Request: clock id; response: clock id, rate (Hz)
+#define MBOX_TAG_SET_CLOCK_RATE     0x00038002  // Request: clock id, rate, skip turbo; response: clock id, rate
+
+// Clock ids of the clock tags
+#define MBOX_CLOCK_EMMC         1
+#define MBOX_CLOCK_UART         2           // PL011 reference clock
+#define MBOX_CLOCK_ARM          3           // Cortex-A53 cores
+#define MBOX_CLOCK_CORE         4           // VPU core clock (mini UART, I2C, SPI)
+
+// Largest message handled by mbox_property(), in words
+#define MBOX_BUFFER_WORDS       64
+
+// Largest value buffer of a single-tag message (mbox_tag), in words
+#define MBOX_TAG_MAX_WORDS      8
+
+// Polls of the status register before a request is abandoned
+#define MBOX_SPIN_MAX           10000000
+
+// Return codes
+#define MBOX_OK                 0
+#define MBOX_ERROR              -1          // Invalid message, timeout or rejected by the firmware
+
+/**
+ * @brief Sends a property message and waits for the response.
+ * 
+ * The message is copied into a cache-line aligned buffer (cleaned before and
+ * invalidated after the call), so `msg` may live anywhere. Polls the mailbox:
+ * usable before interrupts are set up. Serialized across cores.
+ * 
+ * @param msg   The message; word 0 holds its size in bytes. Receives the response.
+ * @param words Size of `msg` in words, at most MBOX_BUFFER_WORDS.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR if the firmware did not answer or rejected the request.
+ */
+extern int mbox_property(uint32_t *msg, uint32_t words);
+
+/**
+ * @brief Queries the RAM given to the ARM (the rest belongs to the GPU, see gpu_mem).
+ * 
+ * @param[out] base Start of the ARM memory.
+ * @param[out] size Size of the ARM memory in bytes.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+extern int mbox_get_arm_memory(uint32_t *base, uint32_t *size);
+
+/**
+ * @brief Sends a message holding a single tag and waits for the response.
+ * 
+ * @param tag       MBOX_TAG_* tag.
+ * @param values    Value buffer of the tag: the request on entry, the response on return.
+ * @param words     Size of the value buffer in words (the larger of the request and
+ *                  of the response), at most MBOX_TAG_MAX_WORDS.
+ * @param req_words Words of the request in the value buffer.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR if the firmware did not answer the tag.
+ */
+extern int mbox_tag(uint32_t tag, uint32_t *values, uint32_t words, uint32_t req_words);
+
+/**
+ * @brief Queries the RAM kept by the VideoCore (gpu_mem in config.txt).
+ * 
+ * @param[out] base Start of the VideoCore memory.
+ * @param[out] size Size of the VideoCore memory in bytes.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+extern int mbox_get_vc_memory(uint32_t *base, uint32_t *size);
+
+/**
+ * @brief Queries the board revision code (e.g. 0xA020D3 for a Raspberry Pi 3 B+).
+ * 
+ * @param[out] revision Revision code.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+extern int mbox_get_board_revision(uint32_t *revision);
+
+/**
+ * @brief Queries the current rate of a clock.
+ * 
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR (also for a clock that does not exist).
+ */
+extern int mbox_get_clock_rate(uint32_t clock, uint32_t *hz);
+
+/**
+ * @brief Queries the highest rate the firmware allows for a clock.
+ * 
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+extern int mbox_get_max_clock_rate(uint32_t clock, uint32_t *hz);
+
+/**
+ * @brief Queries the lowest rate the firmware allows for a clock.
+ * 
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+extern int mbox_get_min_clock_rate(uint32_t clock, uint32_t *hz);
+
+/**
+ * @brief Sets the rate of a clock.
+ * 
+ * The firmware clamps the rate to the limits of the clock and adjusts the core
+ * voltage with the ARM rate (turbo). Blocks until the clock has switched.
+ * 
+ * @param clock       MBOX_CLOCK_* id.
+ * @param hz          Requested rate in Hz.
+ * @param[out] actual Rate set by the firmware, in Hz (may be 0).
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+extern int mbox_set_clock_rate(uint32_t clock, uint32_t hz, uint32_t *actual);
+
+#endif /* _MAILBOX_H_ */
@@ -15,15 +15,45 @@
 #ifndef _MM_H_
 #define _MM_H_
 
+#include "base.h"
+#include "sysregs.h"
+
 #define PAGE_SHIFT      12                          // 4KB pages
-#define TABLE_SHIFT     10                          // Typically 10 for 64-bit ARMv8-A (could be 9 for 32-bit mode)
-#define SECTION_SHIFT   (PAGE_SHIFT + TABLE_SHIFT)  // 12 + 10 = 22 for larger sections (or 21 for 2MB)
+#define TABLE_SHIFT     9                           // 512 eight-byte descriptors per 4KB translation table
+#define SECTION_SHIFT   (PAGE_SHIFT + TABLE_SHIFT)  // 12 + 9 = 21 for 2MB sections
 
 #define PAGE_SIZE       (1 << PAGE_SHIFT)           // 4KB
-#define SECTION_SIZE    (1 << SECTION_SHIFT)        // 2MB or larger sections (may be 2MB or 16MB depending on configuration)
+#define SECTION_SIZE    (1 << SECTION_SHIFT)        // 2MB sections (level 2 block size)
 
 #define LOW_MEMORY      (2 * SECTION_SIZE)          // Typically 4MB for 2MB sections
 
+// Per-core stacks: core n uses the stack ending at LOW_MEMORY - n * CORE_STACK_SIZE
+#define CORE_STACK_SIZE (16 * PAGE_SIZE)            // 64KB per core
+
+// Per-core IRQ stacks, below the core stacks: core n's IRQ stack ends at IRQ_STACK_TOP - n * IRQ_STACK_SIZE
+#define IRQ_STACK_SIZE  (2 * PAGE_SIZE)             // 8KB per core
+#define IRQ_STACK_TOP   (LOW_MEMORY - NR_CORES * CORE_STACK_SIZE)
+
+// Translation table layout (4KB granule, 39-bit VA, identity map)
+#define PTRS_PER_TABLE  (1 << TABLE_SHIFT)          // Entries per translation table
+#define PUD_SHIFT       (PAGE_SHIFT + 2 * TABLE_SHIFT)  // 30: one level 1 entry maps 1GB
+#define PMD_SHIFT       (PAGE_SHIFT + TABLE_SHIFT)  // 21: one level 2 entry maps 2MB
+#define PG_DIR_SIZE     (2 * PAGE_SIZE)             // One level 1 table + one level 2 table
+
+// Translation table descriptor fields
+#define MM_TYPE_PAGE_TABLE  0x3                     // Descriptor points to a next-level table
+#define MM_TYPE_BLOCK       0x1                     // Descriptor maps a 1GB/2MB block
+#define MM_ACCESS           (1 << 10)               // Access flag (no access fault on first use)
+#define MM_SH_INNER         (3 << 8)                // Inner shareable
+#define MM_XN               (3 << 53)               // PXN | UXN, never execute (64-bit expression, assembler only)
+
+// Block descriptor attributes for RAM and for the peripheral windows
+#define MMU_NORMAL_FLAGS    (MM_TYPE_BLOCK | (MT_NORMAL << 2) | MM_SH_INNER | MM_ACCESS)
+#define MMU_DEVICE_FLAGS    (MM_TYPE_BLOCK | (MT_DEVICE_nGnRnE << 2) | MM_ACCESS | MM_XN)
+
+// End (exclusive) of the peripheral window mapped as device memory at level 2
+#define DEVICE_END      LOCAL_PIBASE
+
 #ifndef __ASSEMBLER__
 
 #include <stdint.h>
@@ -32,23 +62,106 @@
 /**
  * @brief Zero Memory Function (memzero)
  * @description
- *   This function sets a block of memory to zero. It repeatedly stores zero 
- *   into the memory addresses starting from the one pointed to by `x0`, 
- *   decrementing the size (`x1`) by 8 bytes each time until `x1` becomes zero.
- *   The function uses `x1` to track the remaining number of bytes to clear.
+ *   Sets a block of memory to zero; same as memset(src, 0, n).
  * @notes
- *   - The function operates in a loop, clearing 8 bytes at a time (using 64-bit zeroing).
- *   - `x0` must hold the address of the memory to be zeroed.
- *   - `x1` must hold the total number of bytes to clear (multiple of 8 for efficiency).
- * @param x0 (address)
+ *   - Any alignment and any size, including 0.
+ *   - Usable with the MMU off (aligned accesses only, no DC ZVA).
+ * @param src
  *   The address of the memory region to be zeroed.
- * @param x1 (size)
- *   The number of bytes to zero, must be a multiple of 8.
- * @return 
- *   This function does not return a value. It clears memory and then returns control to the caller.
+ * @param n
+ *   The number of bytes to zero.
  */
 extern void memzero(uint64_t src,  uint32_t n);
 
+/**
+ * @brief Fills memory with a byte value.
+ * @description
+ *   Aligned `stp` stores, and `DC ZVA` on whole cache lines for large zero fills
+ *   once the MMU and the data cache are on. Also the target of the calls GCC emits
+ *   for struct initializations.
+ * @param dst Destination.
+ * @param c   Byte value.
+ * @param n   Number of bytes.
+ * @return    dst.
+ */
+extern void *memset(void *dst, int c, uint64_t n);
+
+/**
+ * @brief Copies memory; the regions must not overlap.
+ * @description
+ *   `ldp`/`stp` pairs with the destination 16-byte aligned. Also the target of the
+ *   calls GCC emits for struct copies.
+ * @notes
+ *   - Needs the MMU on when the source is unaligned.
+ * @param dst Destination.
+ * @param src Source.
+ * @param n   Number of bytes.
+ * @return    dst.
+ */
+extern void *memcpy(void *dst, const void *src, uint64_t n);
+
+/**
+ * @brief Copies memory; the regions may overlap.
+ * @param dst Destination.
+ * @param src Source.
+ * @param n   Number of bytes.
+ * @return    dst.
+ */
+extern void *memmove(void *dst, const void *src, uint64_t n);
+
+/**
+ * @brief Builds the identity-mapped translation tables.
+ * @description
+ *   Clears `pg_dir` and fills one level 1 and one level 2 table so that:
+ *   - 0x00000000 - PIBASE       is normal, write-back cacheable memory (kernel image, BSS, stacks),
+ *   - PIBASE     - LOCAL_PIBASE is device-nGnRnE memory (BCM2837 peripherals),
+ *   - LOCAL_PIBASE + 1GB        is device-nGnRnE memory (ARM local peripherals).
+ * @notes
+ *   - Must run once, on the master core, with the MMU still off.
+ */
+extern void create_page_tables(void);
+
+/**
+ * @brief Enables the MMU and the data/instruction caches on the calling core.
+ * @description
+ *   Programs MAIR_EL1, TCR_EL1 and TTBR0_EL1 with the tables built by
+ *   `create_page_tables`, invalidates the local TLB and writes SCTLR_EL1_MMU_VAL.
+ * @notes
+ *   - Every core must call it once; the tables are shared.
+ */
+extern void mmu_enable(void);
+
+/**
+ * @brief Cleans a range of the data cache to the point of coherency.
+ * @description
+ *   Writes back every dirty cache line overlapping [start, start + size) so that
+ *   a non-coherent observer (DMA engine, VideoCore, a core with caches off) sees
+ *   the data written by the CPU.
+ * @param start Start address of the range.
+ * @param size  Size of the range in bytes.
+ */
+extern void dcache_clean_range(uint64_t start, uint64_t size);
+
+/**
+ * @brief Invalidates a range of the data cache.
+ * @description
+ *   Discards the cache lines overlapping [start, start + size) so that the next CPU
+ *   read fetches what a non-coherent writer put in memory. Partial lines at both
+ *   ends are cleaned and invalidated so that neighbouring data is not lost.
+ * @param start Start address of the range.
+ * @param size  Size of the range in bytes.
+ */
+extern void dcache_invalidate_range(uint64_t start, uint64_t size);
+
+/**
+ * @brief Cleans and invalidates a range of the data cache.
+ * @description
+ *   Writes back and then discards every cache line overlapping [start, start + size).
+ * @param start Start address of the range.
+ * @param size  Size of the range in bytes.
+ */
+extern void dcache_clean_invalidate_range(uint64_t start, uint64_t size);
+
 #endif
 
 #endif /* _MM_H_ */
\ No newline at end of file
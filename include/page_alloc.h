@@ -0,0 +1,67 @@
+/**
+ * @file        page_alloc.h
+ * @brief       Physical page-frame allocator.
+ * @description This header declares the allocator of the 4KB pages of RAM above
+ *              LOW_MEMORY (kernel image and stacks) up to the end of the ARM memory
+ *              reported by the firmware. One bit per page tracks the allocations;
+ *              the bitmap itself lives in the first pages of the managed range.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _PAGE_ALLOC_H_
+#define _PAGE_ALLOC_H_
+
+#include <stdint.h>
+#include "mm.h"
+
+// First byte managed by the allocator (below: kernel image, stacks, IRQ stacks)
+#define PAGE_ALLOC_START        LOW_MEMORY
+
+// End of RAM assumed when the firmware cannot be queried (fits any gpu_mem up to 512MB)
+#define PAGE_ALLOC_DEFAULT_END  0x20000000
+
+/**
+ * @brief Initializes the page allocator.
+ * 
+ * Queries the ARM memory size through the mailbox (identity-mapped RAM ends at
+ * PIBASE at most) and marks the pages of the bitmap as used. Must run before any
+ * allocation, with the MMU and the data cache on.
+ */
+extern void page_alloc_init(void);
+
+/**
+ * @brief Allocates physically contiguous pages.
+ * 
+ * First fit, starting after the last allocation. The pages are not cleared.
+ * Callable from any core and from IRQ handlers (not from the FIQ handler).
+ * 
+ * @param count Number of pages.
+ * @return      Address of the first page, or NULL if no run of `count` free pages exists.
+ */
+extern void *page_alloc(uint32_t count);
+
+/**
+ * @brief Releases pages allocated with page_alloc().
+ * 
+ * @param addr  Address returned by page_alloc().
+ * @param count Number of pages given to page_alloc().
+ */
+extern void page_free(void *addr, uint32_t count);
+
+/**
+ * @brief Returns the number of free pages.
+ * 
+ * @return Free pages.
+ */
+extern uint32_t page_free_count(void);
+
+/**
+ * @brief Returns the number of pages managed by the allocator.
+ * 
+ * @return Managed pages, including the bitmap.
+ */
+extern uint32_t page_total_count(void);
+
+#endif /* _PAGE_ALLOC_H_ */
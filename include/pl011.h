@@ -0,0 +1,129 @@
+/**
+ * @file        pl011.h
+ * @brief       PL011 UART (UART0) interface for the Raspberry Pi.
+ * @description This header provides the registers and macros of the PL011 UART and
+ *              the functions specific to it (FIFO interrupt levels, DMA transmit).
+ *              The console functions it implements are declared in uart.h.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _PL011_H_
+#define _PL011_H_
+
+#include <stdint.h>
+#include "base.h"
+#include "uart.h"
+#include "dma.h"
+
+#define PL011_TXD               14      // GPIO 14, alternate function 0
+#define PL011_RXD               15      // GPIO 15, alternate function 0
+
+#define PL011_BASE_ADDRESS      (PIBASE + 0x201000)
+
+// Reference clock of the PL011 (init_uart_clock in config.txt)
+#ifndef PL011_CLOCK_HZ
+#define PL011_CLOCK_HZ          48000000
+#endif
+
+// Console baud rate, up to PL011_CLOCK_HZ / 16 (3 Mbaud)
+#ifndef PL011_BAUD
+#define PL011_BAUD              921600
+#endif
+
+// Baud divisor in 1/64ths: IBRD = PL011_DIVISOR >> 6, FBRD = PL011_DIVISOR & 63 (rounded)
+#define PL011_DIVISOR           ((4 * PL011_CLOCK_HZ + PL011_BAUD / 2) / PL011_BAUD)
+
+// Depth of the PL011 transmit and receive FIFOs
+#define PL011_FIFO_DEPTH        16
+
+// PL011 registers
+struct PL011_Registers {
+    volatile uint32_t DR;           // 0x00 - Data
+    volatile uint32_t RSRECR;       // 0x04 - Receive status / error clear
+    volatile uint32_t reserved1[4]; // 0x08 - 0x14
+    volatile uint32_t FR;           // 0x18 - Flags
+    volatile uint32_t reserved2;    // 0x1C
+    volatile uint32_t ILPR;         // 0x20 - IrDA (not used)
+    volatile uint32_t IBRD;         // 0x24 - Integer baud divisor
+    volatile uint32_t FBRD;         // 0x28 - Fractional baud divisor
+    volatile uint32_t LCRH;         // 0x2C - Line control
+    volatile uint32_t CR;           // 0x30 - Control
+    volatile uint32_t IFLS;         // 0x34 - Interrupt FIFO level select
+    volatile uint32_t IMSC;         // 0x38 - Interrupt mask set/clear
+    volatile uint32_t RIS;          // 0x3C - Raw interrupt status
+    volatile uint32_t MIS;          // 0x40 - Masked interrupt status
+    volatile uint32_t ICR;          // 0x44 - Interrupt clear
+    volatile uint32_t DMACR;        // 0x48 - DMA control
+};
+
+#define PL011 ((struct PL011_Registers *)(PL011_BASE_ADDRESS))
+
+// Flag register bits
+#define PL011_FR_BUSY           (1 << 3)    // Transmitting
+#define PL011_FR_RXFE           (1 << 4)    // Receive FIFO empty
+#define PL011_FR_TXFF           (1 << 5)    // Transmit FIFO full
+#define PL011_FR_TXFE           (1 << 7)    // Transmit FIFO empty
+
+// Line control bits
+#define PL011_LCRH_FEN          (1 << 4)    // FIFOs enabled
+#define PL011_LCRH_WLEN_8       (3 << 5)    // 8 data bits
+
+// Control bits
+#define PL011_CR_UARTEN         (1 << 0)
+#define PL011_CR_TXE            (1 << 8)
+#define PL011_CR_RXE            (1 << 9)
+
+// Interrupt bits (IMSC, RIS, MIS, ICR)
+#define PL011_INT_RX            (1 << 4)    // Receive FIFO at or above its level
+#define PL011_INT_TX            (1 << 5)    // Transmit FIFO at or below its level
+#define PL011_INT_RT            (1 << 6)    // Receive timeout (32 bit periods without data)
+#define PL011_INT_OE            (1 << 10)   // Receive overrun
+#define PL011_INT_ALL           0x7FF
+
+// FIFO interrupt levels (IFLS: transmit in [2:0], receive in [5:3])
+#define PL011_FIFO_1_8          0           // 2 entries
+#define PL011_FIFO_1_4          1           // 4 entries
+#define PL011_FIFO_1_2          2           // 8 entries
+#define PL011_FIFO_3_4          3           // 12 entries
+#define PL011_FIFO_7_8          4           // 14 entries
+#define PL011_IFLS(tx, rx)      ((tx) | ((rx) << 3))
+
+// Default levels: refill when 2 bytes are left, take bytes in blocks of 8 (the rest on timeout)
+#define PL011_TX_LEVEL          PL011_FIFO_1_8
+#define PL011_RX_LEVEL          PL011_FIFO_1_2
+
+// DMA control bits
+#define PL011_DMACR_RXDMAE      (1 << 0)
+#define PL011_DMACR_TXDMAE      (1 << 1)
+
+/**
+ * @brief Sets the FIFO interrupt levels.
+ * 
+ * A higher receive level means fewer interrupts (the receive timeout collects the
+ * tail of a burst); a lower transmit level means fewer refills.
+ * 
+ * @param tx_level PL011_FIFO_* level of the transmit interrupt.
+ * @param rx_level PL011_FIFO_* level of the receive interrupt.
+ */
+extern void pl011_set_fifo_levels(uint8_t tx_level, uint8_t rx_level);
+
+/**
+ * @brief Sends a buffer with DMA, paced by the transmit DREQ.
+ * 
+ * The transmit ring is flushed first and is not drained while the transfer runs:
+ * characters queued meanwhile follow the buffer. The CPU is not involved until the
+ * completion callback.
+ * 
+ * @param channel  An allocated DMA channel.
+ * @param words    One character per 32-bit word (low byte), untouched until completion.
+ * @param count    Number of characters.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL or DMA_EBUSY (a DMA transmit is already running).
+ */
+extern int pl011_send_dma(int channel, const uint32_t *words, uint32_t count, dma_callback_t callback, void *arg);
+
+#endif /* _PL011_H_ */
@@ -0,0 +1,71 @@
+/**
+ * @file        pool.h
+ * @brief       Fixed-size object pools.
+ * @description This header declares slab-style pools of equally sized objects carved
+ *              out of pages from the page allocator. Each core keeps a small cache of
+ *              free objects, so pool_alloc() and pool_free() usually only mask IRQs on
+ *              the calling core; the shared free list is locked once per
+ *              POOL_CACHE_BATCH objects. Pages given to a pool are never returned.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _POOL_H_
+#define _POOL_H_
+
+#include <stdint.h>
+#include "base.h"
+#include "spinlock.h"
+
+// Alignment (and size granularity) of the objects
+#define POOL_ALIGN              16
+
+// Free objects kept per core, and objects moved at once to or from the shared list
+#define POOL_CACHE_SIZE         16
+#define POOL_CACHE_BATCH        8
+
+// Object size rounded up to POOL_ALIGN
+#define POOL_OBJECT_SIZE(size)  (((size) + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1))
+
+// Free objects of one core
+struct pool_cache {
+    void *objects[POOL_CACHE_SIZE];
+    uint32_t count;
+};
+
+/**
+ * @brief A pool of objects of one size (at most PAGE_SIZE).
+ */
+struct pool {
+    uint32_t object_size;           // Size of an object, multiple of POOL_ALIGN
+    spinlock_t lock;                // Protects the shared free list and the counters
+    void *free_list;                // Shared free objects, linked through their first word
+    uint32_t nr_objects;            // Objects carved so far
+    uint32_t nr_pages;              // Pages taken from the page allocator
+    struct pool_cache cache[NR_CORES];
+};
+
+// Static initializer of a pool of objects of `size` bytes
+#define POOL_INIT(size)         { .object_size = POOL_OBJECT_SIZE(size), .lock = SPINLOCK_INIT }
+
+/**
+ * @brief Allocates an object.
+ * 
+ * Takes a page from the page allocator when the pool is empty. The object is not
+ * cleared. Callable from any core and from IRQ handlers (not from the FIQ handler).
+ * 
+ * @param pool The pool.
+ * @return     The object, or NULL if no memory is left.
+ */
+extern void *pool_alloc(struct pool *pool);
+
+/**
+ * @brief Returns an object to its pool.
+ * 
+ * @param pool   The pool the object was allocated from.
+ * @param object The object (NULL is ignored).
+ */
+extern void pool_free(struct pool *pool, void *object);
+
+#endif /* _POOL_H_ */
@@ -0,0 +1,203 @@
+/**
+ * @file        prof.h
+ * @brief       PMU cycle profiling and hot-path trace.
+ * @description This header declares the profiling probes, built with PROFILE=1
+ *              (make PROFILE=1). Each core counts CPU cycles in PMCCNTR_EL0 and
+ *              PROF_NR_EVENTS PMU events (cache refills, branch mispredicts, stalls)
+ *              in its first event counters. A probe marks a scope with PROF_SCOPE():
+ *              its entry and exit are stored as (probe, cycle stamp) records in a
+ *              ring owned by the calling core, and the cycles and event counts spent
+ *              in the scope are added to the probe statistics of the core.
+ *              prof_dump() prints the statistics and the traces over UART.
+ * 
+ *              Cycles are inclusive: an interrupt taken inside a scope is counted in
+ *              it. The cycle counter stops while the core sleeps in WFE/WFI.
+ *              Without PROFILE the probes compile to nothing; the benchmark image
+ *              (BENCH=1) keeps the cycle counter accessors.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _PROF_H_
+#define _PROF_H_
+
+// Profiling probes: off (0) or on (1), see the Makefile
+#ifndef PROFILE
+#define PROFILE                 0
+#endif
+
+// Benchmark image: off (0) or on (1), see bench.h
+#ifndef BENCH
+#define BENCH                   0
+#endif
+
+// Event counters used by the profiler (the Cortex-A53 has 6)
+#define PROF_NR_EVENTS          4
+
+// PMCR_EL0 fields
+#define PMCR_E                  (1 << 0)    // Enable the counters
+#define PMCR_P                  (1 << 1)    // Reset the event counters
+#define PMCR_C                  (1 << 2)    // Reset the cycle counter
+#define PMCR_LC                 (1 << 6)    // 64-bit cycle counter overflow
+#define PMCR_N_SHIFT            11          // Number of event counters (5 bits)
+
+// PMCNTENSET_EL0 bit of the cycle counter
+#define PMCNTEN_CYCLES          (1 << 31)
+
+// PMU events (architectural, then Cortex-A53 specific)
+#define PMU_EV_L1I_CACHE_REFILL 0x01
+#define PMU_EV_L1D_CACHE_REFILL 0x03
+#define PMU_EV_L1D_CACHE        0x04
+#define PMU_EV_INST_RETIRED     0x08
+#define PMU_EV_BR_MIS_PRED      0x10
+#define PMU_EV_L2D_CACHE_REFILL 0x17
+#define PMU_EV_STALL_IFETCH     0xE1        // Issue queue empty, instruction cache miss pending
+#define PMU_EV_STALL_LOAD       0xE7        // Load stalled on an L1 data cache miss
+#define PMU_EV_STALL_STORE      0xE8        // Store stalled on a full write buffer
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+// Probes
+#define PROF_PROBE_IRQ          0           // handle_irq
+#define PROF_PROBE_I2C_WRITE    1           // i2c_write
+#define PROF_PROBE_LCD_SEND     2           // lcd_send
+#define PROF_PROBE_DHT22_READ   3           // dht22_read
+#define PROF_PROBE_UART_PRINTF  4           // uart_printf
+#define PROF_NR_PROBES          5
+
+// Records per core in the trace ring (power of two)
+#define PROF_RING_SIZE          256
+
+// Type of a trace record
+#define PROF_TRACE_BEGIN        0           // Scope entry
+#define PROF_TRACE_END          1           // Scope exit
+
+/**
+ * @brief A trace record.
+ */
+struct prof_record {
+    uint64_t cycles;                        // PMCCNTR_EL0 at the event
+    uint16_t probe;                         // PROF_PROBE_*
+    uint16_t type;                          // PROF_TRACE_*
+    uint32_t reserved;
+};
+
+/**
+ * @brief Accumulated cost of a probe on one core.
+ */
+struct prof_stats {
+    uint32_t count;                         // Completed scopes
+    uint64_t cycles;                        // Total cycles
+    uint64_t max_cycles;                    // Longest scope
+    uint64_t events[PROF_NR_EVENTS];        // Total of each event counter
+};
+
+/**
+ * @brief An open scope (see PROF_SCOPE).
+ */
+struct prof_scope {
+    uint32_t probe;                         // PROF_PROBE_*
+    uint32_t events[PROF_NR_EVENTS];        // Event counters at the entry
+    uint64_t cycles;                        // Cycle counter at the entry
+};
+
+#if PROFILE || BENCH
+
+/**
+ * @brief Returns the cycle counter of the calling core.
+ * 
+ * @return PMCCNTR_EL0.
+ */
+extern uint64_t prof_read_cycles(void);
+
+/**
+ * @brief Resets and starts the cycle counter and the first PROF_NR_EVENTS event counters.
+ */
+extern void prof_pmu_enable(void);
+
+#endif /* PROFILE || BENCH */
+
+#if PROFILE
+
+/**
+ * @brief Enables the PMU of the calling core with the configured events.
+ * 
+ * Resets the counters, the trace ring and the statistics of the core. Called by
+ * kernel_main on core 0 and by secondary_main on the other cores.
+ */
+extern void prof_core_init(void);
+
+/**
+ * @brief Selects the event of a counter.
+ * 
+ * Takes effect on the calling core at once and on every core at its next
+ * prof_core_init(): set the events before smp_init() to use them everywhere.
+ * 
+ * @param counter Counter, below PROF_NR_EVENTS.
+ * @param event   PMU_EV_* event number.
+ * 
+ * @return 0, or -1 if the counter is invalid.
+ */
+extern int prof_set_event(uint32_t counter, uint32_t event);
+
+/**
+ * @brief Opens a scope: records its entry and samples the counters.
+ * 
+ * Use PROF_SCOPE() rather than calling this function directly.
+ * 
+ * @param probe PROF_PROBE_*.
+ * @return      The open scope.
+ */
+extern struct prof_scope prof_begin(uint32_t probe);
+
+/**
+ * @brief Closes a scope: records its exit and adds its cost to the statistics.
+ * 
+ * @param scope The scope opened by prof_begin().
+ */
+extern void prof_end(struct prof_scope *scope);
+
+/**
+ * @brief Prints the statistics of the probes (all cores) and the trace of each core.
+ */
+extern void prof_dump(void);
+
+/**
+ * @brief Reads the first PROF_NR_EVENTS event counters of the calling core.
+ * 
+ * @param[out] events PMEVCNTR0_EL0 to PMEVCNTR3_EL0.
+ */
+extern void prof_read_events(uint32_t *events);
+
+/**
+ * @brief Programs the event of one counter (PMSELR_EL0/PMXEVTYPER_EL0).
+ * 
+ * @param counter Counter number.
+ * @param event   PMU_EV_* event number, counted at EL1.
+ */
+extern void prof_pmu_set_event(uint32_t counter, uint32_t event);
+
+#define PROF_CAT(a, b)          PROF_CAT_(a, b)
+#define PROF_CAT_(a, b)         a##b
+
+/**
+ * @brief Profiles the rest of the enclosing block, up to any of its exits.
+ */
+#define PROF_SCOPE(probe) \
+    struct prof_scope PROF_CAT(prof_scope_, __LINE__) __attribute__((cleanup(prof_end))) = \
+        prof_begin(probe)
+
+#else
+
+#define prof_core_init()        do { } while (0)
+#define prof_dump()             do { } while (0)
+#define PROF_SCOPE(probe)
+
+#endif /* PROFILE */
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* _PROF_H_ */
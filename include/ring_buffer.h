@@ -0,0 +1,76 @@
+/**
+ * @file        ring_buffer.h
+ * @brief       Lock-free single-producer/single-consumer byte ring buffer.
+ * @description This header declares a byte FIFO shared between exactly one producer
+ *              and one consumer, which may run on different cores or in interrupt
+ *              context. The producer only writes `head`, the consumer only writes
+ *              `tail`; memory barriers order the data against the indexes.
+ *              Several producers (or consumers) must be serialized by the caller.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Byte ring buffer. The indexes run freely and are masked on access.
+ */
+struct ring_buffer {
+    volatile uint32_t head;     // Next slot to write (producer only)
+    volatile uint32_t tail;     // Next slot to read (consumer only)
+    uint32_t mask;              // Size - 1 (size is a power of two)
+    uint8_t *data;              // Storage of `mask + 1` bytes
+};
+
+/**
+ * @brief Initializes an empty ring buffer over caller-provided storage.
+ * 
+ * @param rb      Pointer to the ring buffer.
+ * @param storage Backing storage.
+ * @param size    Size of the storage in bytes (must be a power of two).
+ */
+extern void ring_buffer_init(struct ring_buffer *rb, uint8_t *storage, uint32_t size);
+
+/**
+ * @brief Appends a byte (producer side).
+ * 
+ * @param rb Pointer to the ring buffer.
+ * @param c  Byte to append.
+ * 
+ * @return 0 on success, -1 if the ring is full.
+ */
+extern int ring_buffer_put(struct ring_buffer *rb, uint8_t c);
+
+/**
+ * @brief Removes the oldest byte (consumer side).
+ * 
+ * @param rb Pointer to the ring buffer.
+ * @param c  Filled with the removed byte.
+ * 
+ * @return 1 if a byte was removed, 0 if the ring is empty.
+ */
+extern int ring_buffer_get(struct ring_buffer *rb, uint8_t *c);
+
+/**
+ * @brief Returns the number of bytes currently stored.
+ * 
+ * @param rb Pointer to the ring buffer.
+ * 
+ * @return The number of bytes that can be read.
+ */
+extern uint32_t ring_buffer_count(struct ring_buffer *rb);
+
+/**
+ * @brief Tells whether the ring is empty.
+ * 
+ * @param rb Pointer to the ring buffer.
+ * 
+ * @return 1 if the ring is empty, 0 otherwise.
+ */
+extern uint8_t ring_buffer_empty(struct ring_buffer *rb);
+
+#endif /* _RING_BUFFER_H_ */
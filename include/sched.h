@@ -0,0 +1,182 @@
+/**
+ * @file        sched.h
+ * @brief       Preemptive priority scheduler of kernel tasks.
+ * @description This header declares the tasks of SCHED_CORE and their scheduler.
+ *              Each task has its own stack from the page allocator and a fixed
+ *              priority; ready tasks of a priority run round-robin. The per-core tick
+ *              asks for a reschedule when another task is ready, and irq_exit switches
+ *              tasks when the outermost IRQ returns (the interrupted task's IRQ frame
+ *              stays on its stack). A task wakeup of a higher priority task preempts
+ *              the running one the same way.
+ * 
+ *              The boot context (kernel_main) becomes the idle task: it runs the
+ *              queued work of the core and waits for an event when nothing is ready.
+ *              Tasks block with sched_wait_event(), the scheduler counterpart of WFE:
+ *              it returns once sched_send_event() was called since the previous
+ *              wait, so a caller loops on its condition exactly as around WFE. Other
+ *              cores, IRQ handlers and the idle task wait in WFE instead.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _SCHED_H_
+#define _SCHED_H_
+
+#include "base.h"
+#include "fpsimd.h"
+
+// Core running the tasks (the other cores serve their work queues)
+#define SCHED_CORE              0
+
+// Task priorities (0 is the highest); the idle task runs below all of them
+#define TASK_PRIO_HIGH          0
+#define TASK_PRIO_NORMAL        1
+#define TASK_PRIO_LOW           2
+#define SCHED_NR_PRIO           3
+
+// Stack of a task, in pages of the page allocator (16KB)
+#define TASK_STACK_PAGES        4
+
+// Saved context of a task (callee-saved registers, see cpu_switch_to)
+#define CPU_CONTEXT_X19         0       // x19-x28, fp (x29)
+#define CPU_CONTEXT_SP          88
+#define CPU_CONTEXT_PC          96      // Return address (x30)
+#define CPU_CONTEXT_D8          112     // d8-d15 and FPCR (FPU builds)
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+// Task states
+#define TASK_RUNNING            0       // On the CPU
+#define TASK_READY              1       // In a run queue
+#define TASK_WAITING            2       // Blocked in sched_wait_event()
+#define TASK_DEAD               3       // Exited, freed by the next task to run
+
+// Entry point of a task
+typedef void (*task_fn_t)(void *arg);
+
+/**
+ * @brief Registers kept across cpu_switch_to() (layout: CPU_CONTEXT_*).
+ */
+struct cpu_context {
+    uint64_t x19_x29[11];           // x19-x28 and the frame pointer
+    uint64_t sp;                    // Stack pointer
+    uint64_t pc;                    // Where cpu_switch_to() returns (x30)
+    uint64_t reserved;
+#if FPU
+    uint64_t d8_d15[8];             // Low halves of v8-v15 (callee-saved)
+    uint64_t fpcr;
+    uint64_t reserved_fp;
+#endif
+};
+
+/**
+ * @brief A kernel task.
+ */
+struct task {
+    struct cpu_context context;     // First: cpu_switch_to() saves and loads it
+    volatile uint32_t state;        // TASK_*
+    uint8_t priority;               // TASK_PRIO_*, SCHED_NR_PRIO for the idle task
+    const char *name;
+    task_fn_t fn;                   // Entry point
+    void *arg;                      // Argument of the entry point
+    uint8_t *stack;                 // TASK_STACK_PAGES pages, NULL for the idle task
+    uint32_t event_gen;             // Event generation seen by the last wait
+    struct task *next;              // Run queue or wait list
+#if FPU
+    uint64_t fpsimd[66] __attribute__((aligned(16))); // q0-q31, FPSR, FPCR while preempted
+#endif
+};
+
+// Non-zero when the task of a core must be switched at the next IRQ return (read by irq_exit)
+extern volatile uint32_t sched_need_resched[NR_CORES];
+
+/**
+ * @brief Initializes the scheduler; the calling context (SCHED_CORE) becomes the idle task.
+ * 
+ * Needs the page allocator (task stacks and structures).
+ */
+extern void sched_init(void);
+
+/**
+ * @brief Creates a ready task.
+ * 
+ * @param name     Name of the task (kept, not copied).
+ * @param fn       Entry point; returning from it ends the task.
+ * @param arg      Argument of the entry point.
+ * @param priority TASK_PRIO_*.
+ * 
+ * @return The task, or NULL if there is no memory left or the priority is invalid.
+ */
+extern struct task *task_create(const char *name, task_fn_t fn, void *arg, uint8_t priority);
+
+/**
+ * @brief Ends the calling task. Its stack is freed by the next task to run.
+ */
+extern void task_exit(void) __attribute__((noreturn));
+
+/**
+ * @brief Returns the running task of SCHED_CORE.
+ * 
+ * @return The current task (the idle task outside of the tasks).
+ */
+extern struct task *sched_current(void);
+
+/**
+ * @brief Lets the other ready tasks of the same or a higher priority run.
+ * 
+ * Does nothing outside of tasks (other cores, IRQ context, IRQs masked).
+ */
+extern void sched_yield(void);
+
+/**
+ * @brief Blocks the calling task until the next sched_send_event().
+ * 
+ * Returns at once if an event was sent since the previous wait of the task. Falls
+ * back to WFE where a task cannot block (other cores, idle task, IRQ context).
+ */
+extern void sched_wait_event(void);
+
+/**
+ * @brief Wakes every task blocked in sched_wait_event() and executes SEV.
+ * 
+ * Callable from any core and from IRQ handlers (not from the FIQ handler).
+ */
+extern void sched_send_event(void);
+
+/**
+ * @brief Idle task body: runs the ready tasks, then waits for an event.
+ * 
+ * WFE rather than WFI: it also wakes on SEV, which the other cores use to hand
+ * work to SCHED_CORE. Interrupts wake it either way.
+ */
+extern void sched_idle(void);
+
+/**
+ * @brief Scheduler part of the per-core tick (IRQ context).
+ * 
+ * Asks for a reschedule when a task is ready, so tasks of equal priority share the
+ * CPU in LOCAL_TIMER_TICK_US slices.
+ */
+extern void sched_tick(void);
+
+/**
+ * @brief Switches tasks on the return of the outermost IRQ (called by irq_exit).
+ * 
+ * Runs on the interrupted task's stack, below its IRQ frame, with IRQs masked.
+ */
+extern void sched_preempt(void);
+
+/**
+ * @brief Saves the callee-saved context of `prev` and resumes `next`.
+ * 
+ * @param prev Running task.
+ * @param next Task to resume.
+ */
+extern void cpu_switch_to(struct task *prev, struct task *next);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* _SCHED_H_ */
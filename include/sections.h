@@ -0,0 +1,25 @@
+/**
+ * @file        sections.h
+ * @brief       Placement of the hot and the boot-only code.
+ * @description This header declares the section markers used by kernel.ld. Hot code
+ *              (the IRQ path and the interrupt handlers of the drivers) goes to
+ *              .text.hot, which the linker packs right after the vector table of
+ *              entry.S; it shares few cache lines and I-TLB pages with the rest.
+ *              Code that only runs during the boot of core 0 goes to .init.text, on
+ *              whole pages at the end of the image (init_begin/init_end) that are
+ *              not needed once kernel_main has started the tasks.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _SECTIONS_H_
+#define _SECTIONS_H_
+
+// Functions on the IRQ path (see kernel.ld)
+#define SECTION_HOT             __attribute__((section(".text.hot")))
+
+// Functions called only by kernel_main before the tasks and the other cores start
+#define SECTION_INIT            __attribute__((section(".init.text"), cold))
+
+#endif /* _SECTIONS_H_ */
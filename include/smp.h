@@ -0,0 +1,83 @@
+/**
+ * @file        smp.h
+ * @brief       Secondary core bring-up and cross-core work dispatch.
+ * @description This header declares the functions that release cores 1 to 3 from the
+ *              armstub spin table and hand work to them. Each core serves its own work
+ *              queue plus a shared queue that any idle core (including core 0, from its
+ *              main loop) may drain.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _SMP_H_
+#define _SMP_H_
+
+#include <stdint.h>
+#include "base.h"
+#include "workqueue.h"
+
+// Address of the spin table of the armstub (spin_cpu0, 8 bytes per core)
+#define SPIN_TABLE_BASE     0xD8
+
+// Core that owns the peripherals and runs kernel_main
+#define SMP_MASTER_CORE     0
+
+/**
+ * @brief Releases the secondary cores.
+ * 
+ * Writes the kernel entry point into the spin-table slot of cores 1 to 3 and wakes
+ * them up. Each core enables its MMU and enters secondary_main().
+ * Must be called by core 0, once the MMU is on and the BSS is cleared.
+ */
+extern void smp_init(void);
+
+/**
+ * @brief Main loop of a secondary core, called from boot.S.
+ * 
+ * Starts the private tick of the core, marks the core online, then runs the work queued for it and the shared work,
+ * sleeping in WFE when there is nothing to do.
+ */
+extern void secondary_main(void);
+
+/**
+ * @brief Queues a function to run on a given core.
+ * 
+ * @param core Target core (0 to NR_CORES - 1).
+ * @param fn   Function to run.
+ * @param arg  Argument passed to the function.
+ * 
+ * @return 0 on success, -1 if the core queue is full or the core is invalid.
+ */
+extern int smp_call(uint8_t core, work_fn_t fn, void *arg);
+
+/**
+ * @brief Queues a function to run on the first available core.
+ * 
+ * @param fn  Function to run.
+ * @param arg Argument passed to the function.
+ * 
+ * @return 0 on success, -1 if the shared queue is full.
+ */
+extern int smp_queue_work(work_fn_t fn, void *arg);
+
+/**
+ * @brief Runs the work pending for the calling core and the shared work.
+ * 
+ * Secondary cores call it from secondary_main(); core 0 calls it from the
+ * idle loop of kernel_main before sched_idle().
+ * 
+ * @return The number of items run.
+ */
+extern uint32_t smp_poll(void);
+
+/**
+ * @brief Tells whether a core has been brought up.
+ * 
+ * @param core Core number.
+ * 
+ * @return 1 if the core is online, 0 otherwise.
+ */
+extern uint8_t smp_core_online(uint8_t core);
+
+#endif /* _SMP_H_ */
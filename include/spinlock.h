@@ -0,0 +1,78 @@
+/**
+ * @file        spinlock.h
+ * @brief       Spinlock interface for the Cortex-A53 cores.
+ * @description This header declares spinlocks built on exclusive loads/stores
+ *              (LDAXR/STXR) with acquire/release semantics. Waiting cores sleep in
+ *              WFE and are woken when the owner releases the lock.
+ * 
+ * @note        Exclusive accesses need the MMU and the caches to be enabled
+ *              (see mmu_enable), the locks must not be used before that.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _SPINLOCK_H_
+#define _SPINLOCK_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Spinlock type. A zero value is an unlocked lock.
+ */
+typedef struct {
+    volatile uint32_t lock;     // 0 when free, 1 when held
+} spinlock_t;
+
+// Static initializer for an unlocked spinlock
+#define SPINLOCK_INIT   { 0 }
+
+/**
+ * @brief Acquires a spinlock.
+ * 
+ * Spins (sleeping in WFE between attempts) until the lock is free, then takes it
+ * with acquire semantics.
+ * 
+ * @param lock Pointer to the spinlock.
+ */
+extern void spin_lock(spinlock_t *lock);
+
+/**
+ * @brief Tries to acquire a spinlock once.
+ * 
+ * @param lock Pointer to the spinlock.
+ * 
+ * @return 1 if the lock was taken, 0 if it is held by someone else.
+ */
+extern uint32_t spin_trylock(spinlock_t *lock);
+
+/**
+ * @brief Releases a spinlock.
+ * 
+ * The store-release also clears the exclusive monitors of the waiting cores,
+ * which wakes them from WFE.
+ * 
+ * @param lock Pointer to the spinlock.
+ */
+extern void spin_unlock(spinlock_t *lock);
+
+/**
+ * @brief Disables IRQs on the calling core and acquires a spinlock.
+ * 
+ * Use this variant for locks that are also taken from interrupt handlers.
+ * 
+ * @param lock Pointer to the spinlock.
+ * 
+ * @return The previous DAIF value, to be passed to spin_unlock_irqrestore().
+ */
+extern uint64_t spin_lock_irqsave(spinlock_t *lock);
+
+/**
+ * @brief Releases a spinlock and restores the IRQ state saved by spin_lock_irqsave().
+ * 
+ * @param lock  Pointer to the spinlock.
+ * @param flags The DAIF value returned by spin_lock_irqsave().
+ */
+extern void spin_unlock_irqrestore(spinlock_t *lock, uint64_t flags);
+
+#endif /* _SPINLOCK_H_ */
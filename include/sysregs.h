@@ -15,9 +15,7 @@
 #ifndef _SYSREG_H_
 #define _SYSREG_H_
 
-// Macro for setting a bit at position x
-#define BIT_0(x)                    (0 << x)  // Set bit to 0 at position x
-#define BIT_1(x)                    (1 << x)  // Set bit to 1 at position x
+#include "base.h"
 
 // Macro for shifting a value v by p positions
 #define SHIFT(v, p)                 ((v) << (p)) // Shift value v by p positions
@@ -29,6 +27,13 @@
 // cpacr_el1 register configuration
 #define CPACR_EL1_VAL               (CPACR_FPEN_DISABLE)  // Set the CPACR register value to disable FPEN
 
+// FPEN field: FP/SIMD use at EL1 is trapped when cleared (lazy save in FPU builds, see fpsimd.h)
+#define CPACR_FPEN_MASK             SHIFT(3,20)
+
+// Exception class of ESR_EL1 (bits [31:26])
+#define ESR_EC_SHIFT                26
+#define ESR_EC_FP_ASIMD             0x07         // FP/SIMD access trapped by CPACR_EL1.FPEN
+
 // MMU Enable, Disable (bit 0)
 #define SCTLR_MMU_DISABLE           BIT_0(0)    // Disable MMU (Memory Management Unit)
 #define SCTLR_MMU_ENABLE            BIT_1(0)    // Enable MMU
@@ -49,8 +54,50 @@
 #define SCTLR_E1E_LITTLE            BIT_0(25)   // Set Little-endian mode for EL1
 #define SCTLR_E1E_BIG               BIT_1(25)   // Set Big-endian mode for EL1
 
-// sctlr_el1 register configuration
-#define SCTLR_EL1_VAL               (SCTLR_MMU_DISABLE | SCTLR_DATA_C_DISABLE | SCTLR_INSTR_I_DISABLE | SCTLR_E1E_LITTLE)
+// Reserved bits of SCTLR_EL1 that must be written as 1 (RES1 on ARMv8.0)
+#define SCTLR_RESERVED              ((3 << 28) | (3 << 22) | (1 << 20) | (1 << 11))
+
+// sctlr_el1 register configuration used while dropping to EL1 (no page tables exist yet)
+#define SCTLR_EL1_VAL               (SCTLR_RESERVED | SCTLR_MMU_DISABLE | SCTLR_DATA_C_DISABLE | SCTLR_INSTR_I_DISABLE | SCTLR_E1E_LITTLE)
+
+// sctlr_el1 register configuration written by mmu_enable once the page tables are built
+#define SCTLR_EL1_MMU_VAL           (SCTLR_RESERVED | SCTLR_MMU_ENABLE | SCTLR_DATA_C_ENABLE | SCTLR_INSTR_I_ENABLE | SCTLR_E1E_LITTLE)
+
+// Memory attribute indexes (AttrIndx field of the block/page descriptors)
+#define MT_DEVICE_nGnRnE            0           // Index 0: device memory for the peripherals
+#define MT_NORMAL                   1           // Index 1: normal cacheable memory for RAM
+
+// Memory attribute encodings
+#define MT_DEVICE_nGnRnE_FLAGS      0x00        // Device, non-Gathering, non-Reordering, no Early write ack
+#define MT_NORMAL_FLAGS             0xFF        // Normal, inner/outer write-back, read/write-allocate
+
+// mair_el1 register configuration
+#define MAIR_EL1_VAL                (SHIFT(MT_DEVICE_nGnRnE_FLAGS, 8 * MT_DEVICE_nGnRnE) | SHIFT(MT_NORMAL_FLAGS, 8 * MT_NORMAL))
+
+// Translation Control Register fields for TTBR0 (IPS left at 0 = 32-bit physical address space)
+#define TCR_T0SZ                    (64 - 39)   // 39-bit virtual address space, walks start at level 1
+#define TCR_IRGN0_WBWA              SHIFT(1,8)  // Inner write-back write-allocate table walks
+#define TCR_ORGN0_WBWA              SHIFT(1,10) // Outer write-back write-allocate table walks
+#define TCR_SH0_INNER               SHIFT(3,12) // Inner shareable table walks
+#define TCR_TG0_4K                  SHIFT(0,14) // 4KB translation granule
+#define TCR_EPD1_DISABLE            BIT_1(23)   // No TTBR1 walks (no upper-half mappings)
+
+// tcr_el1 register configuration
+#define TCR_EL1_VAL                 (TCR_T0SZ | TCR_IRGN0_WBWA | TCR_ORGN0_WBWA | TCR_SH0_INNER | TCR_TG0_4K | TCR_EPD1_DISABLE)
+
+// Cortex-A53 CPU Extended Control Register: SMP coherency enable (bit 6)
+// Must be set before the caches and the MMU are enabled.
+#define CPUECTLR_EL1_SMPEN          BIT_1(6)
+
+// Generic timer: frequency of the 19.2MHz crystal, reported to software in CNTFRQ_EL0
+#define CNTFRQ_EL0_VAL              19200000
+
+// EL1 (and EL0) access to the physical counter and the physical timer
+#define CNTHCTL_EL1PCTEN            BIT_1(0)    // No trap on CNTPCT_EL0 reads
+#define CNTHCTL_EL1PCEN             BIT_1(1)    // No trap on CNTP_* accesses
+
+// cnthctl_el2 register configuration
+#define CNTHCTL_EL2_VAL             (CNTHCTL_EL1PCTEN | CNTHCTL_EL1PCEN)
 
 // Enable Arch64 (Architecture 64-bit support)
 #define HCR_EL1_ARCH_32             BIT_0(31)   // Set HCR to 32-bit architecture mode
@@ -16,15 +16,12 @@
 #include <stdint.h>
 #include "base.h"
 
-// Macro for setting a bit at position x
-#define BIT_0(x)                    (0 << x)  // Set bit to 0 at position x
-#define BIT_1(x)                    (1 << x)  // Set bit to 1 at position x
-
 // Base address for the system timers
 #define TIMER_BASE_ADDR     (PIBASE + 0x3000)
 
-// 1.2 GHz for the ARM core clock
-#define ARM_CLOCK_FREQUENCY_HZ 1000000
+// Highest ARM core clock of the BCM2837B0 (1.4 GHz); the timers do not depend on it and
+// the running rate is queried from the firmware (clock_get_arm_hz in clock.h)
+#define ARM_CLOCK_FREQUENCY_HZ 1400000000
 
 // System Timer Register Structure
 struct TIMER_Registers {
@@ -48,18 +45,48 @@ struct TIMER_Registers {
 #define TIMER_2     2   // Timer 2 identifier
 #define TIMER_3     3   // Timer 3 identifier
 
+// Software timer modes
+#define TIMER_ONESHOT   0   // Runs once, then the timer is released
+#define TIMER_PERIODIC  1   // Re-armed every period until timer_cancel()
+
+// Number of software timers that can be armed at the same time
+#define TIMER_MAX_SOFT  32
+
+// Longest programmed sleep: the 32-bit compare is re-armed at least this often (µs).
+// Strictly below half the compare range, so the distance stays positive as an int32_t.
+#define TIMER_MAX_SLEEP_US  0x7FFFFFFFU
+
+// Shortest compare distance, so that the counter cannot pass the value being written (µs)
+#define TIMER_MIN_DELTA_US  2
+
+// Waits shorter than this are spun on the counter; longer ones sleep until that close (µs)
+#define SLEEP_SPIN_US       10
+
 /**
- * @brief Initializes the specified system timer.
- * @description This function configures the specified system timer based on the timer index. It prepares the timer for use by setting up necessary control registers and interrupt settings.
+ * @brief Callback of a software timer.
+ * 
+ * Runs in IRQ context on core 0 (System Timer interrupt), with more urgent IRQs enabled.
  * 
- * @param timer_idx The index of the timer to initialize (e.g., TIMER_1, TIMER_3).
+ * @param arg Argument given to timer_add().
+ */
+typedef void (*timer_callback_t)(void *arg);
+
+/**
+ * @brief Initializes the software timers on the specified System Timer channel.
+ * @description The channel's compare register is only programmed for the nearest
+ *              deadline: the timer runs tickless and raises no interrupt while no
+ *              software timer is due.
+ * 
+ * @param timer_idx The compare channel used by the software timers (TIMER_1 or TIMER_3;
+ *                  channels 0 and 2 belong to the VideoCore).
  */
 extern void timer_init(uint8_t timer_idx);
 
 /**
  * @brief       Get the current timer value (ticks).
- * @description This function reads the lower and higher 32 bits of the system timer 
- *              to return a 64-bit value representing the current timer ticks.
+ * @description This function returns a 64-bit value representing the current System 
+ *              Timer ticks (microseconds). After local_timer_init(), the value is 
+ *              derived from the ARMv8 generic counter instead of two MMIO reads.
  * 
  * @return      A 64-bit value representing the current timer ticks.
  */
@@ -67,14 +94,74 @@ extern uint64_t timer_get_ticks(void) ;
 
 /**
  * @brief Handles the specified timer interrupt.
- * @description This function processes the interrupt for the specified timer. It clears the interrupt flag and performs any necessary actions, such as resetting the timer or executing related tasks.
+ * @description This function clears the interrupt flag of the channel, runs the
+ *              callbacks of the software timers that are due and programs the
+ *              compare register for the next deadline.
  * 
  * @param timer_idx The index of the timer whose interrupt is being handled (e.g., TIMER_1, TIMER_3).
  */
 extern void handle_timer(uint8_t timer_idx);
 
+/**
+ * @brief Arms a software timer.
+ * @description Safe to call from any core and from IRQ context, including from a
+ *              timer callback.
+ * 
+ * @param mode      TIMER_ONESHOT or TIMER_PERIODIC.
+ * @param µs        Delay before the first expiry, and period of a periodic timer (µs).
+ * @param callback  Function called on expiry.
+ * @param arg       Argument passed to the callback.
+ * 
+ * @return A timer identifier (>= 0), or -1 if all timers are in use or the period is 0.
+ */
+extern int timer_add(uint8_t mode, uint32_t µs, timer_callback_t callback, void *arg);
+
+/**
+ * @brief Cancels a software timer.
+ * @description A callback that is already running is not interrupted. Identifiers of
+ *              expired one-shot timers are rejected, even if their slot was reused.
+ * 
+ * @param id Identifier returned by timer_add().
+ * 
+ * @return 0 if the timer was cancelled, -1 if it is not armed.
+ */
+extern int timer_cancel(int id);
+
+/**
+ * @brief Sleeps until a deadline.
+ * @description Arms a one-shot software timer SLEEP_SPIN_US before the deadline and
+ *              parks the core in WFE, or blocks the calling task in sched_wait_event() (the
+ *              timer callback sends an event, so any core can sleep), then spins the last microseconds on the counter. In interrupt
+ *              context, with IRQs masked or before timer_init(), the whole wait is spun.
+ * 
+ * @param deadline Deadline in timer_get_ticks() units (µs).
+ */
+extern void sleep_until(uint64_t deadline);
 
+/**
+ * @brief Sleeps for a number of microseconds.
+ * @description See sleep_until().
+ * 
+ * @param µs Duration of the wait (µs).
+ */
+extern void sleep_us(uint32_t µs);
+
+/**
+ * @brief Busy-waits for a number of microseconds.
+ * @description Meant for waits below SLEEP_SPIN_US (bus setup and pulse widths). Spins on
+ *              CNTPCT_EL0 converted with CNTFRQ_EL0 and rounded up, or on the System Timer
+ *              before local_timer_init().
+ * 
+ * @param µs Duration of the wait (µs).
+ */
+extern void spin_us(uint32_t µs);
 
+/**
+ * @brief Waits for a number of microseconds.
+ * @description Kept for compatibility: same as sleep_us().
+ * 
+ * @param µs Duration of the wait (µs).
+ */
 extern void delay_micro_s(uint32_t µs);
 
 #endif /* _TIMER_H_ */
@@ -0,0 +1,101 @@
+/**
+ * @file        uart.h
+ * @brief       Console UART interface.
+ * @description This header declares the console functions (uart_send, uart_recv, ...)
+ *              and selects the UART that implements them: the PL011 (pl011.c, the
+ *              default) or the mini UART (mini_uart.c). The Makefile may override the
+ *              choice (make CONSOLE_UART=0).
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _UART_H_
+#define _UART_H_
+
+#include <stdint.h>
+#include "mm.h"
+
+// Console UARTs
+#define CONSOLE_UART_MINI       0       // Mini UART (AUX), clocked by the VPU core clock
+#define CONSOLE_UART_PL011      1       // PL011 (UART0), own reference clock
+
+#ifndef CONSOLE_UART
+#define CONSOLE_UART            CONSOLE_UART_PL011
+#endif
+
+// Size of the transmit and receive rings (powers of two)
+#define UART_TX_BUFFER_SIZE     2048
+#define UART_RX_BUFFER_SIZE     256
+
+// Pages taken from the page allocator by uart_init() for both rings
+#define UART_RING_PAGES         ((UART_TX_BUFFER_SIZE + UART_RX_BUFFER_SIZE + PAGE_SIZE - 1) / PAGE_SIZE)
+
+/**
+ * @brief Initializes the UART interface for serial communication.
+ * 
+ * This function configures the UART hardware (baud rate, data bits, stop bits, etc.)
+ * and prepares it for communication. It should be called before using any UART 
+ * communication functions, after page_alloc_init() (the rings take UART_RING_PAGES).
+ */
+extern void uart_init(void);
+
+/**
+ * @brief Receives a single character from the UART.
+ * 
+ * This function waits until a character is received over the UART interface
+ * and returns the received character. The function will block until a character 
+ * is available to be read.
+ * 
+ * @return The character received from the UART.
+ */
+extern char uart_recv(void);
+
+/**
+ * @brief Receives a single character from the UART without waiting.
+ * 
+ * @param c Filled with the received character.
+ * 
+ * @return 1 if a character was received, 0 if none is pending.
+ */
+extern uint8_t uart_try_recv(char *c);
+
+/**
+ * @brief Sends a single character over the UART.
+ * 
+ * This function queues a single character for transmission over the UART interface.
+ * The transmit interrupt sends it; the function only blocks while the transmit ring
+ * is full.
+ * 
+ * @param c The character to be sent via UART.
+ */
+extern void uart_send(char c);
+
+/**
+ * @brief Sends a string of characters over the UART.
+ * 
+ * This function sends a null-terminated string over the UART interface.
+ * Each character of the string is transmitted sequentially until the null 
+ * terminator is reached. The characters are queued like with uart_send().
+ * 
+ * @param str Pointer to the null-terminated string to be sent via UART.
+ */
+extern void uart_send_string(char *str);
+
+/**
+ * @brief Sends all the queued characters synchronously.
+ * 
+ * Returns once the transmitter is idle. Does not rely on interrupts, so it can be
+ * used on panic paths.
+ */
+extern void uart_flush(void);
+
+/**
+ * @brief Handles the console UART interrupt.
+ * 
+ * Drains the receive FIFO into the receive ring and refills the transmit FIFO
+ * from the transmit ring.
+ */
+extern void handle_uart_irq(void);
+
+#endif /* _UART_H_ */
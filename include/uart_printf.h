@@ -16,6 +16,7 @@
 #define UART_PRINTF_H
 
 #include <stdarg.h>  // For va_list and related functions
+#include <stdint.h>
 
 // Function declarations for the UART printing system
 
@@ -23,13 +24,27 @@
  * @brief Prints formatted data over UART.
  * 
  * This function mimics the behavior of the standard `printf` function, enabling 
- * formatted output via UART. It supports different format specifiers like `%d`, `%i`, 
- * `%u`, `%x`, `%X`, `%s`, and 64-bit integer formats like `%lld`, `%llu`, `%llx`, and `%llX`.
+ * formatted output via UART. It supports different format specifiers like `%c`, `%d`, `%i`, 
+ * `%u`, `%x`, `%X`, `%s`, `%p`, 64-bit integer formats like `%lld`, `%llu`, `%llx` and `%llX`,
+ * field widths with `-`/`0` padding, and fixed-point `%.Nf` (see format.h).
  * 
  * @param format The format string containing text and format specifiers.
  * @param ... The variables to be formatted and printed.
  */
 void uart_printf(const char *format, ...);
 
+/**
+ * @brief Prints formatted data over UART from raw 64-bit arguments.
+ * 
+ * Same conversions as `uart_printf`, but the arguments are read from an array of 
+ * 64-bit values instead of a variable argument list. This is the replay path of 
+ * the deferred log (see klog.h).
+ * 
+ * @param format The format string containing text and format specifiers.
+ * @param args   The raw arguments, one 64-bit value per format specifier.
+ * @param nargs  Number of raw arguments.
+ */
+void uart_printf_args(const char *format, const uint64_t *args, uint32_t nargs);
+
 #endif // UART_PRINTF_H
 
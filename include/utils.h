@@ -102,4 +102,37 @@ extern uint8_t get_el(void);
  */
 extern uint8_t get_sp(void);
 
+/**
+ * @brief Retrieves the ID of the calling core.
+ * 
+ * This function reads Aff0 of the `MPIDR_EL1` register, which numbers the
+ * cores of the cluster.
+ * 
+ * ## Return Value:
+ * - x0: The core ID (0 to 3 on the BCM2837B0).
+ */
+extern uint8_t get_core_id(void);
+
+/**
+ * @brief Signals an event to all cores (`sev`).
+ * 
+ * Prior stores are made visible first, so a core woken from `wfe` observes them.
+ */
+extern void cpu_send_event(void);
+
+/**
+ * @brief Waits for an event (`wfe`).
+ * 
+ * The core sleeps until `sev` is executed by any core, an exclusive monitor is
+ * cleared or an interrupt is pending.
+ */
+extern void cpu_wait_event(void);
+
+/**
+ * @brief Waits for an interrupt (`wfi`).
+ * 
+ * The core sleeps until an interrupt is pending, even if it is masked in PSTATE.
+ */
+extern void cpu_wait_interrupt(void);
+
 #endif /* _UTILS_H_ */
\ No newline at end of file
@@ -0,0 +1,86 @@
+/**
+ * @file        workqueue.h
+ * @brief       Cross-core work queue interface.
+ * @description This header declares a bounded FIFO of work items (a function and its
+ *              argument). Any core, including interrupt handlers, may push items; the
+ *              core serving the queue pops and runs them. Accesses are serialized by
+ *              an IRQ-safe spinlock.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#ifndef _WORKQUEUE_H_
+#define _WORKQUEUE_H_
+
+#include <stdint.h>
+#include "spinlock.h"
+
+// Maximum number of pending items per queue (must be a power of two)
+#define WORK_QUEUE_SIZE     32
+
+/**
+ * @brief Work function type.
+ */
+typedef void (*work_fn_t)(void *arg);
+
+/**
+ * @brief A unit of work: a function and its argument.
+ */
+struct work_item {
+    work_fn_t fn;               // Function to run
+    void *arg;                  // Argument passed to the function
+};
+
+/**
+ * @brief A bounded FIFO of work items.
+ */
+struct work_queue {
+    spinlock_t lock;                            // Serializes producers and consumers
+    uint32_t head;                              // Index of the next item to pop
+    uint32_t tail;                              // Index of the next free slot
+    struct work_item items[WORK_QUEUE_SIZE];    // Circular storage
+};
+
+/**
+ * @brief Initializes an empty work queue.
+ * 
+ * @param wq Pointer to the work queue.
+ */
+extern void work_queue_init(struct work_queue *wq);
+
+/**
+ * @brief Appends a work item to a queue.
+ * 
+ * Safe to call from any core and from interrupt handlers.
+ * 
+ * @param wq  Pointer to the work queue.
+ * @param fn  Function to run.
+ * @param arg Argument passed to the function.
+ * 
+ * @return 0 on success, -1 if the queue is full.
+ */
+extern int work_queue_push(struct work_queue *wq, work_fn_t fn, void *arg);
+
+/**
+ * @brief Removes the oldest work item of a queue.
+ * 
+ * @param wq   Pointer to the work queue.
+ * @param item Filled with the removed item.
+ * 
+ * @return 1 if an item was removed, 0 if the queue is empty.
+ */
+extern int work_queue_pop(struct work_queue *wq, struct work_item *item);
+
+/**
+ * @brief Runs all the items currently pending in a queue.
+ * 
+ * Items are run outside the queue lock, so a work function may push new items.
+ * 
+ * @param wq Pointer to the work queue.
+ * 
+ * @return The number of items run.
+ */
+extern uint32_t work_queue_run(struct work_queue *wq);
+
+#endif /* _WORKQUEUE_H_ */
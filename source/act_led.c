@@ -10,6 +10,10 @@
 
 #include "act_led.h"
 #include "gpio.h"
+#include "sections.h"
+
+// Register positions of the LED pin, for the one-store toggle
+static const struct gpio_pin act_led_pin = GPIO_PIN_DESC(ACT_LED_GPIO);
 
 /**
  * @brief Initializes the ACT LED GPIO pin.
@@ -17,7 +21,7 @@
  * This function sets up the ACT LED GPIO pin for output mode. It also configures
  * the pull-down resistor to ensure the pin starts in a known state.
  */
-void act_led_init(void)
+SECTION_INIT void act_led_init(void)
 {
     // Configure the pin as an output.
     gpio_set_pin_function(ACT_LED_GPIO, GPIO_OUTPUT);
@@ -34,19 +38,15 @@ void act_led_init(void)
  */
 void act_led_toggle(void)
 {
-    uint8_t act_pin_val;
-
     // Read the current state of the pin.
-    act_pin_val = gpio_read_pin(ACT_LED_GPIO);
-    
-    if (act_pin_val == 1)
+    if (gpio_pin_read(&act_led_pin) == 1)
     {
         // Turn off the LED if it is currently on.
-        gpio_clear_pin(ACT_LED_GPIO);
+        gpio_pin_clear(&act_led_pin);
     }
     else
     {
         // Turn on the LED if it is currently off.
-        gpio_set_pin(ACT_LED_GPIO);
+        gpio_pin_set(&act_led_pin);
     }
 }
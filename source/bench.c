@@ -0,0 +1,374 @@
+/**
+ * @file        bench.c
+ * @brief       On-target benchmark suite.
+ * @description This file implements the suite of the benchmark image (see bench.h).
+ *              Durations are measured on the generic counter (CNTPCT_EL0, 19.2 MHz)
+ *              and converted to nanoseconds, except the exception frames, counted in
+ *              CPU cycles (PMCCNTR_EL0); each test prints its results as soon as it
+ *              is over.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "bench.h"
+
+#if BENCH
+
+#include "base.h"
+#include "mm.h"
+#include "uart.h"
+#include "uart_printf.h"
+#include "i2c.h"
+#include "lcd_2004.h"
+#include "irq.h"
+#include "entry.h"
+#include "local_timer.h"
+#include "timer.h"
+#include "page_alloc.h"
+#include "format.h"
+#include "utils.h"
+#include "clock.h"
+#include "prof.h"
+
+// SCL frequencies of the I2C test (Hz; the dividers follow the core clock)
+static const uint32_t bench_i2c_speeds[] = { 60000, 100000, 200000, 300000 };
+
+// Durations of the sleep test (µs)
+static const uint32_t bench_delays[] = { 10, 100, 1000, 10000 };
+
+// IRQ latency samples (counter ticks), filled by bench_timer_irq()
+static volatile uint64_t bench_irq_latency[BENCH_IRQ_SAMPLES];
+static volatile uint32_t bench_irq_count;
+
+/**
+ * @brief Prints one result.
+ * 
+ * @param name  Name of the result.
+ * @param value Value, -1 if the measurement failed.
+ * @param unit  Unit of the value.
+ */
+static void bench_report(const char *name, int64_t value, const char *unit)
+{
+    uart_printf("BENCH name=%s value=%lld unit=%s\n", name, value, unit);
+}
+
+/**
+ * @brief Prints one result with three decimals.
+ * 
+ * @param name  Name of the result.
+ * @param milli Value multiplied by 1000.
+ * @param unit  Unit of the value.
+ */
+static void bench_report_milli(const char *name, int64_t milli, const char *unit)
+{
+    uart_printf("BENCH name=%s value=%.3lf unit=%s\n", name, milli, unit);
+}
+
+/**
+ * @brief Converts counter ticks to nanoseconds.
+ * 
+ * @param ticks Counter ticks (below about 15 minutes).
+ * @return      Nanoseconds.
+ */
+static uint64_t bench_ns(uint64_t ticks)
+{
+    return (ticks * 1000000000ULL) / local_timer_get_freq();
+}
+
+/**
+ * @brief UART throughput: lines of padding through the transmit ring.
+ */
+static void bench_uart(void)
+{
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+
+    uart_flush();
+
+    start = local_timer_get_counter();
+    for (i = 1; i <= BENCH_UART_BYTES; i++)
+    {
+        uart_send((i % 64) ? '.' : '\n');
+    }
+    uart_flush();
+    ns = bench_ns(local_timer_get_counter() - start);
+
+    uart_send('\n');
+    bench_report("uart_tx", (int64_t)(((uint64_t)BENCH_UART_BYTES * 1000000000ULL) / ns), "B/s");
+}
+
+/**
+ * @brief I2C write latency per byte at each divider, on the LCD expander.
+ * 
+ * The payload only holds the backlight bit: the enable line stays low, so the LCD
+ * ignores the writes.
+ */
+static void bench_i2c(void)
+{
+    uint8_t payload[BENCH_I2C_BYTES];
+    char name[24];
+    uint64_t start;
+    uint64_t ns;
+    uint32_t d;
+    uint32_t i;
+    int status = I2C_OK;
+
+    memset(payload, LCD_BACKLIGHT, sizeof(payload));
+
+    for (d = 0; d < sizeof(bench_i2c_speeds) / sizeof(bench_i2c_speeds[0]); d++)
+    {
+        // The driver rounds the divider up: SCL is at most bench_i2c_speeds[d]
+        i2c_set_device_speed(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, bench_i2c_speeds[d]);
+
+        start = local_timer_get_counter();
+        for (i = 0; (i < BENCH_I2C_WRITES) && (status == I2C_OK); i++)
+        {
+            status = i2c_write(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, payload, sizeof(payload));
+        }
+        ns = bench_ns(local_timer_get_counter() - start);
+
+        format_snprintf(name, sizeof(name), "i2c_write_%ukhz", bench_i2c_speeds[d] / 1000);
+        bench_report(name, (status == I2C_OK) ? (int64_t)(ns / (BENCH_I2C_WRITES * BENCH_I2C_BYTES)) : -1, "ns/B");
+        status = I2C_OK;
+    }
+
+    // Back to the speed of lcd_init()
+    i2c_set_device_speed(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, LCD_I2C_SPEED);
+}
+
+/**
+ * @brief LCD full-screen redraw: every cell changes between two flushes.
+ */
+static void bench_lcd(void)
+{
+    char line[LCD_COLUMNS + 1];
+    uint64_t total = 0;
+    uint64_t start;
+    uint32_t pass;
+    uint32_t row;
+
+    line[LCD_COLUMNS] = '\0';
+
+    for (pass = 0; pass < BENCH_LCD_REDRAWS; pass++)
+    {
+        // Alternate two patterns so that the whole shadow is dirty
+        memset(line, (pass & 1) ? '#' : '-', LCD_COLUMNS);
+        for (row = 0; row < LCD_ROWS; row++)
+        {
+            lcd_set_cursor(0, row);
+            lcd_print(line);
+        }
+
+        start = local_timer_get_counter();
+        lcd_flush();
+        total += local_timer_get_counter() - start;
+    }
+
+    bench_report("lcd_redraw", (int64_t)(bench_ns(total) / (BENCH_LCD_REDRAWS * 1000)), "us");
+}
+
+/**
+ * @brief Local timer handler of the IRQ latency test.
+ * 
+ * The compare value is the counter value at which the tick fired; handle_irq()
+ * sampled the counter on its first statement.
+ */
+static void bench_timer_irq(void)
+{
+    uint32_t count = bench_irq_count;
+
+    if (count < BENCH_IRQ_SAMPLES)
+    {
+        bench_irq_latency[count] = irq_entry_time() - local_timer_get_cval();
+        bench_irq_count = count + 1;
+    }
+
+    // Keep the tick running
+    handle_local_timer();
+}
+
+/**
+ * @brief IRQ entry latency: timer compare to the first statement of handle_irq().
+ */
+static void bench_irq(void)
+{
+    uint64_t total = 0;
+    uint64_t max = 0;
+    uint64_t min = ~0ULL;
+    uint32_t i;
+
+    bench_irq_count = 0;
+    irq_register(IRQ_LOCAL_CNTPNS, bench_timer_irq, IRQ_PRIO_HIGHEST);
+
+    while (bench_irq_count < BENCH_IRQ_SAMPLES)
+    {
+        cpu_wait_interrupt();
+    }
+
+    irq_register(IRQ_LOCAL_CNTPNS, handle_local_timer, IRQ_PRIO_HIGHEST);
+
+    for (i = 0; i < BENCH_IRQ_SAMPLES; i++)
+    {
+        total += bench_irq_latency[i];
+        if (bench_irq_latency[i] > max)
+        {
+            max = bench_irq_latency[i];
+        }
+        if (bench_irq_latency[i] < min)
+        {
+            min = bench_irq_latency[i];
+        }
+    }
+
+    bench_report("irq_latency_min", (int64_t)bench_ns(min), "ns");
+    bench_report("irq_latency_avg", (int64_t)bench_ns(total / BENCH_IRQ_SAMPLES), "ns");
+    bench_report("irq_latency_max", (int64_t)bench_ns(max), "ns");
+}
+
+/**
+ * @brief Cost of the exception frame sequences of entry.S, without the exception.
+ * 
+ * A frame is a few dozen instructions, far below one generic counter tick (52 ns):
+ * it is measured in CPU cycles (PMCCNTR_EL0).
+ */
+static void bench_frames(void)
+{
+    uint64_t start;
+    uint64_t cycles;
+    uint64_t flags;
+    uint32_t i;
+
+#if !PROFILE
+    // PROFILE builds have started the counters in prof_core_init(): keep their trace
+    prof_pmu_enable();
+#endif
+
+    // The IRQ sequence switches to the IRQ stack: no interrupt may come in between
+    flags = irq_save();
+
+    start = prof_read_cycles();
+    for (i = 0; i < BENCH_FRAME_CALLS; i++)
+    {
+        exception_frame_probe_irq();
+    }
+    cycles = prof_read_cycles() - start;
+    bench_report("irq_frame", (int64_t)(cycles / BENCH_FRAME_CALLS), "cycles");
+
+    start = prof_read_cycles();
+    for (i = 0; i < BENCH_FRAME_CALLS; i++)
+    {
+        exception_frame_probe_full();
+    }
+    cycles = prof_read_cycles() - start;
+    bench_report("exception_frame", (int64_t)(cycles / BENCH_FRAME_CALLS), "cycles");
+
+    irq_restore(flags);
+}
+
+/**
+ * @brief delay_micro_s() accuracy (mean overshoot) and jitter (spread) per duration.
+ */
+static void bench_delay(void)
+{
+    char name[32];
+    uint64_t expected;
+    uint64_t total;
+    uint64_t max;
+    uint64_t min;
+    uint64_t ns;
+    uint64_t start;
+    uint32_t d;
+    uint32_t i;
+
+    for (d = 0; d < sizeof(bench_delays) / sizeof(bench_delays[0]); d++)
+    {
+        expected = (uint64_t)bench_delays[d] * 1000;
+        total = 0;
+        max = 0;
+        min = ~0ULL;
+
+        for (i = 0; i < BENCH_DELAY_SAMPLES; i++)
+        {
+            start = local_timer_get_counter();
+            delay_micro_s(bench_delays[d]);
+            ns = bench_ns(local_timer_get_counter() - start);
+
+            total += ns;
+            if (ns > max)
+            {
+                max = ns;
+            }
+            if (ns < min)
+            {
+                min = ns;
+            }
+        }
+
+        format_snprintf(name, sizeof(name), "delay_us%u_error", bench_delays[d]);
+        bench_report(name, (int64_t)(total / BENCH_DELAY_SAMPLES) - (int64_t)expected, "ns");
+        format_snprintf(name, sizeof(name), "delay_us%u_jitter", bench_delays[d]);
+        bench_report(name, (int64_t)(max - min), "ns");
+    }
+}
+
+/**
+ * @brief memzero() bandwidth on a buffer from the page allocator.
+ */
+static void bench_memzero(void)
+{
+    uint8_t *buffer = page_alloc(BENCH_MEMZERO_PAGES);
+    uint32_t size = BENCH_MEMZERO_PAGES * PAGE_SIZE;
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+
+    if (buffer == 0)
+    {
+        bench_report("memzero", -1, "GB/s");
+        return;
+    }
+
+    // Warm the caches and the TLB first
+    memzero((uint64_t)buffer, size);
+
+    start = local_timer_get_counter();
+    for (i = 0; i < BENCH_MEMZERO_PASSES; i++)
+    {
+        memzero((uint64_t)buffer, size);
+    }
+    ns = bench_ns(local_timer_get_counter() - start);
+
+    // Bytes per nanosecond is GB/s
+    bench_report_milli("memzero", (int64_t)(((uint64_t)size * BENCH_MEMZERO_PASSES * 1000) / ns), "GB/s");
+
+    page_free(buffer, BENCH_MEMZERO_PAGES);
+}
+
+/**
+ * @brief Runs the benchmark suite and prints its results.
+ */
+void bench_run(void)
+{
+    // The whole suite is one burst: highest ARM clock
+    clock_perf_get();
+
+    uart_printf("BENCH begin\n");
+    bench_report("arm_clock", (int64_t)(clock_get_arm_hz() / 1000000), "MHz");
+
+    bench_uart();
+    bench_i2c();
+    bench_lcd();
+    bench_irq();
+    bench_frames();
+    bench_delay();
+    bench_memzero();
+
+    uart_printf("BENCH end\n");
+    uart_flush();
+
+    clock_perf_put();
+}
+
+#endif /* BENCH */
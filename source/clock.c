@@ -0,0 +1,200 @@
+/**
+ * @file        clock.c
+ * @brief       ARM and VPU core clock control.
+ * @description This file implements the clock rates and the ARM performance states
+ *              declared in clock.h on top of the mailbox clock tags. The rates are
+ *              cached: the firmware is only asked when they change. Every change is
+ *              made under clock_lock, so the burst count and the rate stay in step.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "clock.h"
+#include "mailbox.h"
+#include "spinlock.h"
+#include "sections.h"
+
+// Cached rates (Hz)
+static volatile uint32_t clock_arm_hz = CLOCK_ARM_DEFAULT_HZ;
+static volatile uint32_t clock_core_hz = CLOCK_CORE_DEFAULT_HZ;
+
+// Rates of the low and high performance states
+static uint32_t clock_arm_min_hz = CLOCK_ARM_DEFAULT_HZ;
+static uint32_t clock_arm_max_hz = CLOCK_ARM_DEFAULT_HZ;
+
+// Bursts in progress (clock_perf_get calls not yet matched)
+static uint32_t clock_perf_count;
+
+// Core clock notifiers
+static clock_notifier_t clock_notifiers[CLOCK_MAX_NOTIFIERS];
+static uint32_t clock_nr_notifiers;
+
+// Serializes the rate changes, the burst count and the notifier list
+static spinlock_t clock_lock = SPINLOCK_INIT;
+
+/**
+ * @brief Sets the ARM clock rate and caches the rate set by the firmware (clock_lock held).
+ * 
+ * @param hz Requested rate in Hz.
+ */
+static void clock_set_arm_locked(uint32_t hz)
+{
+    uint32_t actual;
+
+    if (mbox_set_clock_rate(MBOX_CLOCK_ARM, hz, &actual) == MBOX_OK)
+    {
+        clock_arm_hz = actual;
+    }
+}
+
+/**
+ * @brief Calls every core clock notifier (clock_lock held).
+ * 
+ * @param event   CLOCK_PRE_CHANGE or CLOCK_POST_CHANGE.
+ * @param core_hz Core rate in Hz.
+ */
+static void clock_notify(uint32_t event, uint32_t core_hz)
+{
+    uint32_t i;
+
+    for (i = 0; i < clock_nr_notifiers; i++)
+    {
+        clock_notifiers[i](event, core_hz);
+    }
+}
+
+/**
+ * @brief Queries the ARM and core clock rates and switches to the low performance state.
+ */
+SECTION_INIT void clock_init(void)
+{
+    uint32_t hz;
+
+    if (mbox_get_clock_rate(MBOX_CLOCK_CORE, &hz) == MBOX_OK)
+    {
+        clock_core_hz = hz;
+    }
+    if (mbox_get_clock_rate(MBOX_CLOCK_ARM, &hz) == MBOX_OK)
+    {
+        clock_arm_hz = hz;
+    }
+
+    // Without limits from the firmware both states keep the current rate
+    clock_arm_min_hz = clock_arm_hz;
+    clock_arm_max_hz = clock_arm_hz;
+    if (mbox_get_min_clock_rate(MBOX_CLOCK_ARM, &hz) == MBOX_OK)
+    {
+        clock_arm_min_hz = hz;
+    }
+    if (mbox_get_max_clock_rate(MBOX_CLOCK_ARM, &hz) == MBOX_OK)
+    {
+        clock_arm_max_hz = hz;
+    }
+
+    // No burst yet
+    if (clock_arm_hz != clock_arm_min_hz)
+    {
+        clock_set_arm_locked(clock_arm_min_hz);
+    }
+}
+
+/**
+ * @brief Returns the current ARM clock rate.
+ */
+uint32_t clock_get_arm_hz(void)
+{
+    return clock_arm_hz;
+}
+
+/**
+ * @brief Returns the lowest and highest ARM clock rates allowed by the firmware.
+ */
+void clock_get_arm_range(uint32_t *min_hz, uint32_t *max_hz)
+{
+    *min_hz = clock_arm_min_hz;
+    *max_hz = clock_arm_max_hz;
+}
+
+/**
+ * @brief Returns the current VPU core clock rate.
+ */
+uint32_t clock_get_core_hz(void)
+{
+    return clock_core_hz;
+}
+
+/**
+ * @brief Changes the VPU core clock rate.
+ */
+int clock_set_core_hz(uint32_t hz)
+{
+    uint64_t flags;
+    uint32_t actual;
+    int status = -1;
+
+    flags = spin_lock_irqsave(&clock_lock);
+
+    // The drivers quiesce at the old rate and restart at the new one
+    clock_notify(CLOCK_PRE_CHANGE, clock_core_hz);
+    if (mbox_set_clock_rate(MBOX_CLOCK_CORE, hz, &actual) == MBOX_OK)
+    {
+        clock_core_hz = actual;
+        status = 0;
+    }
+    clock_notify(CLOCK_POST_CHANGE, clock_core_hz);
+
+    spin_unlock_irqrestore(&clock_lock, flags);
+
+    return status;
+}
+
+/**
+ * @brief Registers a core clock notifier.
+ */
+int clock_register_notifier(clock_notifier_t notifier)
+{
+    uint64_t flags;
+    int status = -1;
+
+    flags = spin_lock_irqsave(&clock_lock);
+    if (clock_nr_notifiers < CLOCK_MAX_NOTIFIERS)
+    {
+        clock_notifiers[clock_nr_notifiers++] = notifier;
+        status = 0;
+    }
+    spin_unlock_irqrestore(&clock_lock, flags);
+
+    return status;
+}
+
+/**
+ * @brief Enters a burst: the ARM clock runs at its highest rate until the matching
+ *        clock_perf_put().
+ */
+void clock_perf_get(void)
+{
+    uint64_t flags;
+
+    flags = spin_lock_irqsave(&clock_lock);
+    if (clock_perf_count++ == 0)
+    {
+        clock_set_arm_locked(clock_arm_max_hz);
+    }
+    spin_unlock_irqrestore(&clock_lock, flags);
+}
+
+/**
+ * @brief Leaves a burst: the ARM clock drops to its lowest rate once no burst is left.
+ */
+void clock_perf_put(void)
+{
+    uint64_t flags;
+
+    flags = spin_lock_irqsave(&clock_lock);
+    if ((clock_perf_count > 0) && (--clock_perf_count == 0))
+    {
+        clock_set_arm_locked(clock_arm_min_hz);
+    }
+    spin_unlock_irqrestore(&clock_lock, flags);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file        deferred_work.c
+ * @brief       Deferred work (bottom halves) for interrupt handlers.
+ * @description This file implements deferred work on top of the per-core work queues
+ *              of smp.c: the queued item is a trampoline that clears the pending flag
+ *              and runs the work function. Secondary cores run their queue from
+ *              secondary_main() with IRQs enabled; core 0 runs its own from the
+ *              kernel_main loop, also with IRQs enabled.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "deferred_work.h"
+#include "smp.h"
+#include "atomic.h"
+
+static void deferred_work_trampoline(void *arg);
+
+// Number of failed deferred_work_schedule() calls
+static volatile uint32_t dropped_count;
+
+/**
+ * @brief Runs a deferred work item.
+ * 
+ * The pending flag is cleared before the function runs, so an interrupt that
+ * happens meanwhile queues the item again.
+ * 
+ * @param arg Pointer to the struct deferred_work.
+ */
+static void deferred_work_trampoline(void *arg)
+{
+    struct deferred_work *work = (struct deferred_work *)arg;
+
+    atomic_xchg(&work->pending, 0);
+    work->fn(work->arg);
+}
+
+/**
+ * @brief Queues a deferred work item.
+ */
+int deferred_work_schedule(struct deferred_work *work)
+{
+    uint8_t core = DEFERRED_WORK_CORE;
+
+    // Already queued: it will run once more, which covers this request too.
+    if (atomic_xchg(&work->pending, 1) != 0)
+    {
+        return 0;
+    }
+
+    // Fall back to the kernel_main loop of core 0.
+    if (!smp_core_online(core))
+    {
+        core = SMP_MASTER_CORE;
+    }
+
+    if (smp_call(core, deferred_work_trampoline, work) != 0)
+    {
+        atomic_xchg(&work->pending, 0);
+        atomic_add_return(&dropped_count, 1);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Returns the number of times a work item could not be queued.
+ */
+uint32_t deferred_work_dropped(void)
+{
+    return dropped_count;
+}
@@ -1,99 +1,571 @@
 #include "dht22.h"
 #include "gpio.h"     // Replace with your platform's GPIO library
 #include "timer.h"    // Replace with your platform's delay/timer library
-#include "uart_printf.h" // For debugging messages
+#include "klog.h"     // Deferred debugging messages
+#include "irq.h"
+#include "local_timer.h"
+#include "atomic.h"
+#include "utils.h"
+#include "deferred_work.h"
+#include "spinlock.h"
+#include "fpsimd.h"
+#include "sched.h"
+#include "prof.h"
+#include "sections.h"
 
 #define DHT22_PIN          6  // Adjust based on your configuration
-#define DHT22_MAX_TIMINGS  100
-#define MAX_RETRIES        3
+#define DHT22_MAX_EDGES    100
+
+// Register positions of the data pin (bank 0: its events raise IRQ_GPIO_BANK0)
+static const struct gpio_pin dht22_pin = GPIO_PIN_DESC(DHT22_PIN);
+
+// Host start pulse: the line is held low for at least 18ms
+#define DHT22_START_US          18000
+
+// Longest frame: response (20-40µs + 80µs + 80µs) and 40 bits of up to 50µs + 70µs
+#define DHT22_FRAME_TIMEOUT_US  6000
+
+// Edges the decoder needs: response (3: falling, rising, falling) and 40 bits (2 each:
+// rising, then the falling edge ending the high time); the final release, an 84th
+// edge, is not used
+#define DHT22_FRAME_EDGES       83
+
+// High time separating a 0 (26-28µs) from a 1 (70µs)
+#define DHT22_BIT_THRESHOLD_US  50
+
+// Jitter of a timer-driven read tolerated by the minimum interval check
+#define DHT22_INTERVAL_SLACK_US 1000
+
+// Read state machine
+#define DHT22_IDLE      0   // No read in progress
+#define DHT22_START     1   // Start pulse on the line
+#define DHT22_CAPTURE   2   // Edges are being captured
+#define DHT22_DONE      3   // Result ready, completion pending
+
+// Edge timestamps (CNTPCT_EL0, low 32 bits), written by the edge interrupt only
+static uint32_t dht22_edges[DHT22_MAX_EDGES];
+static volatile uint32_t dht22_edge_count;
+
+// Current read
+static volatile uint32_t dht22_state = DHT22_IDLE;
+static struct dht22_result dht22_last;
+static dht22_callback_t dht22_callback;
+static void *dht22_callback_arg;
+
+// DHT22_BIT_THRESHOLD_US in generic timer ticks
+static uint32_t dht22_bit_ticks;
+
+// Start of the previous read (or power-up), for DHT22_MIN_INTERVAL_US
+static uint64_t dht22_last_start;
+
+// History of the valid samples (oldest overwritten first) and its cached statistics
+static struct dht22_sample dht22_history[DHT22_HISTORY_SIZE];
+static uint32_t dht22_history_head;     // Next slot to write
+static int32_t dht22_temp_sum;          // Sums over the window, for the moving average
+static uint32_t dht22_hum_sum;
+static struct dht22_stats dht22_cached_stats;
+static spinlock_t dht22_history_lock = SPINLOCK_INIT;
+
+static void dht22_handle_edge(void) FPSIMD_GENERAL_REGS_ONLY;
+static void dht22_release(void *arg);
+static void dht22_capture_done(void *arg);
+static void dht22_complete(void *arg);
+static void dht22_decode(struct dht22_result *result);
+static void dht22_record(const struct dht22_sample *sample);
+static void dht22_sampler_tick(void *arg);
+static void dht22_sampler_done(const struct dht22_result *result, void *arg);
+
+// Runs the user callback outside of IRQ context
+static struct deferred_work dht22_work = DEFERRED_WORK_INIT(dht22_complete, 0);
 
 /**
  * @brief Initializes the DHT22 sensor module.
  * 
- * This function configures the GPIO pin connected to the DHT22 sensor as an
- * input/output pin. It should be called once during system initialization.
+ * This function configures the GPIO pin connected to the DHT22 sensor as a
+ * pulled-up input (the released line) and routes the GPIO bank 0 event interrupt to the edge
+ * capture handler: through the FIQ fast path when IRQ_FIQ_SOURCE selects it,
+ * otherwise as the most urgent IRQ. It should be called once during system
+ * initialization, on core 0.
  */
-void dht22_init(void)
+SECTION_INIT void dht22_init(void)
 {
-    // Configure the GPIO pin as output initially to send the start signal
-    gpio_set_pin_function(DHT22_PIN, GPIO_OUTPUT);
-    gpio_pull_up_down(DHT22_PIN, GPIO_PUD_UP);
-    gpio_set_pin(DHT22_PIN); // Set the pin high (idle state)
+    // The line idles released: input, held high by the pull-up. Reads only
+    // switch it to output for the start pulse.
+    gpio_pin_set_function(&dht22_pin, GPIO_INPUT);
+    gpio_pull_mask(dht22_pin.bank, dht22_pin.mask, GPIO_PUD_UP);
+
+    // Bit threshold in counter ticks, so the edge handler only stores raw timestamps
+    dht22_bit_ticks = (uint32_t)((uint64_t)DHT22_BIT_THRESHOLD_US * local_timer_get_freq() / 1000000);
+
+    // No edge detection until a read starts
+    GPIO->GPREN[0] &= ~dht22_pin.mask;
+    GPIO->GPFEN[0] &= ~dht22_pin.mask;
+    GPIO->GPEDS[0] = dht22_pin.mask;
+
+#if IRQ_FIQ_SOURCE == IRQ_GPIO_BANK0
+    fiq_register(dht22_handle_edge);
+    fiq_enable();
+#else
+    irq_register(IRQ_GPIO_BANK0, dht22_handle_edge, IRQ_PRIO_HIGHEST);
+#endif
 
-    // Optionally, add a delay to stabilize the sensor after power-up
-    delay_micro_s(2000000); // Wait for the DHT22 to stabilize (recommended 2 seconds)
+    // The sensor needs 2 seconds to stabilize after power-up: the first read
+    // is held back by the minimum interval instead of blocking here
+    dht22_last_start = timer_get_ticks();
 }
 
 /**
- * @brief Reads temperature and humidity from the DHT22 sensor.
+ * @brief GPIO bank 0 event interrupt: timestamps the DHT22 edges.
  * 
- * This function communicates with the DHT22 sensor to retrieve temperature
- * and humidity values. It handles the sensor's communication protocol,
- * including sending the start signal, reading the response, and verifying
- * the checksum.
+ * Runs as the FIQ handler (or a IRQ_PRIO_HIGHEST handler), so it takes no lock:
+ * it acknowledges the event and stores the counter value. It does not use the
+ * FP/SIMD registers, which the FIQ entry does not save.
+ */
+SECTION_HOT FPSIMD_GENERAL_REGS_ONLY static void dht22_handle_edge(void)
+{
+    uint32_t now = (uint32_t)local_timer_get_counter();
+    uint32_t events = GPIO->GPEDS[0] & dht22_pin.mask;
+    uint32_t count;
+
+    if (events == 0)
+    {
+        return;
+    }
+    // Write 1 to clear the event
+    GPIO->GPEDS[0] = events;
+
+    count = dht22_edge_count;
+    if (count < DHT22_MAX_EDGES)
+    {
+        dht22_edges[count] = now;
+        dht22_edge_count = count + 1;
+    }
+}
+
+/**
+ * @brief Starts an asynchronous read of the DHT22 sensor.
+ * 
+ * This function drives the start pulse and returns. The sensor answers with a
+ * frame of 40 bits whose edges are timestamped by the GPIO event interrupt; a
+ * software timer ends the capture and decodes the frame, and the callback then
+ * runs as deferred work. The CPU cost of a read is a few interrupts. Safe to
+ * call from any core and from IRQ context.
  * 
- * @param[out] temperature Pointer to store the temperature value.
- * @param[out] humidity Pointer to store the humidity value.
+ * @param callback Function called with the result (NULL: see dht22_read()).
+ * @param arg      Argument passed to the callback.
  * 
- * @return int Status code (DHT22_OK, DHT22_TIMEOUT_ERROR, DHT22_CHECKSUM_ERROR).
+ * @return int DHT22_OK if the read started, DHT22_BUSY_ERROR if one is in progress,
+ *             DHT22_RATE_ERROR if the previous read started less than
+ *             DHT22_MIN_INTERVAL_US ago.
  */
-int dht22_read(float *temperature, float *humidity)
+int dht22_read_async(dht22_callback_t callback, void *arg)
 {
-    uint8_t data[5] = {0};
-    uint32_t last_state = 1;
-    uint32_t count = 0;
-
-    for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
-        // Pull the line low to send start signal
-        gpio_set_pin_function(DHT22_PIN, GPIO_OUTPUT);
-        gpio_clear_pin(DHT22_PIN);
-        delay_micro_s(18000); // Keep the line low for at least 18ms
-
-        // Pull the line high and wait briefly
-        gpio_set_pin(DHT22_PIN);
-        delay_micro_s(30);
-
-        // Set the pin to input mode to read the response
-        gpio_set_pin_function(DHT22_PIN, GPIO_INPUT);
-
-        // Read the response signal and data
-        for (uint32_t i = 0; i < DHT22_MAX_TIMINGS; i++) {
-            count = 0;
-            while (gpio_read_pin(DHT22_PIN) == last_state) {
-                count++;
-                delay_micro_s(1);
-                if (count > 255) {
-                    uart_printf("Timing error at index %d, Count %d, Last State %d\n", i, count, last_state);
-                    return DHT22_TIMEOUT_ERROR;
-                }
-            }
-            last_state = gpio_read_pin(DHT22_PIN);
-
-            // Skip the first 3 transitions (response signal)
-            if ((i >= 4) && (i % 2 == 0)) {
-                data[(i - 4) / 16] <<= 1;
-                if (count > 50) {
-                    data[(i - 4) / 16] |= 1;
-                }
-            }
-        }
+    uint64_t now;
+
+    if (atomic_cmpxchg(&dht22_state, DHT22_IDLE, DHT22_START) != DHT22_IDLE)
+    {
+        return DHT22_BUSY_ERROR;
+    }
+
+    // dht22_last_start is only written with a read in progress (or by dht22_init)
+    now = timer_get_ticks();
+    if ((now - dht22_last_start) < (DHT22_MIN_INTERVAL_US - DHT22_INTERVAL_SLACK_US))
+    {
+        dht22_state = DHT22_IDLE;
+        return DHT22_RATE_ERROR;
+    }
+    dht22_last_start = now;
+
+    dht22_callback = callback;
+    dht22_callback_arg = arg;
+
+    // Pull the line low to send start signal, and release it from a timer: the
+    // output level is latched low first, so the pin drives low as it turns output
+    gpio_pin_clear(&dht22_pin);
+    gpio_pin_set_function(&dht22_pin, GPIO_OUTPUT);
+    if (timer_add(TIMER_ONESHOT, DHT22_START_US, dht22_release, 0) < 0)
+    {
+        gpio_pin_set_function(&dht22_pin, GPIO_INPUT);
+        dht22_state = DHT22_IDLE;
+        return DHT22_BUSY_ERROR;
+    }
+
+    return DHT22_OK;
+}
+
+/**
+ * @brief End of the start pulse (timer callback): starts the edge capture.
+ * 
+ * The line is driven high before edge detection is enabled, so the release is
+ * not captured; the first edge is the falling edge of the sensor response.
+ * 
+ * @param arg Unused.
+ */
+static void dht22_release(void *arg)
+{
+    (void)arg;
+
+    gpio_pin_set(&dht22_pin);
+    dht22_edge_count = 0;
+    GPIO->GPEDS[0] = dht22_pin.mask;
+    GPIO->GPREN[0] |= dht22_pin.mask;
+    GPIO->GPFEN[0] |= dht22_pin.mask;
+
+    // Hand the line to the sensor (pull-up keeps it high); it stays an input
+    // until the next start pulse
+    gpio_pin_set_function(&dht22_pin, GPIO_INPUT);
+    dht22_state = DHT22_CAPTURE;
+
+    if (timer_add(TIMER_ONESHOT, DHT22_FRAME_TIMEOUT_US, dht22_capture_done, 0) < 0)
+    {
+        // No timer to end the capture: end it now (reported as a timeout)
+        dht22_capture_done(0);
+    }
+}
+
+/**
+ * @brief Decodes the captured frame.
+ * 
+ * Bit i is high from edge 3 + 2i (rising) to edge 4 + 2i (falling); a high time
+ * above DHT22_BIT_THRESHOLD_US is a 1. The sensor sends 0.1 units: humidity as
+ * an unsigned value, temperature as a magnitude with the sign in bit 15.
+ * Values outside of the sensor range are rejected.
+ * 
+ * @param[out] result Decoded result.
+ */
+static void dht22_decode(struct dht22_result *result)
+{
+    uint32_t count = dht22_edge_count;
+    uint32_t i;
+
+    result->edges = count;
+    for (i = 0; i < 5; i++)
+    {
+        result->data[i] = 0;
+    }
 
-        // Verify the checksum
-        uint8_t checksum = data[0] + data[1] + data[2] + data[3];
-        if (checksum != data[4]) {
-            uart_printf("Checksum error: Expected %d, Got %d\n", checksum, data[4]);
-            continue; // Retry on checksum error
+    if (count < DHT22_FRAME_EDGES)
+    {
+        result->status = DHT22_TIMEOUT_ERROR;
+        return;
+    }
+
+    for (i = 0; i < 40; i++)
+    {
+        result->data[i / 8] <<= 1;
+        if ((dht22_edges[4 + 2 * i] - dht22_edges[3 + 2 * i]) > dht22_bit_ticks)
+        {
+            result->data[i / 8] |= 1;
         }
+    }
 
-        // Convert data to temperature and humidity
-        *humidity = ((data[0] << 8) | data[1]) / 10.0;
-        *temperature = ((data[2] & 0x7F) << 8 | data[3]) / 10.0;
-        if (data[2] & 0x80) {
-            *temperature *= -1.0; // Negative temperature
+    // Verify the checksum
+    uint8_t checksum = result->data[0] + result->data[1] + result->data[2] + result->data[3];
+    if (checksum != result->data[4])
+    {
+        result->status = DHT22_CHECKSUM_ERROR;
+        return;
+    }
+
+    // Convert data to temperature and humidity (fixed point, 0.1 units)
+    result->sample.timestamp = dht22_last_start;
+    result->sample.humidity = (uint16_t)((result->data[0] << 8) | result->data[1]);
+    result->sample.temperature = (int16_t)(((result->data[2] & 0x7F) << 8) | result->data[3]);
+    if (result->data[2] & 0x80)
+    {
+        result->sample.temperature = -result->sample.temperature; // Negative temperature
+    }
+
+    if ((result->sample.humidity > DHT22_HUM_MAX) ||
+        (result->sample.temperature < DHT22_TEMP_MIN) ||
+        (result->sample.temperature > DHT22_TEMP_MAX))
+    {
+        result->status = DHT22_RANGE_ERROR;
+        return;
+    }
+
+    result->status = DHT22_OK;
+}
+
+/**
+ * @brief Adds a valid sample to the history and refreshes the cached statistics.
+ * 
+ * The sums give the moving average in O(1); min/max are recomputed over the
+ * DHT22_HISTORY_SIZE entries, once per sample, so that queries stay O(1)
+ * (four samples at a time with NEON in FPU builds).
+ * 
+ * @param sample Valid sample.
+ */
+static void dht22_record(const struct dht22_sample *sample)
+{
+    struct dht22_stats *stats = &dht22_cached_stats;
+    struct dht22_sample *entry;
+    uint64_t flags;
+#if FPU
+    uint16_t minmax[4];
+#else
+    uint32_t i;
+#endif
+
+    flags = spin_lock_irqsave(&dht22_history_lock);
+
+    // A full window drops its oldest sample from the sums
+    entry = &dht22_history[dht22_history_head];
+    if (stats->count == DHT22_HISTORY_SIZE)
+    {
+        dht22_temp_sum -= entry->temperature;
+        dht22_hum_sum -= entry->humidity;
+    }
+    else
+    {
+        stats->count++;
+    }
+
+    *entry = *sample;
+    dht22_temp_sum += sample->temperature;
+    dht22_hum_sum += sample->humidity;
+    dht22_history_head = (dht22_history_head + 1) % DHT22_HISTORY_SIZE;
+
+    stats->temp_avg = (int16_t)(dht22_temp_sum / (int32_t)stats->count);
+    stats->hum_avg = (uint16_t)(dht22_hum_sum / stats->count);
+#if FPU
+    neon_sample_minmax(dht22_history, stats->count, minmax);
+    stats->temp_min = (int16_t)minmax[0];
+    stats->temp_max = (int16_t)minmax[1];
+    stats->hum_min = minmax[2];
+    stats->hum_max = minmax[3];
+#else
+    stats->temp_min = sample->temperature;
+    stats->temp_max = sample->temperature;
+    stats->hum_min = sample->humidity;
+    stats->hum_max = sample->humidity;
+    for (i = 0; i < stats->count; i++)
+    {
+        entry = &dht22_history[i];
+        if (entry->temperature < stats->temp_min)
+        {
+            stats->temp_min = entry->temperature;
+        }
+        if (entry->temperature > stats->temp_max)
+        {
+            stats->temp_max = entry->temperature;
+        }
+        if (entry->humidity < stats->hum_min)
+        {
+            stats->hum_min = entry->humidity;
         }
+        if (entry->humidity > stats->hum_max)
+        {
+            stats->hum_max = entry->humidity;
+        }
+    }
+#endif
+
+    spin_unlock_irqrestore(&dht22_history_lock, flags);
+}
+
+/**
+ * @brief End of the capture window (timer callback).
+ * 
+ * Stops edge detection, decodes the frame and completes the read: the callback
+ * is queued as deferred work, and dht22_read() waiters are woken.
+ * 
+ * @param arg Unused.
+ */
+static void dht22_capture_done(void *arg)
+{
+    (void)arg;
+
+    // Stop the capture; an edge interrupt already taken finds no event left
+    GPIO->GPREN[0] &= ~dht22_pin.mask;
+    GPIO->GPFEN[0] &= ~dht22_pin.mask;
+    GPIO->GPEDS[0] = dht22_pin.mask;
+
+    dht22_decode(&dht22_last);
+    if (dht22_last.status == DHT22_OK)
+    {
+        dht22_record(&dht22_last.sample);
+    }
+    smp_wmb();
+    dht22_state = DHT22_DONE;
+
+    if (dht22_callback == 0)
+    {
+        // Blocking read: the waiter takes the result
+        sched_send_event();
+        return;
+    }
+
+    if (deferred_work_schedule(&dht22_work) < 0)
+    {
+        // Work queue full: drop the result
+        dht22_state = DHT22_IDLE;
+    }
+}
+
+/**
+ * @brief Completion of an asynchronous read (deferred work).
+ * 
+ * The sensor stays busy until the callback returns, so the result is stable.
+ * 
+ * @param arg Unused.
+ */
+static void dht22_complete(void *arg)
+{
+    (void)arg;
+
+    dht22_callback(&dht22_last, dht22_callback_arg);
+    smp_mb();
+    dht22_state = DHT22_IDLE;
+}
+
+/**
+ * @brief Reads temperature and humidity from the DHT22 sensor.
+ * 
+ * This function sleeps until DHT22_MIN_INTERVAL_US has elapsed since the previous
+ * read, then starts a capture-based read and sleeps until its end (about 24ms).
+ * It must not be called from IRQ context. Consumers that only need a recent
+ * value should use dht22_get_latest() instead.
+ * 
+ * @param[out] sample Pointer to store the sample (0.1 °C, 0.1 %RH).
+ * 
+ * @return int Status code (DHT22_OK, DHT22_TIMEOUT_ERROR, DHT22_CHECKSUM_ERROR,
+ *             DHT22_RANGE_ERROR, DHT22_BUSY_ERROR).
+ */
+int dht22_read(struct dht22_sample *sample)
+{
+    int status;
+
+    PROF_SCOPE(PROF_PROBE_DHT22_READ);
+
+    // Respect the sensor's minimum interval
+    sleep_until(dht22_last_start + DHT22_MIN_INTERVAL_US);
+
+    status = dht22_read_async(0, 0);
+    if (status != DHT22_OK)
+    {
+        return status;
+    }
+
+    // Woken by dht22_capture_done()
+    while (dht22_state != DHT22_DONE)
+    {
+        sched_wait_event();
+    }
+    smp_rmb();
+
+    status = dht22_last.status;
+    if (status == DHT22_OK)
+    {
+        *sample = dht22_last.sample;
+    }
+
+    smp_mb();
+    dht22_state = DHT22_IDLE;
+
+    return status;
+}
+
+/**
+ * @brief Sampler timer callback: starts a read.
+ * 
+ * @param arg Unused.
+ */
+static void dht22_sampler_tick(void *arg)
+{
+    int status;
+
+    (void)arg;
+
+    status = dht22_read_async(dht22_sampler_done, 0);
+    if (status != DHT22_OK)
+    {
+        klog("DHT22 sample skipped: status %d\n", status);
+    }
+}
+
+/**
+ * @brief Completion of a sampler read: telemetry and failures.
+ * 
+ * The valid sample is already in the history (see dht22_capture_done()).
+ * 
+ * @param result Result of the read.
+ * @param arg    Unused.
+ */
+static void dht22_sampler_done(const struct dht22_result *result, void *arg)
+{
+    (void)arg;
+
+    if (result->status != DHT22_OK)
+    {
+        klog("DHT22 read failed: status %d, %d edges\n", result->status, result->edges);
+        return;
+    }
+
+    klog("DHT22: %.1f C, %.1f %%RH\n", result->sample.temperature, result->sample.humidity);
+}
+
+/**
+ * @brief Starts periodic sampling into the history.
+ * 
+ * Every read is started from a timer callback and costs a few interrupts.
+ * 
+ * @param period_us Sampling period (µs), raised to DHT22_MIN_INTERVAL_US if shorter.
+ * 
+ * @return int DHT22_OK, or DHT22_BUSY_ERROR if no timer is available.
+ */
+int dht22_sampler_start(uint32_t period_us)
+{
+    if (period_us < DHT22_MIN_INTERVAL_US)
+    {
+        period_us = DHT22_MIN_INTERVAL_US;
+    }
+
+    return (timer_add(TIMER_PERIODIC, period_us, dht22_sampler_tick, 0) < 0) ? DHT22_BUSY_ERROR : DHT22_OK;
+}
+
+/**
+ * @brief Returns the latest valid sample without a bus transaction.
+ * 
+ * @param[out] sample Pointer to store the sample.
+ * 
+ * @return int DHT22_OK, or DHT22_NO_DATA if no valid sample was recorded yet.
+ */
+int dht22_get_latest(struct dht22_sample *sample)
+{
+    int status = DHT22_NO_DATA;
+    uint64_t flags;
+
+    flags = spin_lock_irqsave(&dht22_history_lock);
+    if (dht22_cached_stats.count > 0)
+    {
+        *sample = dht22_history[(dht22_history_head + DHT22_HISTORY_SIZE - 1) % DHT22_HISTORY_SIZE];
+        status = DHT22_OK;
+    }
+    spin_unlock_irqrestore(&dht22_history_lock, flags);
+
+    return status;
+}
+
+/**
+ * @brief Returns the moving statistics over the last DHT22_HISTORY_SIZE samples.
+ * 
+ * @param[out] stats Pointer to store the statistics.
+ * 
+ * @return int DHT22_OK, or DHT22_NO_DATA if no valid sample was recorded yet.
+ */
+int dht22_get_stats(struct dht22_stats *stats)
+{
+    int status = DHT22_NO_DATA;
+    uint64_t flags;
 
-        return DHT22_OK; // Success
+    flags = spin_lock_irqsave(&dht22_history_lock);
+    if (dht22_cached_stats.count > 0)
+    {
+        *stats = dht22_cached_stats;
+        status = DHT22_OK;
     }
+    spin_unlock_irqrestore(&dht22_history_lock, flags);
 
-    return DHT22_TIMEOUT_ERROR; // Failed after retries
+    return status;
 }
@@ -0,0 +1,604 @@
+/**
+ * @file        dma.c
+ * @brief       DMA controller driver for the BCM2837.
+ * @description This source file implements channel allocation, control-block chains,
+ *              completion interrupts and the memory and peripheral transfers built on
+ *              them. The engine does not snoop the ARM caches: buffers are cleaned
+ *              before a transfer reads them and invalidated after it wrote them.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "dma.h"
+#include <stdint.h>
+#include "atomic.h"
+#include "irq.h"
+#include "mm.h"
+#include "spinlock.h"
+#include "utils.h"
+#include "sched.h"
+#include "sections.h"
+
+/**
+ * @brief State of a DMA channel.
+ */
+struct dma_chan {
+    struct DMA_Channel_Registers *regs;     // Channel registers
+    dma_callback_t callback;                // Completion callback of the running transfer
+    void *arg;                              // Its argument
+    uint64_t inval_start;                   // Range invalidated on completion (0: none)
+    uint32_t inval_len;
+    volatile int status;                    // DMA_PENDING while running
+    uint8_t allocated;                      // Owned by a dma_channel_alloc() caller
+};
+
+static struct dma_chan dma_chans[DMA_NR_CHANNELS];
+
+// Control blocks of the memory and FIFO transfers, one chain per channel
+static struct dma_cb dma_chains[DMA_NR_CHANNELS][DMA_CHAIN_MAX];
+
+// Fill pattern of dma_memset(), one per channel (read again and again by the engine)
+static uint32_t dma_patterns[DMA_NR_CHANNELS][8] __attribute__((aligned(32)));
+
+// Protects allocation and completion
+static spinlock_t dma_lock = SPINLOCK_INIT;
+
+static uint8_t dma_ready;
+
+// Function prototypes
+static struct dma_chan *dma_get_chan(int channel);
+static uint32_t dma_chain_fill(int channel, uint32_t ti, uint32_t source, uint32_t dest, uint32_t n);
+static int dma_run(int channel, uint32_t ti, uint32_t source, uint32_t dest, uint32_t n);
+static void dma_complete(int channel);
+
+/**
+ * @brief Initializes the DMA driver.
+ * 
+ * Resets the channels of DMA_CHANNEL_MASK, enables them and registers their
+ * interrupts.
+ */
+SECTION_INIT void dma_init(void)
+{
+    struct DMA_Channel_Registers *regs;
+    uint32_t i;
+
+    if (dma_ready)
+    {
+        return;
+    }
+
+    for (i = 0; i < DMA_NR_CHANNELS; i++)
+    {
+        dma_chans[i].regs = DMA_CHANNEL(i);
+        dma_chans[i].status = DMA_OK;
+        if (!(DMA_CHANNEL_MASK & (1 << i)))
+        {
+            continue;
+        }
+
+        regs = dma_chans[i].regs;
+        regs->CS = DMA_CS_RESET;                    // Stop and reset the channel
+        regs->CS = DMA_CS_END | DMA_CS_INT;         // Clear the status flags
+        regs->DEBUG = DMA_DEBUG_ERRORS;             // Clear the error flags
+
+        irq_register(IRQ_DMA(i), handle_dma_irq, IRQ_PRIO_NORMAL);
+    }
+
+    *DMA_ENABLE |= DMA_CHANNEL_MASK;                // Enable our channels in the engine
+    dma_ready = 1;
+}
+
+/**
+ * @brief Converts an ARM address into the bus address seen by the DMA engine.
+ * 
+ * @param addr ARM physical address (RAM or peripheral).
+ * @return     Bus address.
+ */
+uint32_t dma_bus_addr(const volatile void *addr)
+{
+    uint64_t a = (uint64_t)addr;
+
+    if ((a >= PIBASE) && (a < LOCAL_PIBASE))
+    {
+        return (uint32_t)(a - PIBASE) + DMA_BUS_PERIPHERAL;
+    }
+    return (uint32_t)a | DMA_BUS_RAM;
+}
+
+/**
+ * @brief Returns the state of an allocated channel.
+ * 
+ * @param channel The channel.
+ * @return        The channel, or NULL if it is invalid or not allocated.
+ */
+static struct dma_chan *dma_get_chan(int channel)
+{
+    if ((channel < 0) || (channel >= DMA_NR_CHANNELS) || !dma_chans[channel].allocated)
+    {
+        return 0;
+    }
+    return &dma_chans[channel];
+}
+
+/**
+ * @brief Allocates a DMA channel.
+ * 
+ * Full channels are handed out first.
+ * 
+ * @return The channel number, or DMA_EBUSY if none is free.
+ */
+int dma_channel_alloc(void)
+{
+    uint64_t flags;
+    int i;
+
+    if (!dma_ready)
+    {
+        return DMA_EBUSY;
+    }
+
+    flags = spin_lock_irqsave(&dma_lock);
+    for (i = 0; i < DMA_NR_CHANNELS; i++)
+    {
+        if ((DMA_CHANNEL_MASK & (1 << i)) && !dma_chans[i].allocated)
+        {
+            dma_chans[i].allocated = 1;
+            spin_unlock_irqrestore(&dma_lock, flags);
+            return i;
+        }
+    }
+    spin_unlock_irqrestore(&dma_lock, flags);
+
+    return DMA_EBUSY;
+}
+
+/**
+ * @brief Releases a channel from dma_channel_alloc().
+ * 
+ * @param channel The channel; must not be running.
+ */
+void dma_channel_free(int channel)
+{
+    struct dma_chan *chan = dma_get_chan(channel);
+    uint64_t flags;
+
+    if (chan == 0)
+    {
+        return;
+    }
+
+    flags = spin_lock_irqsave(&dma_lock);
+    chan->allocated = 0;
+    spin_unlock_irqrestore(&dma_lock, flags);
+}
+
+/**
+ * @brief Starts a control-block chain on a channel.
+ * 
+ * The control blocks are cleaned from the data cache first (the walk stops at the
+ * end of the chain or when it loops back to the first block); the data buffers are
+ * the caller's responsibility.
+ * 
+ * @param channel  An allocated channel.
+ * @param cb       First control block of the chain.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL, or DMA_EBUSY if the channel is running.
+ */
+int dma_start(int channel, struct dma_cb *cb, dma_callback_t callback, void *arg)
+{
+    struct dma_chan *chan = dma_get_chan(channel);
+    struct DMA_Channel_Registers *regs;
+    struct dma_cb *next;
+    uint32_t first;
+
+    // The engine ignores the low 5 bits of CONBLK_AD
+    if ((chan == 0) || (cb == 0) || ((uint64_t)cb & 0x1F))
+    {
+        return DMA_EINVAL;
+    }
+    if (chan->status == DMA_PENDING)
+    {
+        return DMA_EBUSY;
+    }
+
+    // The engine reads the chain from memory, not from the cache
+    first = dma_bus_addr(cb);
+    next = cb;
+    do
+    {
+        dcache_clean_range((uint64_t)next, sizeof(*next));
+        next = (struct dma_cb *)(uint64_t)(next->nextconbk & ~DMA_BUS_RAM);
+    } while (next && (dma_bus_addr(next) != first));
+
+    chan->callback = callback;
+    chan->arg = arg;
+    chan->status = DMA_PENDING;
+
+    regs = chan->regs;
+    regs->CS = DMA_CS_END | DMA_CS_INT;             // Clear the previous completion
+    regs->DEBUG = DMA_DEBUG_ERRORS;                 // Clear the error flags
+    regs->CONBLK_AD = first;                        // First control block
+    regs->CS = DMA_CS_ACTIVE | DMA_CS_PRIORITY(8) | DMA_CS_PANIC_PRIORITY(15) |
+               DMA_CS_WAIT_FOR_OUTSTANDING_WRITES;  // Start
+
+    return DMA_OK;
+}
+
+/**
+ * @brief Completes the transfer of a channel.
+ * 
+ * Called from the interrupt, or by dma_wait() when interrupts cannot be taken.
+ * Nothing happens while the chain is still running.
+ * 
+ * @param channel The channel.
+ */
+static void dma_complete(int channel)
+{
+    struct dma_chan *chan = &dma_chans[channel];
+    struct DMA_Channel_Registers *regs = chan->regs;
+    dma_callback_t callback;
+    void *arg;
+    uint64_t flags;
+    uint32_t cs;
+    int status;
+
+    flags = spin_lock_irqsave(&dma_lock);
+
+    cs = regs->CS;
+    if ((cs & DMA_CS_ACTIVE) && !(cs & DMA_CS_ERROR))
+    {
+        // An intermediate block of the chain: writing CS would pause the channel
+        if (cs & DMA_CS_INT)
+        {
+            regs->CS = DMA_CS_INT | DMA_CS_ACTIVE;  // Acknowledge, keep running
+        }
+        spin_unlock_irqrestore(&dma_lock, flags);
+        return;
+    }
+    regs->CS = DMA_CS_INT | (cs & DMA_CS_ACTIVE);   // Acknowledge the interrupt
+    if (chan->status != DMA_PENDING)
+    {
+        // Not ours
+        spin_unlock_irqrestore(&dma_lock, flags);
+        return;
+    }
+
+    if (cs & DMA_CS_ERROR)
+    {
+        status = DMA_EBUS;
+        regs->DEBUG = DMA_DEBUG_ERRORS;             // Clear the error flags
+        regs->CS = DMA_CS_RESET;                    // Drop the rest of the chain
+    }
+    else
+    {
+        status = DMA_OK;
+    }
+    regs->CS = DMA_CS_END;                          // Clear END
+
+    // The CPU must not see stale lines of what the engine wrote
+    if (chan->inval_len)
+    {
+        dcache_invalidate_range(chan->inval_start, chan->inval_len);
+        chan->inval_len = 0;
+    }
+
+    callback = chan->callback;
+    arg = chan->arg;
+    smp_wmb();
+    chan->status = status;                          // The channel may be reused from here
+    spin_unlock_irqrestore(&dma_lock, flags);
+
+    if (callback)
+    {
+        callback(channel, status, arg);
+    }
+    // Wake waiters: tasks, or WFE sleepers possibly on another core
+    sched_send_event();
+}
+
+/**
+ * @brief DMA interrupt handler: completes the transfers of the signalling channels.
+ */
+SECTION_HOT void handle_dma_irq(void)
+{
+    uint32_t pending = *DMA_INT_STATUS & DMA_CHANNEL_MASK;
+    uint32_t channel;
+
+    while (pending)
+    {
+        channel = 31 - __builtin_clz(pending);
+        pending &= ~(1U << channel);
+        dma_complete(channel);
+    }
+}
+
+/**
+ * @brief Waits for the transfer of a channel to complete.
+ * 
+ * Sleeps in sched_wait_event() (WFE outside of tasks) until the completion
+ * interrupt; in IRQ context or with IRQs masked
+ * the interrupt cannot be taken, so the channel is polled.
+ * 
+ * @param channel The channel.
+ * @return        DMA_OK or DMA_EBUS.
+ */
+int dma_wait(int channel)
+{
+    struct dma_chan *chan = dma_get_chan(channel);
+
+    if (chan == 0)
+    {
+        return DMA_EINVAL;
+    }
+
+    while (chan->status == DMA_PENDING)
+    {
+        if (irq_in_handler() || irq_masked())
+        {
+            // Poll fallback
+            dma_complete(channel);
+        }
+        else
+        {
+            sched_wait_event();
+        }
+    }
+
+    return chan->status;
+}
+
+/**
+ * @brief Fills the chain of a channel for a linear transfer.
+ * 
+ * Splits the transfer into control blocks of at most the channel's maximum length;
+ * only the last one interrupts.
+ * 
+ * @param channel The channel.
+ * @param ti      Transfer information; DMA_TI_SRC_INC/DEST_INC advance the addresses.
+ * @param source  Source bus address.
+ * @param dest    Destination bus address.
+ * @param n       Number of bytes.
+ * @return        Number of bytes covered by the chain (at most DMA_CHAIN_MAX blocks).
+ */
+static uint32_t dma_chain_fill(int channel, uint32_t ti, uint32_t source, uint32_t dest, uint32_t n)
+{
+    struct dma_cb *cb = dma_chains[channel];
+    uint32_t max = (channel >= DMA_LITE_FIRST) ? DMA_LITE_MAX_LEN : DMA_MAX_LEN;
+    uint32_t covered = 0;
+    uint32_t len;
+    uint32_t i;
+
+    for (i = 0; (i < DMA_CHAIN_MAX) && (covered < n); i++)
+    {
+        len = ((n - covered) > max) ? max : (n - covered);
+
+        cb[i].ti = ti;
+        cb[i].source_ad = source;
+        cb[i].dest_ad = dest;
+        cb[i].txfr_len = len;
+        cb[i].stride = 0;
+        cb[i].nextconbk = 0;
+        if (i > 0)
+        {
+            cb[i - 1].nextconbk = dma_bus_addr(&cb[i]);
+        }
+
+        if (ti & DMA_TI_SRC_INC)
+        {
+            source += len;
+        }
+        if (ti & DMA_TI_DEST_INC)
+        {
+            dest += len;
+        }
+        covered += len;
+    }
+    cb[i - 1].ti |= DMA_TI_INTEN;
+
+    return covered;
+}
+
+/**
+ * @brief Runs a linear memory transfer and waits for it.
+ * 
+ * @param channel An allocated channel.
+ * @param ti      Transfer information.
+ * @param source  Source bus address.
+ * @param dest    Destination bus address.
+ * @param n       Number of bytes.
+ * @return        DMA_OK or DMA_EBUS.
+ */
+static int dma_run(int channel, uint32_t ti, uint32_t source, uint32_t dest, uint32_t n)
+{
+    uint32_t done;
+    int status = DMA_OK;
+
+    // One chain at a time; large transfers take several rounds
+    while (n && (status == DMA_OK))
+    {
+        done = dma_chain_fill(channel, ti, source, dest, n);
+        status = dma_start(channel, dma_chains[channel], 0, 0);
+        if (status == DMA_OK)
+        {
+            status = dma_wait(channel);
+        }
+
+        if (ti & DMA_TI_SRC_INC)
+        {
+            source += done;
+        }
+        dest += done;
+        n -= done;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Copies memory with the DMA engine.
+ * 
+ * @param dst Destination.
+ * @param src Source.
+ * @param n   Number of bytes.
+ * 
+ * @return DMA_OK, DMA_EBUSY if no channel is free, or DMA_EBUS.
+ */
+int dma_memcpy(void *dst, const void *src, uint32_t n)
+{
+    int channel;
+    int status;
+
+    if (n == 0)
+    {
+        return DMA_OK;
+    }
+
+    channel = dma_channel_alloc();
+    if (channel < 0)
+    {
+        return channel;
+    }
+
+    // Source to memory; destination written back (no dirty line may land over the copy)
+    dcache_clean_range((uint64_t)src, n);
+    dcache_clean_invalidate_range((uint64_t)dst, n);
+
+    status = dma_run(channel, DMA_TI_SRC_INC | DMA_TI_DEST_INC | DMA_TI_WAIT_RESP,
+                     dma_bus_addr(src), dma_bus_addr(dst), n);
+
+    // Invalidated once, after the last round
+    dcache_invalidate_range((uint64_t)dst, n);
+
+    dma_channel_free(channel);
+    return status;
+}
+
+/**
+ * @brief Fills memory with the DMA engine.
+ * 
+ * The engine reads a 32-byte pattern without incrementing the source and writes
+ * it with 128-bit bursts.
+ * 
+ * @param dst   Destination.
+ * @param value Byte value to store.
+ * @param n     Number of bytes.
+ * 
+ * @return DMA_OK, DMA_EBUSY if no channel is free, or DMA_EBUS.
+ */
+int dma_memset(void *dst, uint8_t value, uint32_t n)
+{
+    uint32_t word = value * 0x01010101U;
+    uint32_t i;
+    int channel;
+    int status;
+
+    if (n == 0)
+    {
+        return DMA_OK;
+    }
+
+    channel = dma_channel_alloc();
+    if (channel < 0)
+    {
+        return channel;
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        dma_patterns[channel][i] = word;
+    }
+    dcache_clean_range((uint64_t)dma_patterns[channel], sizeof(dma_patterns[channel]));
+    dcache_clean_invalidate_range((uint64_t)dst, n);
+
+    status = dma_run(channel, DMA_TI_DEST_INC | DMA_TI_SRC_WIDTH | DMA_TI_DEST_WIDTH | DMA_TI_WAIT_RESP,
+                     dma_bus_addr(dma_patterns[channel]), dma_bus_addr(dst), n);
+
+    dcache_invalidate_range((uint64_t)dst, n);
+
+    dma_channel_free(channel);
+    return status;
+}
+
+/**
+ * @brief Writes a buffer to a peripheral FIFO, paced by its DREQ.
+ * 
+ * Every FIFO access is a 32-bit word: the buffer holds one FIFO entry per word.
+ * 
+ * @param channel  An allocated channel.
+ * @param fifo     ARM address of the FIFO register.
+ * @param src      Data to write, kept untouched until completion.
+ * @param n        Number of bytes, a multiple of 4 (one chain: DMA_CHAIN_MAX blocks).
+ * @param dreq     DMA_DREQ_* of the peripheral.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL or DMA_EBUSY.
+ */
+int dma_fifo_write(int channel, volatile uint32_t *fifo, const void *src, uint32_t n,
+                   uint8_t dreq, dma_callback_t callback, void *arg)
+{
+    struct dma_chan *chan = dma_get_chan(channel);
+    uint32_t ti = DMA_TI_SRC_INC | DMA_TI_DEST_DREQ | DMA_TI_PERMAP(dreq) | DMA_TI_WAIT_RESP;
+
+    if ((chan == 0) || (n == 0) || (n & 3) || (dreq == DMA_DREQ_NONE))
+    {
+        return DMA_EINVAL;
+    }
+    if (chan->status == DMA_PENDING)
+    {
+        return DMA_EBUSY;
+    }
+    if (dma_chain_fill(channel, ti, dma_bus_addr(src), dma_bus_addr(fifo), n) != n)
+    {
+        return DMA_EINVAL;
+    }
+
+    dcache_clean_range((uint64_t)src, n);
+    chan->inval_len = 0;
+
+    return dma_start(channel, dma_chains[channel], callback, arg);
+}
+
+/**
+ * @brief Reads a peripheral FIFO into a buffer, paced by its DREQ.
+ * 
+ * Every FIFO access is a 32-bit word: the buffer receives one FIFO entry per word.
+ * 
+ * @param channel  An allocated channel.
+ * @param fifo     ARM address of the FIFO register.
+ * @param dst      Destination buffer.
+ * @param n        Number of bytes, a multiple of 4 (one chain: DMA_CHAIN_MAX blocks).
+ * @param dreq     DMA_DREQ_* of the peripheral.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL or DMA_EBUSY.
+ */
+int dma_fifo_read(int channel, volatile uint32_t *fifo, void *dst, uint32_t n,
+                  uint8_t dreq, dma_callback_t callback, void *arg)
+{
+    struct dma_chan *chan = dma_get_chan(channel);
+    uint32_t ti = DMA_TI_DEST_INC | DMA_TI_SRC_DREQ | DMA_TI_PERMAP(dreq) | DMA_TI_WAIT_RESP;
+
+    if ((chan == 0) || (n == 0) || (n & 3) || (dreq == DMA_DREQ_NONE))
+    {
+        return DMA_EINVAL;
+    }
+    if (chan->status == DMA_PENDING)
+    {
+        return DMA_EBUSY;
+    }
+    if (dma_chain_fill(channel, ti, dma_bus_addr(fifo), dma_bus_addr(dst), n) != n)
+    {
+        return DMA_EINVAL;
+    }
+
+    dcache_clean_invalidate_range((uint64_t)dst, n);
+    chan->inval_start = (uint64_t)dst;
+    chan->inval_len = n;
+
+    return dma_start(channel, dma_chains[channel], callback, arg);
+}
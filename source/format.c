@@ -0,0 +1,583 @@
+/**
+ * @file        format.c
+ * @brief       Integer, hexadecimal and fixed-point formatting core.
+ * @description This file implements the conversion kernels and the printf-style
+ *              engine declared in format.h. The engine reads its arguments either
+ *              from a `va_list` or from an array of raw 64-bit values, and hands
+ *              the output to a callback in runs (literal text, padded fields).
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "format.h"
+
+// Flags of a conversion
+#define FORMAT_FLAG_LEFT        0x01    // '-': left align in the field
+#define FORMAT_FLAG_ZERO        0x02    // '0': pad numbers with zeros
+#define FORMAT_FLAG_LONG        0x04    // 'l', 'll', 'z': 64-bit argument
+#define FORMAT_FLAG_PREC        0x08    // A precision was given
+
+/**
+ * @brief Source of the arguments of a format string.
+ */
+struct format_args {
+    va_list *ap;                // Variable argument list, or NULL
+    const uint64_t *raw;        // Raw 64-bit arguments when ap is NULL
+    uint32_t nargs;             // Number of raw arguments
+    uint32_t idx;               // Next raw argument
+};
+
+/**
+ * @brief Output context of format_vsnprintf.
+ */
+struct format_buffer {
+    char *buf;                  // Destination
+    uint32_t size;              // Size of the destination
+    uint32_t len;               // Characters stored so far
+};
+
+// "00" to "99", used to emit two decimal digits per step
+static const char format_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Hexadecimal digits, lowercase then uppercase
+static const char format_hex_digits[2][16] = {
+    { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' },
+    { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' }
+};
+
+// 10^n for the fixed-point conversion
+static const uint64_t format_pow10[FORMAT_FIXED_MAX_PREC + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL
+};
+
+static uint64_t format_next_int(struct format_args *args, uint8_t flags, uint8_t is_signed);
+static const char *format_next_ptr(struct format_args *args);
+static void format_pad(format_out_t out, void *ctx, char c, uint32_t count);
+static uint32_t format_field(format_out_t out, void *ctx, const char *s, uint32_t len, uint32_t prefix, uint32_t width, uint8_t flags);
+static uint32_t format_run(format_out_t out, void *ctx, const char *format, struct format_args *args);
+static void format_buffer_out(void *ctx, const char *s, uint32_t len);
+
+/**
+ * @brief Writes the decimal representation of an unsigned value.
+ * 
+ * @param buf   Destination, at least FORMAT_DEC_MAX characters.
+ * @param value Value to convert.
+ * 
+ * @return The number of characters written.
+ */
+uint32_t format_udec(char *buf, uint64_t value)
+{
+    char tmp[FORMAT_DEC_MAX];
+    uint32_t pos = FORMAT_DEC_MAX;
+    uint32_t len;
+    uint32_t pair;
+    uint32_t i;
+
+    // Two digits per step: the division by a constant compiles to a multiply.
+    while (value >= 100)
+    {
+        pair = (uint32_t)(value % 100) * 2;
+        value /= 100;
+        pos -= 2;
+        tmp[pos] = format_digit_pairs[pair];
+        tmp[pos + 1] = format_digit_pairs[pair + 1];
+    }
+
+    // Last one or two digits.
+    if (value >= 10)
+    {
+        pair = (uint32_t)value * 2;
+        pos -= 2;
+        tmp[pos] = format_digit_pairs[pair];
+        tmp[pos + 1] = format_digit_pairs[pair + 1];
+    }
+    else
+    {
+        tmp[--pos] = (char)('0' + value);
+    }
+
+    // The digits were produced from the end of tmp.
+    len = FORMAT_DEC_MAX - pos;
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = tmp[pos + i];
+    }
+
+    return len;
+}
+
+/**
+ * @brief Writes the hexadecimal representation of an unsigned value.
+ * 
+ * @param buf       Destination, at least FORMAT_HEX_MAX characters.
+ * @param value     Value to convert.
+ * @param uppercase Non-zero for `A-F`, zero for `a-f`.
+ * 
+ * @return The number of characters written.
+ */
+uint32_t format_hex(char *buf, uint64_t value, uint8_t uppercase)
+{
+    const char *digits = format_hex_digits[uppercase ? 1 : 0];
+    uint32_t len;
+    uint32_t i;
+
+    // Number of significant nibbles (at least one for 0).
+    len = (64 - __builtin_clzll(value | 1) + 3) / 4;
+
+    // Fill from the least significant nibble.
+    for (i = len; i > 0; i--)
+    {
+        buf[i - 1] = digits[value & 0xF];
+        value >>= 4;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Writes a fixed-point value.
+ * 
+ * @param buf       Destination, at least FORMAT_FIXED_MAX characters.
+ * @param value     Value multiplied by 10^precision.
+ * @param precision Number of fractional digits.
+ * 
+ * @return The number of characters written.
+ */
+uint32_t format_fixed(char *buf, int64_t value, uint32_t precision)
+{
+    uint64_t magnitude;
+    uint64_t frac;
+    uint32_t len = 0;
+    uint32_t i;
+
+    if (precision > FORMAT_FIXED_MAX_PREC)
+    {
+        precision = FORMAT_FIXED_MAX_PREC;
+    }
+
+    // Work on the magnitude (also correct for INT64_MIN).
+    if (value < 0)
+    {
+        buf[len++] = '-';
+        magnitude = 0 - (uint64_t)value;
+    }
+    else
+    {
+        magnitude = (uint64_t)value;
+    }
+
+    if (precision == 0)
+    {
+        return len + format_udec(&buf[len], magnitude);
+    }
+
+    // Integer part, decimal point, then the fraction zero-padded to `precision` digits.
+    frac = magnitude % format_pow10[precision];
+    len += format_udec(&buf[len], magnitude / format_pow10[precision]);
+    buf[len++] = '.';
+    for (i = precision; i > 0; i--)
+    {
+        buf[len + i - 1] = (char)('0' + (frac % 10));
+        frac /= 10;
+    }
+
+    return len + precision;
+}
+
+/**
+ * @brief Fetches the next integer argument.
+ * 
+ * 32-bit arguments are sign- or zero-extended according to the conversion.
+ * 
+ * @param args      Argument source.
+ * @param flags     Conversion flags (FORMAT_FLAG_LONG selects 64-bit arguments).
+ * @param is_signed Non-zero for signed conversions.
+ * 
+ * @return The argument as a 64-bit value.
+ */
+static uint64_t format_next_int(struct format_args *args, uint8_t flags, uint8_t is_signed)
+{
+    uint64_t value;
+
+    if (args->ap != 0)
+    {
+        if (flags & FORMAT_FLAG_LONG)
+        {
+            return va_arg(*args->ap, unsigned long long);
+        }
+
+        if (is_signed)
+        {
+            return (uint64_t)(int64_t)va_arg(*args->ap, int);
+        }
+
+        return va_arg(*args->ap, unsigned int);
+    }
+
+    // Raw arguments: missing ones read as 0.
+    value = (args->idx < args->nargs) ? args->raw[args->idx++] : 0;
+
+    if (flags & FORMAT_FLAG_LONG)
+    {
+        return value;
+    }
+
+    return is_signed ? (uint64_t)(int64_t)(int32_t)value : (uint64_t)(uint32_t)value;
+}
+
+/**
+ * @brief Fetches the next pointer argument.
+ * 
+ * @param args Argument source.
+ * 
+ * @return The argument as a pointer.
+ */
+static const char *format_next_ptr(struct format_args *args)
+{
+    if (args->ap != 0)
+    {
+        return va_arg(*args->ap, const char *);
+    }
+
+    return (args->idx < args->nargs) ? (const char *)(uintptr_t)args->raw[args->idx++] : 0;
+}
+
+/**
+ * @brief Outputs `count` copies of a padding character.
+ * 
+ * @param out   Output callback.
+ * @param ctx   Callback context.
+ * @param c     Padding character.
+ * @param count Number of characters.
+ */
+static void format_pad(format_out_t out, void *ctx, char c, uint32_t count)
+{
+    char pad[16];
+    uint32_t chunk;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(pad); i++)
+    {
+        pad[i] = c;
+    }
+
+    // Emit the padding in runs rather than one callback per character.
+    while (count > 0)
+    {
+        chunk = (count > sizeof(pad)) ? sizeof(pad) : count;
+        out(ctx, pad, chunk);
+        count -= chunk;
+    }
+}
+
+/**
+ * @brief Outputs a converted field with its padding.
+ * 
+ * With zero padding, the zeros go after the first `prefix` characters (the sign).
+ * 
+ * @param out    Output callback.
+ * @param ctx    Callback context.
+ * @param s      Converted characters.
+ * @param len    Number of converted characters.
+ * @param prefix Number of leading sign characters in `s`.
+ * @param width  Minimum field width.
+ * @param flags  Conversion flags.
+ * 
+ * @return The number of characters produced.
+ */
+static uint32_t format_field(format_out_t out, void *ctx, const char *s, uint32_t len, uint32_t prefix, uint32_t width, uint8_t flags)
+{
+    uint32_t pad = (width > len) ? (width - len) : 0;
+
+    if (flags & FORMAT_FLAG_LEFT)
+    {
+        out(ctx, s, len);
+        format_pad(out, ctx, ' ', pad);
+    }
+    else if (flags & FORMAT_FLAG_ZERO)
+    {
+        out(ctx, s, prefix);
+        format_pad(out, ctx, '0', pad);
+        out(ctx, s + prefix, len - prefix);
+    }
+    else
+    {
+        format_pad(out, ctx, ' ', pad);
+        out(ctx, s, len);
+    }
+
+    return len + pad;
+}
+
+/**
+ * @brief Formatting engine shared by all the entry points.
+ * 
+ * @param out    Output callback.
+ * @param ctx    Callback context.
+ * @param format Format string.
+ * @param args   Argument source.
+ * 
+ * @return The number of characters produced.
+ */
+static uint32_t format_run(format_out_t out, void *ctx, const char *format, struct format_args *args)
+{
+    char tmp[FORMAT_FIXED_MAX];
+    const char *run;
+    const char *s;
+    uint32_t total = 0;
+    uint32_t width;
+    uint32_t precision;
+    uint32_t len;
+    uint32_t prefix;
+    uint64_t value;
+    uint8_t flags;
+
+    while (*format)
+    {
+        // Literal text up to the next conversion, in one run.
+        run = format;
+        while (*format && (*format != '%'))
+        {
+            format++;
+        }
+        if (format != run)
+        {
+            out(ctx, run, (uint32_t)(format - run));
+            total += (uint32_t)(format - run);
+        }
+        if (*format == '\0')
+        {
+            break;
+        }
+        format++;
+
+        // Flags.
+        flags = 0;
+        while ((*format == '-') || (*format == '0'))
+        {
+            flags |= (*format == '-') ? FORMAT_FLAG_LEFT : FORMAT_FLAG_ZERO;
+            format++;
+        }
+
+        // Field width.
+        width = 0;
+        while ((*format >= '0') && (*format <= '9'))
+        {
+            width = width * 10 + (uint32_t)(*format++ - '0');
+        }
+
+        // Precision.
+        precision = 0;
+        if (*format == '.')
+        {
+            flags |= FORMAT_FLAG_PREC;
+            format++;
+            while ((*format >= '0') && (*format <= '9'))
+            {
+                precision = precision * 10 + (uint32_t)(*format++ - '0');
+            }
+        }
+
+        // Length modifiers: every integer is at most 64 bits on AArch64.
+        while ((*format == 'l') || (*format == 'z') || (*format == 'h'))
+        {
+            if (*format != 'h')
+            {
+                flags |= FORMAT_FLAG_LONG;
+            }
+            format++;
+        }
+
+        prefix = 0;
+        switch (*format)
+        {
+            case 'c':
+                tmp[0] = (char)format_next_int(args, flags, 0);
+                total += format_field(out, ctx, tmp, 1, 0, width, flags & ~FORMAT_FLAG_ZERO);
+                break;
+
+            case 'd':
+            case 'i':
+                value = format_next_int(args, flags, 1);
+                if ((int64_t)value < 0)
+                {
+                    tmp[0] = '-';
+                    prefix = 1;
+                    value = 0 - value;
+                }
+                len = prefix + format_udec(&tmp[prefix], value);
+                total += format_field(out, ctx, tmp, len, prefix, width, flags);
+                break;
+
+            case 'u':
+                value = format_next_int(args, flags, 0);
+                len = format_udec(tmp, value);
+                total += format_field(out, ctx, tmp, len, 0, width, flags);
+                break;
+
+            case 'x':
+            case 'X':
+                value = format_next_int(args, flags, 0);
+                len = format_hex(tmp, value, *format == 'X');
+                total += format_field(out, ctx, tmp, len, 0, width, flags);
+                break;
+
+            case 'p':
+                value = (uint64_t)(uintptr_t)format_next_ptr(args);
+                tmp[0] = '0';
+                tmp[1] = 'x';
+                len = 2 + format_hex(&tmp[2], value, 0);
+                total += format_field(out, ctx, tmp, len, 2, width, flags);
+                break;
+
+            case 'f':
+                value = format_next_int(args, flags, 1);
+                len = format_fixed(tmp, (int64_t)value, precision);
+                prefix = (tmp[0] == '-') ? 1 : 0;
+                total += format_field(out, ctx, tmp, len, prefix, width, flags);
+                break;
+
+            case 's':
+                s = format_next_ptr(args);
+                if (s == 0)
+                {
+                    s = "(null)";
+                }
+                // The precision limits the number of characters printed.
+                len = 0;
+                while (s[len] && (!(flags & FORMAT_FLAG_PREC) || (len < precision)))
+                {
+                    len++;
+                }
+                total += format_field(out, ctx, s, len, 0, width, flags & ~FORMAT_FLAG_ZERO);
+                break;
+
+            case '%':
+                out(ctx, "%", 1);
+                total++;
+                break;
+
+            case '\0':
+                // Lone '%' at the end of the string.
+                return total;
+
+            default:
+                // Unsupported conversion: print it as is.
+                tmp[0] = '%';
+                tmp[1] = *format;
+                out(ctx, tmp, 2);
+                total += 2;
+                break;
+        }
+
+        format++;
+    }
+
+    return total;
+}
+
+/**
+ * @brief Formats a string with a variable argument list.
+ */
+uint32_t format_vformat(format_out_t out, void *ctx, const char *format, va_list ap)
+{
+    struct format_args args;
+    uint32_t total;
+    va_list aq;
+
+    // Work on a copy so the engine can take its address on every ABI.
+    va_copy(aq, ap);
+    args.ap = &aq;
+    args.raw = 0;
+    args.nargs = 0;
+    args.idx = 0;
+    total = format_run(out, ctx, format, &args);
+    va_end(aq);
+
+    return total;
+}
+
+/**
+ * @brief Formats a string with raw 64-bit arguments.
+ */
+uint32_t format_rawformat(format_out_t out, void *ctx, const char *format, const uint64_t *raw, uint32_t nargs)
+{
+    struct format_args args;
+
+    args.ap = 0;
+    args.raw = raw;
+    args.nargs = nargs;
+    args.idx = 0;
+
+    return format_run(out, ctx, format, &args);
+}
+
+/**
+ * @brief Output callback of format_vsnprintf: appends to the buffer, truncating.
+ * 
+ * @param ctx Pointer to a struct format_buffer.
+ * @param s   Characters to append.
+ * @param len Number of characters.
+ */
+static void format_buffer_out(void *ctx, const char *s, uint32_t len)
+{
+    struct format_buffer *fb = (struct format_buffer *)ctx;
+
+    // Keep one byte for the terminating NUL.
+    while ((len > 0) && (fb->len + 1 < fb->size))
+    {
+        fb->buf[fb->len++] = *s++;
+        len--;
+    }
+}
+
+/**
+ * @brief Formats a string into a buffer.
+ */
+uint32_t format_vsnprintf(char *buf, uint32_t size, const char *format, va_list ap)
+{
+    struct format_buffer fb;
+    uint32_t total;
+
+    fb.buf = buf;
+    fb.size = size;
+    fb.len = 0;
+
+    total = format_vformat(format_buffer_out, &fb, format, ap);
+
+    if (size > 0)
+    {
+        buf[fb.len] = '\0';
+    }
+
+    return total;
+}
+
+/**
+ * @brief Formats a string into a buffer (variadic form of format_vsnprintf).
+ */
+uint32_t format_snprintf(char *buf, uint32_t size, const char *format, ...)
+{
+    uint32_t total;
+    va_list ap;
+
+    va_start(ap, format);
+    total = format_vsnprintf(buf, size, format, ap);
+    va_end(ap);
+
+    return total;
+}
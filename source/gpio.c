@@ -14,6 +14,8 @@
 
 #include "gpio.h"
 #include "utils.h"
+#include "timer.h"
+#include "sections.h"
 
 /**
  * @brief Initializes the GPIO peripheral.
@@ -23,7 +25,7 @@
  * It should be called before any other GPIO functions to ensure proper 
  * initialization.
  */
-void gpio_init(void)
+SECTION_INIT void gpio_init(void)
 {
     uint8_t i;
 
@@ -137,29 +139,151 @@ uint8_t gpio_read_pin(uint8_t pin)
  * @param pud     The pull-up/down mode (e.g., 0 = none, 1 = pull-up, 2 = pull-down).
  */
 void gpio_pull_up_down(uint8_t pin, uint8_t pud)
+{
+    // One pin is a mask with a single bit.
+    gpio_pull_mask(pin / GPIO_BANK_PINS, 1U << (pin % GPIO_BANK_PINS), pud);
+}
+
+
+/**
+ * @brief Sets the function of a pin through its descriptor.
+ * 
+ * @param desc     Descriptor of the pin (GPIO_PIN_DESC).
+ * @param function The function to set the pin to (GPIO_INPUT, GPIO_OUTPUT, GPIO_ALTn).
+ */
+void gpio_pin_set_function(const struct gpio_pin *desc, uint8_t function)
+{
+    uint32_t selector = GPIO->GPFSEL[desc->fsel];
+
+    // Replace the 3-bit field of the pin, whose position is precomputed.
+    selector &= ~(7U << desc->shift);
+    selector |= (uint32_t)function << desc->shift;
+    GPIO->GPFSEL[desc->fsel] = selector;
+}
+
+
+/**
+ * @brief Drives high every pin of a bank set in a mask, in one GPSET store.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * @param mask    One bit per pin of the bank.
+ */
+void gpio_set_mask(uint8_t bank, uint32_t mask)
+{
+    // Zero bits leave their pins alone: no read-modify-write.
+    GPIO->GPSET[bank] = mask;
+}
+
+
+/**
+ * @brief Drives low every pin of a bank set in a mask, in one GPCLR store.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * @param mask    One bit per pin of the bank.
+ */
+void gpio_clear_mask(uint8_t bank, uint32_t mask)
+{
+    // Zero bits leave their pins alone: no read-modify-write.
+    GPIO->GPCLR[bank] = mask;
+}
+
+
+/**
+ * @brief Reads the levels of a whole bank in one GPLEV load.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * 
+ * @return        One bit per pin of the bank, set for a high level.
+ */
+uint32_t gpio_read_mask(uint8_t bank)
+{
+    return GPIO->GPLEV[bank];
+}
+
+
+/**
+ * @brief Configures the pull-up or pull-down resistor of many pins at once.
+ * 
+ * @param bank    Bank of the pins (0 for pins 0-31, 1 for pins 32-53).
+ * @param mask    One bit per pin of the bank.
+ * @param pud     The pull-up/down mode (GPIO_PUD_OFF, GPIO_PUD_DOWN or GPIO_PUD_UP).
+ */
+void gpio_pull_mask(uint8_t bank, uint32_t mask, uint8_t pud)
 {
     // Set the desired pull-up/down value in the GPPUD register.
     // `pud` should specify the type: 0 (disable), 1 (pull-down), or 2 (pull-up).
     GPIO->GPPUD = pud;
 
-    // Wait 150 cycles for the value to take effect (hardware requirement).
-    delay(150);
+    // Wait 150 core clock cycles for the value to take effect (hardware requirement):
+    // 1µs covers them at any core clock above 150 MHz.
+    spin_us(1);
 
-    // Enable the clock for the pin's pull-up/down configuration.
-    // This is done by writing a 1 to the bit corresponding to the pin in the GPPUDCLK register.
-    // The pin number is divided by 32 to determine the appropriate clock register (if multiple exist).
-    GPIO->GPPUDCLK[pin / 32] = 1 << (pin % 32);
+    // Clock the control signal into every pin of the mask at once.
+    GPIO->GPPUDCLK[bank] = mask;
 
     // Wait another 150 cycles for the configuration to take effect.
-    delay(150);
+    spin_us(1);
 
     // Clear the GPPUD register to remove the pull-up/down control signal.
     // This step is necessary to avoid unintended behavior.
     GPIO->GPPUD = 0;
 
-    // Clear the clock register to finish the setup for the pin.
+    // Clear the clock register to finish the setup for the pins.
     // This step prevents further changes to the pull-up/down state until explicitly reconfigured.
-    GPIO->GPPUDCLK[pin / 32] = 0;
+    GPIO->GPPUDCLK[bank] = 0;
 }
 
 
+/**
+ * @brief Applies a pin configuration table.
+ * 
+ * @param table   Pins to configure.
+ * @param count   Entries in the table.
+ */
+void gpio_config_pins(const struct gpio_pin_config *table, uint32_t count)
+{
+    // Function fields to clear and to set, per GPFSEL register
+    uint32_t fsel_clear[6] = { 0 };
+    uint32_t fsel_set[6] = { 0 };
+    // Pins to clock, per pull mode (GPIO_PUD_OFF, DOWN, UP) and bank
+    uint32_t pull[3][2] = { { 0 } };
+    uint32_t shift;
+    uint32_t reg;
+    uint32_t i;
+    uint32_t b;
+
+    // Merge the table into masks
+    for (i = 0; i < count; i++)
+    {
+        reg = table[i].pin / 10;
+        shift = (table[i].pin % 10) * 3;
+        fsel_clear[reg] |= 7U << shift;
+        fsel_set[reg] |= (uint32_t)table[i].function << shift;
+
+        if (table[i].pud <= GPIO_PUD_UP)
+        {
+            pull[table[i].pud][table[i].pin / GPIO_BANK_PINS] |= 1U << (table[i].pin % GPIO_BANK_PINS);
+        }
+    }
+
+    // One read-modify-write per GPFSEL register touched by the table
+    for (reg = 0; reg < 6; reg++)
+    {
+        if (fsel_clear[reg] != 0)
+        {
+            GPIO->GPFSEL[reg] = (GPIO->GPFSEL[reg] & ~fsel_clear[reg]) | fsel_set[reg];
+        }
+    }
+
+    // One pull sequence per pull mode and bank used by the table
+    for (i = 0; i <= GPIO_PUD_UP; i++)
+    {
+        for (b = 0; b < 2; b++)
+        {
+            if (pull[i][b] != 0)
+            {
+                gpio_pull_mask(b, pull[i][b], i);
+            }
+        }
+    }
+}
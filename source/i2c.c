@@ -3,7 +3,9 @@
  * @brief       I2C driver implementation for the BCM2835 BSC controller.
  * @description This source file contains the implementation of functions for
  *              interacting with the I2C interface of the Broadcom BCM2835 BSC
- *              controller.
+ *              controller. Transfers are queued per controller, scheduled by
+ *              priority and device, and driven by the BSC interrupt; the blocking
+ *              calls are built on top of the queue.
  *
  * @version     1.0
  * @date        2024-12-16
@@ -11,92 +13,667 @@
 
 #include "i2c.h"
 #include <stdint.h>
+#include "irq.h"
+#include "spinlock.h"
+#include "utils.h"
+#include "sched.h"
+#include "atomic.h"
+#include "clock.h"
+#include "prof.h"
+#include "sections.h"
 
+/**
+ * @brief A device with its own bus speed.
+ */
+struct i2c_device {
+    uint8_t slave_addr;             // 7-bit slave address
+    uint16_t div;                   // DIV register value for this device
+    uint32_t speed_hz;              // Requested SCL frequency, to recompute div
+};
+
+/**
+ * @brief State of a BSC controller.
+ */
+struct i2c_bus {
+    struct I2C_Registers *regs;     // Controller registers
+    spinlock_t lock;                // Protects the queues and the registers
+    struct i2c_txn *active;         // Transaction on the bus
+    struct i2c_txn *head[I2C_NR_PRIO];  // Queued transactions, per priority
+    struct i2c_txn *tail[I2C_NR_PRIO];
+    uint32_t pos;                   // Bytes moved through the FIFO for the active transaction
+    uint16_t default_div;           // DIV given to i2c_init(), moved with the core clock
+    uint32_t default_hz;            // SCL frequency of default_div at i2c_init()
+    uint16_t current_div;           // DIV currently programmed
+    uint8_t last_addr;              // Device of the previous transaction
+    uint8_t batch;                  // Consecutive transactions for last_addr
+    uint8_t nr_devices;             // Entries used in devices[]
+    uint8_t ready;                  // Set by i2c_init()
+    int start_status;               // Error of a failed combined start, else I2C_PENDING
+    struct i2c_device devices[I2C_MAX_DEVICES];
+};
+
+// Controllers, indexed by I2C_Controller_Index (no lookup on the data path)
+static struct i2c_bus i2c_buses[I2C_NR_CONTROLLERS] = {
+    { .regs = BSC0_I2C, .lock = SPINLOCK_INIT },
+    { .regs = BSC1_I2C, .lock = SPINLOCK_INIT },
+    { .regs = BSC2_I2C, .lock = SPINLOCK_INIT },
+};
+
+// Set once the shared BSC interrupt is registered
+static uint8_t i2c_irq_registered;
+
+static struct i2c_bus *i2c_get_bus(I2C_Controller_Index index);
+static uint16_t i2c_device_div(struct i2c_bus *bus, uint8_t slave_addr);
+static struct i2c_txn *i2c_bus_next(struct i2c_bus *bus);
+static void i2c_bus_start(struct i2c_bus *bus);
+static void i2c_bus_service(struct i2c_bus *bus);
+static void i2c_clock_changed(uint32_t event, uint32_t core_hz);
+static int i2c_transfer(I2C_Controller_Index index, struct i2c_txn *txn);
+
+/**
+ * @brief Returns the state of an initialized controller.
+ * 
+ * @param index The I2C controller index.
+ * @return      The controller, or NULL if the index is invalid or not initialized.
+ */
+static struct i2c_bus *i2c_get_bus(I2C_Controller_Index index)
+{
+    if (((uint32_t)index >= I2C_NR_CONTROLLERS) || !i2c_buses[index].ready)
+    {
+        return 0;
+    }
+    return &i2c_buses[index];
+}
 
 /**
  * @brief Initializes the specified I2C controller.
  * 
  * Configures the I2C peripheral with a clock divider to set the communication speed.
+ * The first call also registers the BSC interrupt, shared by the controllers.
  * 
  * @param index      The I2C controller index (I2C_CONTROLLER_0, I2C_CONTROLLER_1, I2C_CONTROLLER_2).
  * @param clock_div  The clock divider value to configure the I2C speed.
  */
 void i2c_init(I2C_Controller_Index index, uint16_t clock_div)
 {
+    struct i2c_bus *bus;
     struct I2C_Registers *i2c;
 
-    switch (index) {
-        case I2C_CONTROLLER_0:
-            i2c = BSC0_I2C;
-            break;
-        case I2C_CONTROLLER_1:
-            i2c = BSC1_I2C;
-            break;
-        case I2C_CONTROLLER_2:
-            i2c = BSC2_I2C;
-            break;
-        default:
-            return;  // Invalid index
+    if ((uint32_t)index >= I2C_NR_CONTROLLERS)
+    {
+        return;  // Invalid index
     }
+    bus = &i2c_buses[index];
+    i2c = bus->regs;
 
     i2c->CONTROL = I2C_CTL_I2CEN_Disable;  // Disable I2C during configuration
     i2c->DIV = clock_div;  // Set clock divider for I2C speed
+    bus->default_div = clock_div;
+    bus->default_hz = clock_get_core_hz() / (clock_div ? clock_div : 32768);  // DIV 0 divides by 32768
+    bus->current_div = clock_div;
     //i2c->CLKT = 0x40;   // Set clock stretch timeout
+    i2c->STATUS = I2C_STAT_CLKT_Error | I2C_STAT_ERR_Error | I2C_STAT_DONE_Done;  // Clear stale flags
     i2c->CONTROL = I2C_CTL_I2CEN_Enable;  // Enable I2C
+    bus->ready = 1;
+
+    if (!i2c_irq_registered)
+    {
+        i2c_irq_registered = 1;
+        irq_register(IRQ_I2C, handle_i2c_irq, IRQ_PRIO_HIGH);
+        clock_register_notifier(i2c_clock_changed);
+    }
 }
 
 /**
- * @brief Writes data to an I2C slave device.
+ * @brief Returns the divider of an SCL frequency at a core clock rate.
  * 
- * Sends a buffer of data to the specified I2C slave device using the I2C controller.
+ * @param core_hz  VPU core clock rate in Hz.
+ * @param speed_hz SCL frequency in Hz, not 0.
+ * @return         DIV value: rounded up (never faster than asked) to an even value.
+ */
+static uint16_t i2c_div(uint32_t core_hz, uint32_t speed_hz)
+{
+    // SCL = core clock / DIV
+    uint32_t div = (core_hz + speed_hz - 1) / speed_hz;
+
+    div = (div + 1) & ~1U;
+    if (div > 0xFFFE)
+    {
+        div = 0xFFFE;
+    }
+    return (uint16_t)div;
+}
+
+/**
+ * @brief Returns the divider of an SCL frequency at the current core clock.
  * 
- * @param index       The I2C controller index (I2C_CONTROLLER_0, I2C_CONTROLLER_1, I2C_CONTROLLER_2).
+ * @param speed_hz SCL frequency in Hz (e.g. I2C_SPEED_STANDARD).
+ * @return         DIV value for i2c_init(), 0 if the speed is 0.
+ */
+uint16_t i2c_speed_to_div(uint32_t speed_hz)
+{
+    return (speed_hz == 0) ? 0 : i2c_div(clock_get_core_hz(), speed_hz);
+}
+
+/**
+ * @brief Core clock notifier: recomputes the dividers for the new core rate.
+ * 
+ * Every stored divider follows, so the SCL frequencies stay the requested ones.
+ * DIV itself is rewritten by the next transaction start.
+ * 
+ * @param event   CLOCK_PRE_CHANGE or CLOCK_POST_CHANGE.
+ * @param core_hz Core rate in Hz.
+ */
+static void i2c_clock_changed(uint32_t event, uint32_t core_hz)
+{
+    struct i2c_bus *bus;
+    uint64_t flags;
+    uint32_t b;
+    uint32_t i;
+
+    if (event != CLOCK_POST_CHANGE)
+    {
+        return;
+    }
+
+    for (b = 0; b < I2C_NR_CONTROLLERS; b++)
+    {
+        bus = &i2c_buses[b];
+        if (!bus->ready)
+        {
+            continue;
+        }
+
+        flags = spin_lock_irqsave(&bus->lock);
+        if (bus->default_hz != 0)
+        {
+            bus->default_div = i2c_div(core_hz, bus->default_hz);
+        }
+        for (i = 0; i < bus->nr_devices; i++)
+        {
+            bus->devices[i].div = i2c_div(core_hz, bus->devices[i].speed_hz);
+        }
+        bus->current_div = 0;  // Unknown: DIV rewritten at the next start (never 0 otherwise)
+        spin_unlock_irqrestore(&bus->lock, flags);
+    }
+}
+
+/**
+ * @brief Sets the bus speed used for one device.
+ * 
+ * @param index       The I2C controller index, initialized with i2c_init().
  * @param slave_addr  The address of the I2C slave device.
- * @param data        Pointer to the buffer containing data to send.
- * @param length      Number of bytes to send.
- * @return int        Returns 0 on success, -1 for invalid input, -2 for ACK errors,
- *                    and -3 for clock stretch timeouts.
+ * @param speed_hz    SCL frequency (e.g. I2C_SPEED_STANDARD, I2C_SPEED_FAST).
+ * @return int        I2C_OK, or I2C_EINVAL if the table is full or the speed is 0.
  */
-int i2c_write(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *data, uint32_t length)
+int i2c_set_device_speed(I2C_Controller_Index index, uint8_t slave_addr, uint32_t speed_hz)
 {
-    struct I2C_Registers *i2c;
+    struct i2c_bus *bus = i2c_get_bus(index);
+    uint64_t flags;
+    uint32_t div;
+    uint32_t i;
 
-    switch (index) {
-        case I2C_CONTROLLER_0:
-            i2c = BSC0_I2C;
-            break;
-        case I2C_CONTROLLER_1:
-            i2c = BSC1_I2C;
-            break;
-        case I2C_CONTROLLER_2:
-            i2c = BSC2_I2C;
+    if ((bus == 0) || (speed_hz == 0))
+    {
+        return I2C_EINVAL;
+    }
+
+    div = i2c_div(clock_get_core_hz(), speed_hz);
+
+    flags = spin_lock_irqsave(&bus->lock);
+    for (i = 0; i < bus->nr_devices; i++)
+    {
+        if (bus->devices[i].slave_addr == slave_addr)
+        {
             break;
-        default:
-            return -1;  // Invalid index
+        }
+    }
+    if (i == I2C_MAX_DEVICES)
+    {
+        spin_unlock_irqrestore(&bus->lock, flags);
+        return I2C_EINVAL;
+    }
+    if (i == bus->nr_devices)
+    {
+        bus->nr_devices++;
+    }
+    bus->devices[i].slave_addr = slave_addr;
+    bus->devices[i].div = (uint16_t)div;
+    bus->devices[i].speed_hz = speed_hz;
+    spin_unlock_irqrestore(&bus->lock, flags);
+
+    return I2C_OK;
+}
+
+/**
+ * @brief Returns the divider of a device.
+ * 
+ * @param bus         The controller.
+ * @param slave_addr  The address of the I2C slave device.
+ * @return            Its DIV value, or the controller default.
+ */
+static uint16_t i2c_device_div(struct i2c_bus *bus, uint8_t slave_addr)
+{
+    uint32_t i;
+
+    for (i = 0; i < bus->nr_devices; i++)
+    {
+        if (bus->devices[i].slave_addr == slave_addr)
+        {
+            return bus->devices[i].div;
+        }
+    }
+    return bus->default_div;
+}
+
+/**
+ * @brief Picks and unlinks the next transaction to run.
+ * 
+ * The most urgent non-empty priority wins. Within it, a transaction for the device
+ * just served is preferred (no DIV change, sequences of one device stay together)
+ * until I2C_BATCH_MAX of them ran in a row; otherwise the oldest one is taken.
+ * Must be called with the bus lock held.
+ * 
+ * @param bus The controller.
+ * @return    The transaction, or NULL if nothing is queued.
+ */
+static struct i2c_txn *i2c_bus_next(struct i2c_bus *bus)
+{
+    struct i2c_txn *txn;
+    struct i2c_txn *prev;
+    uint32_t prio;
+
+    for (prio = 0; prio < I2C_NR_PRIO; prio++)
+    {
+        if (bus->head[prio] == 0)
+        {
+            continue;
+        }
+
+        // Same device first, while the batch lasts
+        prev = 0;
+        txn = bus->head[prio];
+        if (bus->batch < I2C_BATCH_MAX)
+        {
+            while (txn && (txn->slave_addr != bus->last_addr))
+            {
+                prev = txn;
+                txn = txn->next;
+            }
+        }
+        if (txn == 0)
+        {
+            // FIFO order
+            prev = 0;
+            txn = bus->head[prio];
+        }
+
+        // Unlink
+        if (prev)
+        {
+            prev->next = txn->next;
+        }
+        else
+        {
+            bus->head[prio] = txn->next;
+        }
+        if (bus->tail[prio] == txn)
+        {
+            bus->tail[prio] = prev;
+        }
+        txn->next = 0;
+
+        if (txn->slave_addr == bus->last_addr)
+        {
+            bus->batch++;
+        }
+        else
+        {
+            bus->last_addr = txn->slave_addr;
+            bus->batch = 1;
+        }
+        return txn;
+    }
+    return 0;
+}
+
+/**
+ * @brief Starts the next scheduled transaction.
+ * 
+ * Writes prefill the FIFO before the start; the rest of the data is moved by the
+ * INTT (writes) or INTR (reads) interrupts, and INTD completes the transfer. A
+ * combined transfer starts its write phase, waits for TA and immediately queues
+ * the read with ST: the controller then chains them with a repeated start instead
+ * of a STOP. The read is only queued while the write phase is active; otherwise
+ * the transaction ends on DONE with I2C_ENACK (address NACK, or the write was over
+ * before TA was seen) or I2C_ETIMEOUT (TA not seen within I2C_TA_SPIN_MAX polls).
+ * Must be called with the bus lock held.
+ * 
+ * @param bus The controller.
+ */
+static void i2c_bus_start(struct i2c_bus *bus)
+{
+    struct I2C_Registers *i2c = bus->regs;
+    struct i2c_txn *txn;
+    uint32_t control = I2C_CTL_I2CEN_Enable | I2C_CTL_ST_Start | I2C_CTL_INTD_Enable;
+    uint16_t div;
+    uint32_t spin;
+    uint32_t status = 0;
+
+    txn = i2c_bus_next(bus);
+    bus->active = txn;
+    if (txn == 0)
+    {
+        return;
+    }
+
+    // Per-device speed, only written when the device changes it
+    div = i2c_device_div(bus, txn->slave_addr);
+    if (div != bus->current_div)
+    {
+        i2c->DIV = div;
+        bus->current_div = div;
+    }
+
+    i2c->CONTROL = I2C_CTL_I2CEN_Enable | I2C_CTL_CLEAR_ClearFifo;  // Clear FIFO
+    i2c->STATUS = I2C_STAT_CLKT_Error | I2C_STAT_ERR_Error | I2C_STAT_DONE_Done;  // Clear status flags
+
+    i2c->A = txn->slave_addr;  // Set the slave address
+    i2c->DLEN = txn->length;   // Set data length
+    bus->pos = 0;
+    bus->start_status = I2C_PENDING;
+
+    if (txn->flags == I2C_TXN_READ)
+    {
+        control |= I2C_CTL_READ_Read | I2C_CTL_INTR_Enable;
+    }
+    else
+    {
+        // Prefill the FIFO, then refill it from the TXW interrupt
+        while ((bus->pos < txn->length) && (bus->pos < I2C_FIFO_DEPTH))
+        {
+            i2c->FIFO = txn->buffer[bus->pos++];
+        }
+        if (bus->pos < txn->length)
+        {
+            control |= I2C_CTL_INTT_Enable;
+        }
     }
 
-    if (length == 0) return -1;  // Invalid data length
+    if (txn->flags == I2C_TXN_WRITE_READ)
+    {
+        // Write phase (the whole write is in the FIFO), no interrupt yet
+        i2c->CONTROL = I2C_CTL_I2CEN_Enable | I2C_CTL_ST_Start;
 
-    i2c->CONTROL = I2C_CTL_CLEAR_ClearFifo;  // Clear FIFO
-    i2c->STATUS = 0xFFFFFFFF;  // Clear status flags
+        // TA rises within a few SCL cycles; an address NACK ends the transfer instead
+        for (spin = 0; spin < I2C_TA_SPIN_MAX; spin++)
+        {
+            status = i2c->STATUS;
+            if (status & (I2C_STAT_TA_Active | I2C_STAT_ERR_Error | I2C_STAT_DONE_Done))
+            {
+                break;
+            }
+        }
 
-    i2c->A = slave_addr;  // Set the slave address
-    i2c->DLEN = length;   // Set data length
+        if (!(status & I2C_STAT_TA_Active) || (status & (I2C_STAT_ERR_Error | I2C_STAT_DONE_Done)))
+        {
+            // No write phase in progress to chain the read to (NACK, write already
+            // over, or TA never seen): no read; the completion path reports the
+            // failure once DONE is set
+            bus->start_status = (status & (I2C_STAT_ERR_Error | I2C_STAT_DONE_Done)) ? I2C_ENACK : I2C_ETIMEOUT;
+            i2c->CONTROL = I2C_CTL_I2CEN_Enable | I2C_CTL_INTD_Enable;
+            return;
+        }
 
-    for (uint32_t i = 0; i < length; i++) {
-        i2c->FIFO = data[i];  // Write data to FIFO
+        // Read phase: starts with a repeated start once the write is out
+        bus->pos = 0;
+        i2c->DLEN = txn->rx_length;
+        control = I2C_CTL_I2CEN_Enable | I2C_CTL_ST_Start | I2C_CTL_INTD_Enable |
+                  I2C_CTL_READ_Read | I2C_CTL_INTR_Enable;
     }
 
-    i2c->CONTROL = I2C_CTL_I2CEN_Enable | I2C_CTL_ST_Start;  // Start transfer
+    i2c->CONTROL = control;  // Start transfer
+}
 
-    // Wait for transfer to complete
-    while (!(i2c->STATUS & I2C_STAT_DONE_Done)) {
-        if (i2c->STATUS & I2C_STAT_ERR_Error) return -2;  // ACK Error
-        if (i2c->STATUS & I2C_STAT_CLKT_Error) return -3; // Clock stretch timeout
+/**
+ * @brief Moves data through the FIFO and completes the active transaction.
+ * 
+ * Called from the BSC interrupt, or by a blocking caller that cannot wait for it.
+ * The callback runs with the bus lock released, after the next transaction has
+ * been started.
+ * 
+ * @param bus The controller.
+ */
+static void i2c_bus_service(struct i2c_bus *bus)
+{
+    struct I2C_Registers *i2c = bus->regs;
+    struct i2c_txn *txn;
+    i2c_callback_t callback;
+    uint64_t flags;
+    uint32_t status;
+    int result;
+
+    flags = spin_lock_irqsave(&bus->lock);
+
+    txn = bus->active;
+    if (txn == 0)
+    {
+        spin_unlock_irqrestore(&bus->lock, flags);
+        return;
+    }
+
+    // Sampled first: once DONE is seen, the drain below gets the last bytes
+    status = i2c->STATUS;
+
+    if (txn->flags == I2C_TXN_READ)
+    {
+        // Drain the FIFO (RXR: needs reading, DONE: the last bytes)
+        while ((bus->pos < txn->length) && (i2c->STATUS & I2C_STAT_RXD_Contains))
+        {
+            txn->buffer[bus->pos++] = i2c->FIFO;
+        }
     }
+    else if (txn->flags == I2C_TXN_WRITE_READ)
+    {
+        // Read phase of a combined transfer
+        while ((bus->pos < txn->rx_length) && (i2c->STATUS & I2C_STAT_RXD_Contains))
+        {
+            txn->rx_buffer[bus->pos++] = i2c->FIFO;
+        }
+    }
+    else
+    {
+        // Refill the FIFO (TXW: needs writing)
+        while ((bus->pos < txn->length) && (i2c->STATUS & I2C_STAT_TXD_Accept))
+        {
+            i2c->FIFO = txn->buffer[bus->pos++];
+        }
+        if (bus->pos == txn->length)
+        {
+            // Everything is in the FIFO: TXW would keep interrupting
+            i2c->CONTROL &= ~I2C_CTL_INTT_Enable;
+        }
+    }
+
+    if (!(status & (I2C_STAT_DONE_Done | I2C_STAT_ERR_Error | I2C_STAT_CLKT_Error)))
+    {
+        spin_unlock_irqrestore(&bus->lock, flags);
+        return;
+    }
+
+    // Transfer over: work out the outcome and start the next transaction
+    if (status & I2C_STAT_ERR_Error)
+    {
+        result = I2C_ENACK;
+    }
+    else if (status & I2C_STAT_CLKT_Error)
+    {
+        result = I2C_ECLKT;
+    }
+    else
+    {
+        result = I2C_OK;
+    }
+
+    // A combined transfer whose read phase was not started failed, whatever the bus says
+    if ((bus->start_status != I2C_PENDING) && (result != I2C_ECLKT))
+    {
+        result = bus->start_status;
+    }
+
+    // Read before the status is published: a blocking caller owns txn again after it
+    callback = txn->callback;
 
-    i2c->STATUS = I2C_STAT_DONE_Done;  // Clear DONE flag
-    return 0;  // Success
+    i2c->CONTROL = I2C_CTL_I2CEN_Enable | I2C_CTL_CLEAR_ClearFifo;  // Stop the interrupts, drop leftovers
+    i2c->STATUS = I2C_STAT_CLKT_Error | I2C_STAT_ERR_Error | I2C_STAT_DONE_Done;  // Clear DONE flag
+
+    i2c_bus_start(bus);
+
+    // Publish the outcome last, after the received bytes: a blocking caller may
+    // return (and reuse its stack) as soon as it sees it, so txn is not touched
+    // again below unless a callback owner keeps it valid until the callback ran
+    smp_wmb();
+    txn->status = result;
+
+    spin_unlock_irqrestore(&bus->lock, flags);
+
+    if (callback)
+    {
+        callback(txn);
+    }
+    // Wake blocking callers: tasks, or WFE sleepers possibly on another core
+    sched_send_event();
+}
+
+/**
+ * @brief BSC interrupt handler: services the active transaction of every controller.
+ */
+SECTION_HOT void handle_i2c_irq(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < I2C_NR_CONTROLLERS; i++)
+    {
+        if (i2c_buses[i].ready && i2c_buses[i].active)
+        {
+            i2c_bus_service(&i2c_buses[i]);
+        }
+    }
+}
+
+/**
+ * @brief Queues an I2C transaction.
+ * 
+ * @param index     The I2C controller index, initialized with i2c_init().
+ * @param txn       The transaction; must stay valid until its callback has run.
+ * @param callback  Function called on completion, or NULL.
+ * @return int      I2C_OK if the transaction was queued, I2C_EINVAL otherwise.
+ */
+int i2c_submit(I2C_Controller_Index index, struct i2c_txn *txn, i2c_callback_t callback)
+{
+    struct i2c_bus *bus = i2c_get_bus(index);
+    uint64_t flags;
+
+    // DLEN is a 16-bit register
+    if ((bus == 0) || (txn == 0) || (txn->buffer == 0) || (txn->length == 0) || (txn->length > 0xFFFF) ||
+        (txn->priority >= I2C_NR_PRIO) || (txn->flags > I2C_TXN_WRITE_READ))
+    {
+        return I2C_EINVAL;
+    }
+
+    // The write phase of a combined transfer must fit in the FIFO
+    if ((txn->flags == I2C_TXN_WRITE_READ) &&
+        ((txn->length > I2C_FIFO_DEPTH) || (txn->rx_buffer == 0) || (txn->rx_length == 0) || (txn->rx_length > 0xFFFF)))
+    {
+        return I2C_EINVAL;
+    }
+
+    txn->status = I2C_PENDING;
+    txn->callback = callback;
+    txn->next = 0;
+
+    flags = spin_lock_irqsave(&bus->lock);
+    if (bus->tail[txn->priority])
+    {
+        bus->tail[txn->priority]->next = txn;
+    }
+    else
+    {
+        bus->head[txn->priority] = txn;
+    }
+    bus->tail[txn->priority] = txn;
+
+    // Idle controller: start right away
+    if (bus->active == 0)
+    {
+        i2c_bus_start(bus);
+    }
+    spin_unlock_irqrestore(&bus->lock, flags);
+
+    return I2C_OK;
+}
+
+/**
+ * @brief Runs a transaction and waits for its completion.
+ * 
+ * Sleeps in sched_wait_event() (WFE outside of tasks, so other tasks run meanwhile)
+ * until the BSC interrupt completes the transaction. In IRQ context
+ * or with IRQs masked the interrupt cannot be taken, so the controller is polled.
+ * 
+ * @param index       The I2C controller index.
+ * @param txn         The transaction, on the caller's stack.
+ * @return int        The transaction status.
+ */
+static int i2c_transfer(I2C_Controller_Index index, struct i2c_txn *txn)
+{
+    int status;
+
+    txn->arg = 0;
+    status = i2c_submit(index, txn, 0);
+    if (status != I2C_OK)
+    {
+        return status;
+    }
+
+    while (txn->status == I2C_PENDING)
+    {
+        if (irq_in_handler())
+        {
+            // Poll fallback
+            i2c_bus_service(&i2c_buses[index]);
+        }
+        else
+        {
+            sched_wait_event();
+        }
+    }
+
+    // The received bytes were stored before the status
+    smp_rmb();
+
+    return txn->status;
+}
+
+/**
+ * @brief Writes data to an I2C slave device.
+ * 
+ * Sends a buffer of data to the specified I2C slave device using the I2C controller.
+ * 
+ * @param index       The I2C controller index (I2C_CONTROLLER_0, I2C_CONTROLLER_1, I2C_CONTROLLER_2).
+ * @param slave_addr  The address of the I2C slave device.
+ * @param data        Pointer to the buffer containing data to send.
+ * @param length      Number of bytes to send.
+ * @return int        Returns 0 on success, -1 for invalid input, -2 for ACK errors,
+ *                    and -3 for clock stretch timeouts.
+ */
+int i2c_write(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *data, uint32_t length)
+{
+    struct i2c_txn txn = { .slave_addr = slave_addr, .flags = I2C_TXN_WRITE, .priority = I2C_PRIO_NORMAL,
+                           .buffer = data, .length = length };
+
+    PROF_SCOPE(PROF_PROBE_I2C_WRITE);
+
+    return i2c_transfer(index, &txn);
 }
 
 /**
@@ -113,45 +690,29 @@ int i2c_write(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *data, uin
  */
 int i2c_read(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *buffer, uint32_t length)
 {
-    struct I2C_Registers *i2c;
-
-    switch (index) {
-        case I2C_CONTROLLER_0:
-            i2c = BSC0_I2C;
-            break;
-        case I2C_CONTROLLER_1:
-            i2c = BSC1_I2C;
-            break;
-        case I2C_CONTROLLER_2:
-            i2c = BSC2_I2C;
-            break;
-        default:
-            return -1;  // Invalid index
-    }
-
-    if (length == 0) return -1;  // Invalid data length
+    struct i2c_txn txn = { .slave_addr = slave_addr, .flags = I2C_TXN_READ, .priority = I2C_PRIO_NORMAL,
+                           .buffer = buffer, .length = length };
 
-    i2c->CONTROL = I2C_CTL_CLEAR_ClearFifo;  // Clear FIFO
-    i2c->STATUS = 0xFFFFFFFF;  // Clear status flags
-
-    i2c->A = slave_addr;  // Set the slave address
-    i2c->DLEN = length;   // Set data length
-
-    i2c->CONTROL = I2C_CTL_I2CEN_Enable | I2C_CTL_ST_Start | I2C_CTL_READ_Read;  // Start transfer (Read)
-
-    for (uint32_t i = 0; i < length; i++) {
-        while (!(i2c->STATUS & I2C_STAT_RXD_Contains)) {
-            if (i2c->STATUS & I2C_STAT_ERR_Error) return -2;  // ACK Error
-            if (i2c->STATUS & I2C_STAT_CLKT_Error) return -3; // Clock stretch timeout
-        }
-        buffer[i] = i2c->FIFO;  // Read data from FIFO
-    }
+    return i2c_transfer(index, &txn);
+}
 
-    while (!(i2c->STATUS & I2C_STAT_DONE_Done)) {
-        if (i2c->STATUS & I2C_STAT_ERR_Error) return -2;
-        if (i2c->STATUS & I2C_STAT_CLKT_Error) return -3;
-    }
+/**
+ * @brief Writes then reads an I2C slave device with a repeated start.
+ * 
+ * @param index       The I2C controller index.
+ * @param slave_addr  The address of the I2C slave device.
+ * @param data        Data to send (e.g. the register address).
+ * @param length      Number of bytes to send (1 to I2C_FIFO_DEPTH).
+ * @param buffer      Pointer to the buffer where the received data will be stored.
+ * @param rx_length   Number of bytes to read.
+ * @return int        Returns 0 on success, -1 for invalid input, -2 for ACK errors,
+ *                    -3 for clock stretch timeouts and -4 if the read phase could not
+ *                    be chained (I2C_ETIMEOUT).
+ */
+int i2c_write_read(I2C_Controller_Index index, uint8_t slave_addr, uint8_t *data, uint32_t length, uint8_t *buffer, uint32_t rx_length)
+{
+    struct i2c_txn txn = { .slave_addr = slave_addr, .flags = I2C_TXN_WRITE_READ, .priority = I2C_PRIO_NORMAL,
+                           .buffer = data, .length = length, .rx_buffer = buffer, .rx_length = rx_length };
 
-    i2c->STATUS = I2C_STAT_DONE_Done;  // Clear DONE flag
-    return 0;  // Success
+    return i2c_transfer(index, &txn);
 }
@@ -3,7 +3,8 @@
  * @brief       Exception handling and interrupt management for ARMv8-A at EL1.
  * @description This file implements exception handling and interrupt management for the 
  *              ARMv8-A architecture. It includes invalid entry message handling, interrupt 
- *              controller configuration, and auxiliary IRQ processing.
+ *              controller configuration, and the table-driven, prioritized IRQ dispatcher 
+ *              that drivers register their handlers with.
  * 
  * @version     1.0
  * @date        2024-12-15
@@ -11,13 +12,16 @@
 
 #include "common.h"
 #include "gpio.h"
-#include "mini_uart.h"
+#include "uart.h"
 #include "uart_printf.h"
 #include "entry.h"
 #include "irq.h"
 #include "aux.h"
-#include "timer.h"
-#include "dht22.h"
+#include "local_timer.h"
+#include "spinlock.h"
+#include "atomic.h"
+#include "prof.h"
+#include "sections.h"
 /**
  * @brief       Array of error messages for invalid exception entries.
  * @description This array maps exception types to corresponding error messages
@@ -43,6 +47,49 @@ const char entry_error_message[16][32] =
     "VECTOR_INVALID_SER_EL0_AARCH32"    // Invalid SError from EL0, AArch32
 };
 
+/**
+ * @brief       Handler table entry of an IRQ source.
+ */
+struct irq_desc {
+    irq_handler_t handler;          // Registered handler, NULL if none
+    uint8_t priority;               // IRQ_PRIO_HIGHEST to IRQ_PRIO_LOW
+};
+
+// Handler table, indexed by IRQ number
+static struct irq_desc irq_table[NR_IRQS];
+
+// Sources of each priority: [0] GPU 0-63, [1] basic (bits 0-7) and local (bits 8-19)
+static uint64_t irq_prio_mask[NR_IRQ_PRIO][2];
+
+// CNTPCT_EL0 at the entry of the last handle_irq() of each core
+static volatile uint64_t irq_entry_counter[NR_CORES];
+
+// Serializes irq_register() calls
+static spinlock_t irq_table_lock = SPINLOCK_INIT;
+
+// Priority of the handler running on each core (NR_IRQ_PRIO when none)
+static uint8_t irq_current_prio[NR_CORES] = { NR_IRQ_PRIO, NR_IRQ_PRIO, NR_IRQ_PRIO, NR_IRQ_PRIO };
+
+// Dispatch statistics of each source, per core: local sources (the tick) run on
+// every core, and each core only updates its own row, without atomics
+static struct irq_stats irq_core_stats[NR_CORES][NR_IRQS];
+
+// Pending sources without a handler, per core
+static uint32_t irq_spurious[NR_CORES];
+
+// Handler of the FIQ fast path, called from handler_vector_6 in entry.S (NULL if none)
+irq_handler_t fiq_handler_fn;
+
+// GPU sources behind the shortcut bits 10-20 of IRQBasicPending
+static const uint8_t irq_shortcut_map[IRQ_BASIC_SHORTCUTS] = { 7, 9, 10, 18, 19, 53, 54, 55, 56, 57, 62 };
+
+static void irq_set_line(uint32_t irq_no, uint8_t enable);
+static void irq_set_priority_range(uint8_t from, uint8_t to, uint8_t enable);
+static uint32_t irq_mask_local(uint8_t core, uint8_t from, uint8_t to);
+static void irq_unmask_local(uint8_t core, uint32_t masked);
+static void irq_read_pending(uint8_t core, uint64_t pending[2]);
+static int irq_find_next(const uint64_t pending[2], uint8_t limit);
+
 /**
  * @brief       Show an invalid entry message.
  * @description Prints a detailed error message when an invalid exception vector
@@ -55,7 +102,7 @@ const char entry_error_message[16][32] =
 void show_invalid_entry_message(uint32_t type, uint64_t esr, uint64_t address) 
 {
     uart_printf(
-        "ERROR CAUGHT: %s - %d, ESR: %X, Address: %X\n", 
+        "ERROR CAUGHT: %s - %d, ESR: %llX, Address: %llX\n", 
         entry_error_message[type],   // Corresponding error message
         type,                        // Error type (index)
         esr,                         // Exception Syndrome Register value
@@ -64,72 +111,513 @@ void show_invalid_entry_message(uint32_t type, uint64_t esr, uint64_t address)
 }
 
 /**
- * @brief       Enable the interrupt controller for auxiliary devices.
- * @description This function configures the interrupt controller to enable
- *              interrupts for auxiliary devices, such as Mini UART.
+ * @brief       Enable or disable one GPU or basic source in the interrupt controller.
+ * @description Local sources are routed per core by their driver and are left alone.
+ * 
+ * @param irq_no    IRQ number.
+ * @param enable    1 to enable the source, 0 to disable it.
+ */
+SECTION_HOT static void irq_set_line(uint32_t irq_no, uint8_t enable)
+{
+    if (irq_no < 32)
+    {
+        if (enable) IRQ_REG->EnableIRQs1 = 1U << irq_no;
+        else        IRQ_REG->DisableIRQs1 = 1U << irq_no;
+    }
+    else if (irq_no < IRQ_BASIC(0))
+    {
+        if (enable) IRQ_REG->EnableIRQs2 = 1U << (irq_no - 32);
+        else        IRQ_REG->DisableIRQs2 = 1U << (irq_no - 32);
+    }
+    else if (irq_no < IRQ_LOCAL(0))
+    {
+        if (enable) IRQ_REG->EnableBasicIRQs = 1U << (irq_no - IRQ_BASIC(0));
+        else        IRQ_REG->DisableBasicIRQs = 1U << (irq_no - IRQ_BASIC(0));
+    }
+}
+
+/**
+ * @brief       Mask or unmask the GPU and basic sources of a set of priorities.
+ * @description Sources whose priority is in [from, to) are disabled (or enabled) in the
+ *              interrupt controller. Local sources are not affected.
+ * 
+ * @param from      First priority of the range.
+ * @param to        End of the range (excluded).
+ * @param enable    1 to enable the sources, 0 to disable them.
+ */
+SECTION_HOT static void irq_set_priority_range(uint8_t from, uint8_t to, uint8_t enable)
+{
+    uint64_t gpu = 0;
+    uint64_t other = 0;
+    uint8_t prio;
+
+    // Union of the sources registered in the range
+    for (prio = from; prio < to; prio++)
+    {
+        gpu |= irq_prio_mask[prio][0];
+        other |= irq_prio_mask[prio][1];
+    }
+
+    if (enable)
+    {
+        if ((uint32_t)gpu)              IRQ_REG->EnableIRQs1 = (uint32_t)gpu;
+        if ((uint32_t)(gpu >> 32))      IRQ_REG->EnableIRQs2 = (uint32_t)(gpu >> 32);
+        if (other & IRQ_BASIC_ARM_MASK) IRQ_REG->EnableBasicIRQs = (uint32_t)(other & IRQ_BASIC_ARM_MASK);
+    }
+    else
+    {
+        if ((uint32_t)gpu)              IRQ_REG->DisableIRQs1 = (uint32_t)gpu;
+        if ((uint32_t)(gpu >> 32))      IRQ_REG->DisableIRQs2 = (uint32_t)(gpu >> 32);
+        if (other & IRQ_BASIC_ARM_MASK) IRQ_REG->DisableBasicIRQs = (uint32_t)(other & IRQ_BASIC_ARM_MASK);
+    }
+}
+
+/**
+ * @brief       Mask the local sources of a set of priorities on the calling core.
+ * @description The core timers and mailboxes whose priority is in [from, to) and that
+ *              are enabled are disabled in the control registers of the core.
+ * 
+ * @param core      Calling core.
+ * @param from      First priority of the range.
+ * @param to        End of the range (excluded).
+ * 
+ * @return      The sources disabled, local source bits, for irq_unmask_local().
+ */
+SECTION_HOT static uint32_t irq_mask_local(uint8_t core, uint8_t from, uint8_t to)
+{
+    uint64_t other = 0;
+    uint32_t local;
+    uint32_t timers;
+    uint32_t mailboxes;
+    uint8_t prio;
+
+    for (prio = from; prio < to; prio++)
+    {
+        other |= irq_prio_mask[prio][1];
+    }
+
+    // Usually none: the local sources run at IRQ_PRIO_HIGHEST
+    local = (uint32_t)(other >> (IRQ_LOCAL(0) - IRQ_BASIC(0))) & IRQ_LOCAL_MASKABLE;
+    if (local == 0)
+    {
+        return 0;
+    }
+
+    // Only this core writes its control registers
+    timers = LOCAL->TIMER_IRQ_CTRL[core] & local & IRQ_LOCAL_TIMER_BITS;
+    mailboxes = LOCAL->MAILBOX_IRQ_CTRL[core] & ((local & IRQ_LOCAL_MAILBOX_BITS) >> IRQ_LOCAL_MAILBOX_SHIFT);
+    if (timers)     LOCAL->TIMER_IRQ_CTRL[core] &= ~timers;
+    if (mailboxes)  LOCAL->MAILBOX_IRQ_CTRL[core] &= ~mailboxes;
+
+    return timers | (mailboxes << IRQ_LOCAL_MAILBOX_SHIFT);
+}
+
+/**
+ * @brief       Enable again the local sources masked by irq_mask_local().
+ * 
+ * @param core      Calling core.
+ * @param masked    Value returned by irq_mask_local().
  */
-void enable_interrupt_controller(void) 
+SECTION_HOT static void irq_unmask_local(uint8_t core, uint32_t masked)
 {
-    // Enable IRQs
-    IRQ_REG->EnableIRQs1 = AUX_IRQ | TIMER_1_IRQ;
+    if (masked & IRQ_LOCAL_TIMER_BITS)      LOCAL->TIMER_IRQ_CTRL[core] |= masked & IRQ_LOCAL_TIMER_BITS;
+    if (masked >> IRQ_LOCAL_MAILBOX_SHIFT)  LOCAL->MAILBOX_IRQ_CTRL[core] |= masked >> IRQ_LOCAL_MAILBOX_SHIFT;
+}
+
+/**
+ * @brief       Collect the pending sources of the calling core.
+ * @description Fills `pending[0]` with GPU sources 0-63 and `pending[1]` with the basic
+ *              sources (bits 0-7) and the local sources (bits 8-19). The GPU registers
+ *              are only read when the GPU interrupt is routed to this core, and pending
+ *              registers 1 and 2 only when the basic register flags them; the shortcut
+ *              bits of the basic register cover the most frequent GPU sources without
+ *              reading them.
+ * 
+ * @param core      Calling core.
+ * @param pending   Filled with the pending sources.
+ */
+SECTION_HOT static void irq_read_pending(uint8_t core, uint64_t pending[2])
+{
+    uint32_t local;
+    uint32_t basic;
+    uint32_t shortcuts;
+    uint32_t bit;
+
+    local = LOCAL->IRQ_SOURCE[core];
+    pending[0] = 0;
+    pending[1] = (uint64_t)(local & IRQ_LOCAL_SOURCE_MASK) << (IRQ_LOCAL(0) - IRQ_BASIC(0));
+
+    if ((local & LOCAL_IRQ_GPU) == 0)
+    {
+        return;
+    }
+
+    basic = IRQ_REG->IRQBasicPending;
+    pending[1] |= basic & IRQ_BASIC_ARM_MASK;
+
+    if (basic & IRQ_BASIC_PENDING1)
+    {
+        pending[0] |= IRQ_REG->IRQPending1;
+    }
+
+    if (basic & IRQ_BASIC_PENDING2)
+    {
+        pending[0] |= (uint64_t)IRQ_REG->IRQPending2 << 32;
+    }
+
+    // Translate the shortcut bits to their GPU sources
+    shortcuts = (basic >> IRQ_BASIC_SHORTCUT_SHIFT) & ((1 << IRQ_BASIC_SHORTCUTS) - 1);
+    while (shortcuts)
+    {
+        bit = 31 - __builtin_clz(shortcuts);
+        shortcuts &= ~(1U << bit);
+        pending[0] |= 1ULL << irq_shortcut_map[bit];
+    }
+}
+
+/**
+ * @brief       Find the most urgent pending source.
+ * @description Scans the priorities from the most urgent one and uses count-leading-zeros
+ *              to pick a source within a priority.
+ * 
+ * @param pending   Pending sources, see irq_read_pending().
+ * @param limit     Only priorities strictly more urgent than `limit` are considered.
+ * 
+ * @return      The IRQ number, or -1 if no source qualifies.
+ */
+SECTION_HOT static int irq_find_next(const uint64_t pending[2], uint8_t limit)
+{
+    uint64_t registered[2];
+    uint64_t m;
+    uint8_t prio;
+
+    for (prio = 0; prio < limit; prio++)
+    {
+        m = pending[0] & irq_prio_mask[prio][0];
+        if (m)
+        {
+            return 63 - __builtin_clzll(m);
+        }
+
+        m = pending[1] & irq_prio_mask[prio][1];
+        if (m)
+        {
+            return IRQ_BASIC(0) + 63 - __builtin_clzll(m);
+        }
+    }
+
+    // Pending sources without a handler: report the first one so it gets masked
+    registered[0] = 0;
+    registered[1] = 0;
+    for (prio = 0; prio < NR_IRQ_PRIO; prio++)
+    {
+        registered[0] |= irq_prio_mask[prio][0];
+        registered[1] |= irq_prio_mask[prio][1];
+    }
+
+    m = pending[0] & ~registered[0];
+    if (m)
+    {
+        return 63 - __builtin_clzll(m);
+    }
+
+    m = pending[1] & ~registered[1];
+    if (m)
+    {
+        return IRQ_BASIC(0) + 63 - __builtin_clzll(m);
+    }
+
+    return -1;
+}
+
+/**
+ * @brief       Reset the interrupt controller.
+ * @description This function masks every GPU and ARM basic source. Drivers enable
+ *              their own sources with irq_register().
+ */
+SECTION_INIT void enable_interrupt_controller(void) 
+{
+    // Mask every source until a driver registers it
+    IRQ_REG->DisableIRQs1 = 0xFFFFFFFF;
+    IRQ_REG->DisableIRQs2 = 0xFFFFFFFF;
+    IRQ_REG->DisableBasicIRQs = 0xFFFFFFFF;
+}
+
+/**
+ * @brief       Register the handler of an IRQ source.
+ * 
+ * @param irq_no    IRQ number (IRQ_GPU(n), IRQ_BASIC(n) or IRQ_LOCAL(n)).
+ * @param handler   Handler.
+ * @param priority  IRQ_PRIO_HIGHEST to IRQ_PRIO_LOW.
+ * 
+ * @return      0 on success, -1 if the IRQ number or the priority is invalid, or if
+ *              a local source that cannot be masked is below IRQ_PRIO_HIGHEST.
+ */
+int irq_register(uint32_t irq_no, irq_handler_t handler, uint8_t priority)
+{
+    uint32_t word;
+    uint64_t bit;
+    uint64_t flags;
+    uint8_t prio;
+
+    if ((irq_no >= NR_IRQS) || (priority >= NR_IRQ_PRIO) || (handler == 0))
+    {
+        return -1;
+    }
+
+    // A local source that cannot be masked per core would preempt a nested handler
+    if ((irq_no >= IRQ_LOCAL(0)) && (priority > IRQ_PRIO_HIGHEST) &&
+        !((1U << (irq_no - IRQ_LOCAL(0))) & IRQ_LOCAL_MASKABLE))
+    {
+        return -1;
+    }
+
+    word = (irq_no < IRQ_BASIC(0)) ? 0 : 1;
+    bit = 1ULL << (irq_no - (word ? IRQ_BASIC(0) : 0));
+
+    flags = spin_lock_irqsave(&irq_table_lock);
+
+    // Install the handler and move the source to its priority
+    irq_table[irq_no].handler = handler;
+    irq_table[irq_no].priority = priority;
+    for (prio = 0; prio < NR_IRQ_PRIO; prio++)
+    {
+        irq_prio_mask[prio][word] &= ~bit;
+    }
+    irq_prio_mask[priority][word] |= bit;
+
+    spin_unlock_irqrestore(&irq_table_lock, flags);
+
+    // Enable the source in the interrupt controller
+    irq_set_line(irq_no, 1);
+
+    return 0;
+}
+
+/**
+ * @brief       Route IRQ_FIQ_SOURCE to the FIQ fast path.
+ * 
+ * @param handler   FIQ handler.
+ */
+void fiq_register(irq_handler_t handler)
+{
+    uint32_t word = (IRQ_FIQ_SOURCE < IRQ_BASIC(0)) ? 0 : 1;
+    uint64_t bit = 1ULL << (IRQ_FIQ_SOURCE - (word ? IRQ_BASIC(0) : 0));
+    uint64_t flags;
+    uint8_t prio;
+
+    // A source cannot be both an IRQ and the FIQ: take it out of the dispatcher
+    irq_set_line(IRQ_FIQ_SOURCE, 0);
+    flags = spin_lock_irqsave(&irq_table_lock);
+    irq_table[IRQ_FIQ_SOURCE].handler = 0;
+    for (prio = 0; prio < NR_IRQ_PRIO; prio++)
+    {
+        irq_prio_mask[prio][word] &= ~bit;
+    }
+    spin_unlock_irqrestore(&irq_table_lock, flags);
+
+    // Publish the handler before the first FIQ can be taken
+    fiq_handler_fn = handler;
+    smp_wmb();
+
+    // Select the source and enable the FIQ
+    IRQ_REG->FIQControl = (IRQ_FIQ_SOURCE & FIQ_CONTROL_SOURCE_MASK) | FIQ_CONTROL_ENABLE;
+}
+
+/**
+ * @brief       Stop the FIQ fast path.
+ */
+void fiq_release(void)
+{
+    IRQ_REG->FIQControl = 0;
+    fiq_handler_fn = 0;
+}
+
+/**
+ * @brief       Tell whether the calling core cannot wait for an interrupt.
+ * 
+ * @return      1 in interrupt context or with IRQs masked, 0 otherwise.
+ */
+uint8_t irq_in_handler(void)
+{
+    return irq_masked() || (irq_current_prio[get_core_id()] != NR_IRQ_PRIO);
+}
+
+/**
+ * @brief       Read the entry time of the last IRQ taken by the calling core.
+ * 
+ * @return      CNTPCT_EL0 at the start of the last handle_irq() on this core.
+ */
+uint64_t irq_entry_time(void)
+{
+    return irq_entry_counter[get_core_id()];
+}
+
+/**
+ * @brief       Read the statistics of an IRQ source, summed over the cores.
+ * 
+ * @param irq_no     IRQ number.
+ * @param[out] stats Counts and times added, maxima of the cores.
+ * 
+ * @return      0, or -1 if the IRQ number is invalid.
+ */
+int irq_get_stats(uint32_t irq_no, struct irq_stats *stats)
+{
+    const struct irq_stats *core_stats;
+    int core;
+
+    if (irq_no >= NR_IRQS)
+    {
+        return -1;
+    }
+
+    stats->count = 0;
+    stats->total_ticks = 0;
+    stats->max_ticks = 0;
+    stats->max_latency = 0;
+
+    // The rows are read while their cores update them: each field is a single load
+    for (core = 0; core < NR_CORES; core++)
+    {
+        core_stats = &irq_core_stats[core][irq_no];
+        stats->count += core_stats->count;
+        stats->total_ticks += core_stats->total_ticks;
+        if (core_stats->max_ticks > stats->max_ticks)
+        {
+            stats->max_ticks = core_stats->max_ticks;
+        }
+        if (core_stats->max_latency > stats->max_latency)
+        {
+            stats->max_latency = core_stats->max_latency;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       Print the statistics of the registered IRQ sources over UART.
+ */
+void irq_dump_stats(void)
+{
+    uint64_t ticks_per_us = local_timer_get_freq() / 1000000;
+    struct irq_desc *desc;
+    struct irq_stats stats;
+    uint32_t spurious = 0;
+    uint32_t irq_no;
+    int core;
+
+    uart_printf("IRQ  prio  count       avg(t)  max(t)  maxlat(t)  (%llu t/us)\n", ticks_per_us);
+
+    for (irq_no = 0; irq_no < NR_IRQS; irq_no++)
+    {
+        desc = &irq_table[irq_no];
+        irq_get_stats(irq_no, &stats);
+        if ((desc->handler == 0) && (stats.count == 0))
+        {
+            continue;
+        }
+
+        uart_printf("%-4u %-5u %-11u %-7llu %-7llu %llu\n",
+                    irq_no, desc->priority, stats.count,
+                    stats.count ? stats.total_ticks / stats.count : 0,
+                    stats.max_ticks, stats.max_latency);
+    }
+
+    for (core = 0; core < NR_CORES; core++)
+    {
+        spurious += irq_spurious[core];
+    }
+    uart_printf("Spurious: %u\n", spurious);
 }
 
 /**
  * @brief       Handle pending IRQs.
- * @description This function processes pending interrupts and handles auxiliary
- *              device IRQs, such as UART data reception, as well as timer interrupts.
+ * @description This function dispatches the pending sources of the calling core in
+ *              priority order. The per-core tick and the other local sources are read
+ *              from the local IRQ source register; GPU interrupts (auxiliary devices such
+ *              as UART, System Timer) are only routed to core 0. With IRQ_NESTING, a
+ *              GPU or basic handler below IRQ_PRIO_HIGHEST runs with IRQs enabled while
+ *              the sources of its priority and below are masked (GPU/basic ones in the
+ *              controller, core timers and mailboxes in the local control registers of
+ *              the core), so only more urgent sources can preempt it. ELR_EL1/SPSR_EL1
+ *              are saved in the exception frame by entry.S.
  */
-void handle_irq(void) 
+SECTION_HOT void handle_irq(void) 
 {
-    uint32_t irq;
-    float temp = 0;
-    float hum = 0;
+    uint8_t core = get_core_id();
+    uint8_t prev = irq_current_prio[core];
+    uint64_t entry = local_timer_get_counter();
+    uint64_t pending[2];
+    uint64_t start;
+    uint64_t ticks;
+    struct irq_desc *desc;
+    struct irq_stats *stats;
+    uint32_t local_masked;
+    int irq_no;
+
+    PROF_SCOPE(PROF_PROBE_IRQ);
 
-    // Read pending IRQs from the interrupt register
-    irq = IRQ_REG->IRQPending1;
+    irq_entry_counter[core] = entry;
 
-    // Process all pending IRQs
-    while (irq)
+    while (1)
     {
-        // Check if the IRQ is from the auxiliary device (e.g., UART)
-        if (irq & AUX_IRQ)
+        // Most urgent source that may run at the current level
+        irq_read_pending(core, pending);
+        irq_no = irq_find_next(pending, prev);
+        if (irq_no < 0)
         {
-            // Clear the AUX_IRQ flag to acknowledge the interrupt
-            irq &= ~AUX_IRQ;
+            break;
+        }
 
-            // Handle UART data while it is available
-            while ((AUX->MU_IIR_REG & 4) == 4) 
+        desc = &irq_table[irq_no];
+        if (desc->handler == 0)
+        {
+            // No handler: mask the source so it cannot storm
+            irq_set_line(irq_no, 0);
+            irq_spurious[core]++;
+            if (irq_no >= IRQ_LOCAL(0))
             {
-                // Log received UART data
-                uart_printf("UART Recv: ");   
-                // Echo the received data back
-                uart_send(uart_recv());       
-                // Send a newline for clarity
-                uart_printf("\t\n");          
+                // Local sources cannot be masked here
+                break;
             }
+            continue;
         }
 
-        // Check if the interrupt is from Timer 1
-        if (irq & TIMER_1_IRQ)
+        start = local_timer_get_counter();
+
+        if (IRQ_NESTING && (desc->priority > IRQ_PRIO_HIGHEST) && (irq_no < IRQ_LOCAL(0)))
         {
-            // Clear the TIMER_1_IRQ flag to acknowledge the interrupt
-            irq &= ~TIMER_1_IRQ;
+            // Mask this level and the less urgent ones, then let more urgent sources in
+            irq_set_priority_range(desc->priority, prev, 0);
+            local_masked = irq_mask_local(core, desc->priority, prev);
+            irq_current_prio[core] = desc->priority;
+            irq_enable();
 
-            // Call the timer handler for Timer 1
-            handle_timer(TIMER_1);
+            desc->handler();
 
-            dht22_read(&temp, &hum);
+            irq_disable();
+            irq_current_prio[core] = prev;
+            irq_unmask_local(core, local_masked);
+            irq_set_priority_range(desc->priority, prev, 1);
         }
-
-        // Check if the interrupt is from Timer 3
-        if (irq & TIMER_3_IRQ)
+        else
         {
-            // Clear the TIMER_3_IRQ flag to acknowledge the interrupt
-            irq &= ~TIMER_3_IRQ;
+            desc->handler();
+        }
 
-            // Call the timer handler for Timer 3
-            handle_timer(TIMER_3);
+        // Account the run in the row of this core (IRQs are masked again here)
+        ticks = local_timer_get_counter();
+        stats = &irq_core_stats[core][irq_no];
+        stats->count++;
+        stats->total_ticks += ticks - start;
+        if ((ticks - start) > stats->max_ticks)
+        {
+            stats->max_ticks = ticks - start;
+        }
+        if ((start - entry) > stats->max_latency)
+        {
+            stats->max_latency = start - entry;
         }
     }
 }
-
@@ -14,7 +14,7 @@
 
 #include "common.h"
 #include "gpio.h"
-#include "mini_uart.h"
+#include "uart.h"
 #include "uart_printf.h"
 #include "irq.h"
 #include "timer.h"
@@ -22,14 +22,273 @@
 #include "lcd_2004.h"
 #include "i2c.h"
 #include "dht22.h"
+#include "smp.h"
+#include "local_timer.h"
+#include "klog.h"
+#include "dma.h"
+#include "page_alloc.h"
+#include "sched.h"
+#include "prof.h"
+#include "bench.h"
+#include "clock.h"
+#include "mailbox.h"
+
+// ACT LED blink half-period, DHT22 sampling period, LCD refresh period and console poll period
+#define ACT_LED_BLINK_US        500000
+#define DHT22_SAMPLE_US         2000000
+#define LCD_REFRESH_US          100000
+#define CONSOLE_POLL_US         10000
+
+// Console key printing the profile (Ctrl-P, PROFILE builds)
+#define CONSOLE_PROF_KEY        0x10
+
+/**
+ * @brief One driver of the boot sequence (see kernel_inits).
+ */
+struct kernel_init {
+    const char *name;               // Name in the init report
+    void (*init)(void);             // Brings the driver up, or starts it (asynchronous init)
+    uint64_t (*ready)(void);        // Asynchronous init: counter value at its end, 0 before; 0 if synchronous
+};
+
+static void kernel_timer_init(void);
+
+// Drivers in dependency order: the clock rates (the mini UART divisor needs the
+// core clock), the software timers (the asynchronous inits run from them), then
+// the console, so that it logs as soon as possible
+static const struct kernel_init kernel_inits[] = {
+    { "clock",   clock_init,        0 },                // Mailbox, polled
+    { "timer",   kernel_timer_init, 0 },
+    { "uart",    uart_init,         0 },
+    { "dma",     dma_init,          0 },
+    { "lcd",     lcd_init,          lcd_ready_time },   // I2C, timers; wake-up delays overlap the boot
+    { "dht22",   dht22_init,        0 },                // Timers, IRQs; settle time held by the read interval
+    { "act_led", act_led_init,      0 },
+};
+
+#define KERNEL_NR_INITS         (sizeof(kernel_inits) / sizeof(kernel_inits[0]))
+
+// Counter values at the start of kernel_main and of each init, and the duration of each init
+static uint64_t kernel_boot_start;
+static uint64_t kernel_init_start[KERNEL_NR_INITS];
+static uint64_t kernel_init_ticks[KERNEL_NR_INITS];
+
+// Asynchronous inits not reported yet (bit per entry of kernel_inits)
+static uint32_t kernel_init_pending;
+
+/**
+ * @brief Runs the software timers on System Timer channel 1 (sleep_us() needs them).
+ */
+static void kernel_timer_init(void)
+{
+    timer_init(TIMER_1);
+}
+
+/**
+ * @brief Prints the board revision, the memory split and the clock rates.
+ */
+static void kernel_print_board(void)
+{
+    uint32_t revision;
+    uint32_t arm_base;
+    uint32_t arm_size;
+    uint32_t vc_base;
+    uint32_t vc_size;
+    uint32_t min_hz;
+    uint32_t max_hz;
+
+    if (mbox_get_board_revision(&revision) == MBOX_OK)
+    {
+        uart_printf("Board revision : %x\n", revision);
+    }
+
+    if ((mbox_get_arm_memory(&arm_base, &arm_size) == MBOX_OK) &&
+        (mbox_get_vc_memory(&vc_base, &vc_size) == MBOX_OK))
+    {
+        uart_printf("Memory split : ARM %u MB, VideoCore %u MB\n", arm_size >> 20, vc_size >> 20);
+    }
+
+    clock_get_arm_range(&min_hz, &max_hz);
+    uart_printf("ARM clock : %u MHz (%u - %u MHz)\n", clock_get_arm_hz() / 1000000,
+                min_hz / 1000000, max_hz / 1000000);
+    uart_printf("Core clock : %u MHz\n", clock_get_core_hz() / 1000000);
+}
+
+/**
+ * @brief Converts generic counter ticks to microseconds.
+ * 
+ * @param ticks Counter ticks.
+ * @return      Microseconds.
+ */
+static uint32_t kernel_ticks_to_us(uint64_t ticks)
+{
+    return (uint32_t)((ticks * 1000000) / local_timer_get_freq());
+}
+
+/**
+ * @brief Runs the inits of kernel_inits in order and times each of them.
+ * 
+ * An asynchronous init is timed up to its return here; its end is reported
+ * later by kernel_init_poll().
+ */
+static void kernel_init_run(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < KERNEL_NR_INITS; i++)
+    {
+        kernel_init_start[i] = local_timer_get_counter();
+        kernel_inits[i].init();
+        kernel_init_ticks[i] = local_timer_get_counter() - kernel_init_start[i];
+
+        if (kernel_inits[i].ready != 0)
+        {
+            kernel_init_pending |= 1U << i;
+        }
+    }
+}
+
+/**
+ * @brief Prints the duration of each init, from kernel_main.
+ */
+static void kernel_init_report(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < KERNEL_NR_INITS; i++)
+    {
+        uart_printf("Init %s : %u us%s\n", kernel_inits[i].name, kernel_ticks_to_us(kernel_init_ticks[i]),
+                    (kernel_init_pending & (1U << i)) ? " (started)" : "");
+    }
+    uart_printf("Boot : %u us\n", kernel_ticks_to_us(local_timer_get_counter() - kernel_boot_start));
+}
+
+/**
+ * @brief Logs the asynchronous inits that completed since the last call.
+ * 
+ * Called by the console task; the durations come from the end time recorded by
+ * each driver, so they do not depend on the polling period.
+ */
+static void kernel_init_poll(void)
+{
+    uint64_t end;
+    uint32_t i;
+
+    if (kernel_init_pending == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < KERNEL_NR_INITS; i++)
+    {
+        if (!(kernel_init_pending & (1U << i)))
+        {
+            continue;
+        }
+
+        end = kernel_inits[i].ready();
+        if (end != 0)
+        {
+            kernel_init_pending &= ~(1U << i);
+            klog("Init %s : ready after %u us\n", kernel_inits[i].name, kernel_ticks_to_us(end - kernel_init_start[i]));
+        }
+    }
+}
+
+/**
+ * @brief Software timer callback: ACT LED blink.
+ * 
+ * @param arg Unused.
+ */
+static void act_led_tick(void *arg)
+{
+    (void)arg;
+    act_led_toggle();
+}
+
+/**
+ * @brief Console task: echoes the received characters and formats the log records.
+ * 
+ * @param arg Unused.
+ */
+static void console_task(void *arg)
+{
+    char c;
+
+    (void)arg;
+
+    while (1)
+    {
+        // Echo the characters received by the UART interrupt
+        while (uart_try_recv(&c))
+        {
+            // Log and echo the received data back
+            klog("UART Recv: %c\t\n", c);
+
+            if (c == CONSOLE_PROF_KEY)
+            {
+                prof_dump();
+            }
+        }
+
+        // Report the asynchronous inits that completed
+        kernel_init_poll();
+
+        // Format the deferred log records
+        klog_drain();
+
+        sleep_us(CONSOLE_POLL_US);
+    }
+}
+
+/**
+ * @brief Sensor task: samples the DHT22 (the reads also feed its history).
+ * 
+ * @param arg Unused.
+ */
+static void sensor_task(void *arg)
+{
+    struct dht22_sample sample;
+
+    (void)arg;
+
+    while (1)
+    {
+        // Blocks until the capture completes; the other tasks run meanwhile
+        if (dht22_read(&sample) == DHT22_OK)
+        {
+            klog("DHT22: %.1f C %.1f %%RH\n", sample.temperature, sample.humidity);
+        }
+
+        sleep_us(DHT22_SAMPLE_US);
+    }
+}
+
+/**
+ * @brief LCD task: pushes the changes of the shadow buffer to the display.
+ * 
+ * @param arg Unused.
+ */
+static void lcd_task(void *arg)
+{
+    (void)arg;
+
+    while (1)
+    {
+        lcd_flush();
+        sleep_us(LCD_REFRESH_US);
+    }
+}
 
 /**
  * @brief The main entry point for the kernel.
  * 
  * This function is executed when the kernel starts. It performs the following actions:
  * 1. Initializes the GPIO system by calling gpio_init().
- * 2. Initializes the UART system for serial communication by calling uart_init().
- * 3. Sends an initial message via UART to notify that the kernel is initializing.
+ * 2. Runs the driver inits of kernel_inits, the UART console first; the slow
+ *    devices finish their init in the background.
+ * 3. Sends an initial message via UART to notify that the kernel is initializing,
+ *    with the time spent in each init.
  * 4. Enters an infinite loop, where it continuously receives characters over UART
  *    and sends them back (echoing).
  * 
@@ -40,27 +299,35 @@
  */
 int kernel_main(void)
 {
+    // Reference of the boot times in the init report
+    kernel_boot_start = local_timer_get_counter();
+
+    // Hand the RAM above the kernel to the page allocator (asks the firmware for its size)
+    page_alloc_init();
+
     // Initialize the GPIO system
     gpio_init();
 
+    // Switch the time base to the generic timer (before any delay is used)
+    local_timer_init();
+
+    // Count cycles and PMU events for the profiling probes (PROFILE builds)
+    prof_core_init();
+
     // Initializes the IRQ vector table to handle interrupts
     irq_init();
 
-    // Configures the interrupt controller to enable IRQ handling
+    // Mask every source; drivers register and enable their own
     enable_interrupt_controller();
 
+    // Start the private tick of core 0
+    local_timer_core_init();
+
     // Enables interrupts by clearing the DAIF register, allowing IRQs to be serviced
     irq_enable();
 
-    lcd_init();
-
-    dht22_init();
-
-    // Initialize the UART system for serial communication
-    uart_init();
-
-    // Initialize the ACT LED GPIO pin
-    act_led_init();
+    // Start the drivers: none of them waits for its device, the console comes up first
+    kernel_init_run();
 
     // Send an initialization message
     uart_printf("Raspberry PI bare metal kernel initialization... \n");
@@ -74,8 +341,31 @@ int kernel_main(void)
     // Prints the current Stack Pointer (SP) value using UART
     uart_printf("Curren SP : %i\n", get_sp());
 
-    // Initialize Timer 1 for a specific configuration (e.g., periodic interrupts or one-shot mode)
-    timer_init(TIMER_1);
+    // Board, memory split and clocks, as reported by the firmware
+    kernel_print_board();
+
+    // Memory left to the page allocator
+    uart_printf("Free memory : %i KB\n", page_free_count() * (PAGE_SIZE / 1024));
+
+    // Time spent in each init
+    kernel_init_report();
+
+#if BENCH
+    // Benchmark image (make bench): run the suite on an otherwise idle system, then stop;
+    // the LCD test needs the end of its init, run here as deferred work of core 0
+    while (lcd_ready_time() == 0)
+    {
+        smp_poll();
+    }
+    bench_run();
+    while(1)
+    {
+        cpu_wait_interrupt();
+    }
+#endif
+
+    // Blink the ACT LED periodically
+    timer_add(TIMER_PERIODIC, ACT_LED_BLINK_US, act_led_tick, 0);
 
     lcd_set_cursor(0,0);
     lcd_print("Hello LCD");
@@ -85,10 +375,24 @@ int kernel_main(void)
     lcd_print("+");
     lcd_set_cursor(0,3);
     lcd_print("YASSINE");
-    // Infinite loop
+
+    // Release cores 1-3; they serve their work queues from now on
+    smp_init();
+
+    // This context becomes the idle task; the console, the sensor and the LCD run as tasks
+    sched_init();
+    task_create("console", console_task, 0, TASK_PRIO_NORMAL);
+    task_create("sensor", sensor_task, 0, TASK_PRIO_NORMAL);
+    task_create("lcd", lcd_task, 0, TASK_PRIO_LOW);
+
+    // Idle loop
     while(1)
     {
-
+        // Run the work queued for core 0 and the shared work, then the ready tasks
+        if (smp_poll() == 0)
+        {
+            sched_idle();
+        }
     }
 
     // Return 0 (this return is never actually reached)
@@ -0,0 +1,154 @@
+/**
+ * @file        klog.c
+ * @brief       Deferred binary kernel log.
+ * @description This file implements the per-core record rings of the deferred log.
+ *              Each ring has a single producer, its own core (IRQs are masked while a
+ *              record is written, so an interrupt cannot interleave with the thread it
+ *              interrupted), and a single consumer, klog_drain(), serialized by a
+ *              trylock. The drain merges the rings in timestamp order.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "klog.h"
+#include "base.h"
+#include "timer.h"
+#include "irq.h"
+#include "atomic.h"
+#include "spinlock.h"
+#include "utils.h"
+#include "sections.h"
+
+/**
+ * @brief Ring of records of one core.
+ */
+struct klog_ring {
+    volatile uint32_t head;                         // Next record to write (owner core)
+    volatile uint32_t tail;                         // Next record to print (drain)
+    volatile uint32_t dropped;                      // Records lost because the ring was full
+    struct klog_record records[KLOG_RING_SIZE];     // Circular storage
+};
+
+// One ring per core
+static struct klog_ring klog_rings[NR_CORES];
+
+// Only one core drains at a time
+static spinlock_t klog_drain_lock = SPINLOCK_INIT;
+
+/**
+ * @brief Stores a log record in the ring of the calling core.
+ */
+SECTION_HOT void klog_write(const char *format, uint32_t nargs, const uint64_t *args)
+{
+    struct klog_ring *ring = &klog_rings[get_core_id()];
+    struct klog_record *rec;
+    uint64_t flags;
+    uint32_t head;
+    uint32_t i;
+
+    // Serialize with the interrupt handlers of this core.
+    flags = irq_save();
+
+    head = ring->head;
+    if ((head - ring->tail) >= KLOG_RING_SIZE)
+    {
+        // Ring full: keep the older records, count the loss.
+        atomic_add_return(&ring->dropped, 1);
+        irq_restore(flags);
+        return;
+    }
+
+    if (nargs > KLOG_MAX_ARGS)
+    {
+        nargs = KLOG_MAX_ARGS;
+    }
+
+    // Fill the record in place.
+    rec = &ring->records[head & (KLOG_RING_SIZE - 1)];
+    rec->timestamp = timer_get_ticks();
+    rec->format = format;
+    rec->nargs = nargs;
+    for (i = 0; i < nargs; i++)
+    {
+        rec->args[i] = args[i];
+    }
+
+    // Publish the record to the drain.
+    smp_wmb();
+    ring->head = head + 1;
+
+    irq_restore(flags);
+}
+
+/**
+ * @brief Formats and prints the pending records of all cores.
+ */
+uint32_t klog_drain(void)
+{
+    struct klog_ring *ring;
+    struct klog_record *rec;
+    uint32_t count = 0;
+    uint32_t dropped;
+    int oldest;
+    int core;
+
+    if (!spin_trylock(&klog_drain_lock))
+    {
+        return 0;
+    }
+
+    while (1)
+    {
+        oldest = -1;
+
+        // Pick the oldest pending record across the cores.
+        for (core = 0; core < NR_CORES; core++)
+        {
+            ring = &klog_rings[core];
+
+            if (ring->tail == ring->head)
+            {
+                continue;
+            }
+
+            smp_rmb();
+            rec = &ring->records[ring->tail & (KLOG_RING_SIZE - 1)];
+            if ((oldest < 0) || (rec->timestamp < klog_rings[oldest].records[klog_rings[oldest].tail & (KLOG_RING_SIZE - 1)].timestamp))
+            {
+                oldest = core;
+            }
+        }
+
+        if (oldest < 0)
+        {
+            break;
+        }
+
+        // Print it, prefixed with its timestamp and core.
+        ring = &klog_rings[oldest];
+        rec = &ring->records[ring->tail & (KLOG_RING_SIZE - 1)];
+        uart_printf("[%llu:%d] ", rec->timestamp, oldest);
+        uart_printf_args(rec->format, rec->args, rec->nargs);
+
+        // Hand the slot back to the producer once the record has been read.
+        smp_mb();
+        ring->tail++;
+        count++;
+    }
+
+    // Report the records lost since the previous drain.
+    for (core = 0; core < NR_CORES; core++)
+    {
+        dropped = klog_rings[core].dropped;
+        if (dropped != 0)
+        {
+            atomic_sub_return(&klog_rings[core].dropped, dropped);
+            uart_printf("klog: %u records dropped on core %d\n", dropped, core);
+        }
+    }
+
+    spin_unlock(&klog_drain_lock);
+
+    return count;
+}
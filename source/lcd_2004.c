@@ -4,8 +4,10 @@
  * @description This source file implements the functions to interface with and 
  *              control the 20x4 character LCD module over I2C. It includes the 
  *              initialization process, sending commands, displaying characters, 
- *              and handling I2C communication for the LCD.
- *
+ *              and handling I2C communication for the LCD. Text is drawn into an
+ *              in-RAM shadow of the screen; lcd_flush() sends only the cells that
+ *              changed since the last flush.
+ * 
  * @version     1.0
  * @date        2024-12-19
  */
@@ -15,74 +17,137 @@
 #include "lcd_2004.h"
 #include "i2c.h"
 #include "timer.h"
+#include "format.h"
+#include "spinlock.h"
+#include "deferred_work.h"
+#include "mm.h"
+#include "prof.h"
+#include "local_timer.h"
+#include "atomic.h"
+#include "sections.h"
 
 // Static variables
 static const uint8_t row_offsets[4] = {0x00, 0x40, 0x14, 0x54}; ///< Row offsets for the 20x4 LCD (addresses of the rows)
 static uint8_t backlight = LCD_BACKLIGHT; ///< Current backlight state (on or off)
+static char lcd_shadow[LCD_ROWS][LCD_COLUMNS]; ///< Screen as drawn by the API
+static char lcd_flushed[LCD_ROWS][LCD_COLUMNS]; ///< Screen as last sent to the LCD
+static uint8_t lcd_col; ///< Shadow cursor column
+static uint8_t lcd_row; ///< Shadow cursor row
+static volatile uint32_t lcd_dirty; ///< Shadow differs from the LCD (cleared by a flush)
+static spinlock_t lcd_lock = SPINLOCK_INIT; ///< Protects the shadow and the cursor
+static spinlock_t lcd_flush_lock = SPINLOCK_INIT; ///< Serializes flushes (owner of lcd_flushed)
+static uint32_t lcd_init_next; ///< Next step of the init sequence (owned by the init work)
+static volatile uint64_t lcd_ready_ticks; ///< Counter value at the end of the init sequence, 0 before
+
+/**
+ * @brief One step of the HD44780 init sequence: a command and the wait after it.
+ */
+struct lcd_init_step {
+    uint8_t cmd; ///< Command sent
+    uint16_t wait_us; ///< Execution time of the command (µs)
+};
+
+// Wake-up sequence (4-bit mode), then the display settings
+static const struct lcd_init_step lcd_init_steps[] = {
+    { LCD_WAKE_UP, 5000 }, ///< Wake up sequence (HD44780-specific)
+    { LCD_WAKE_UP, 160 }, ///< Repeat wake up sequence
+    { LCD_WAKE_UP, 160 }, ///< Final wake up sequence
+    { LCD_CMD_FUNCTION_SET | LCD_4BIT_MODE, 160 }, ///< Switch to 4-bit mode
+    { LCD_CMD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8DOTS, 160 }, ///< 2-line, 5x8 font mode
+    { LCD_CMD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF, 160 }, ///< Display on, cursor off, blink off
+    { LCD_CMD_CLEAR_DISPLAY, 2000 }, ///< Clear the display
+    { LCD_CMD_ENTRY_MODE_SET | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT, 160 }, ///< Set entry mode
+    { LCD_CMD_RETURN_HOME, 2000 }, ///< Cursor home
+};
 
 // Function prototypes
-static void lcd_write(uint8_t data); ///< Function to write a byte to the LCD
-static void lcd_pulse(uint8_t data); ///< Function to set the ENABLE pin high and then low to latch the data
+static uint32_t lcd_encode(uint8_t *out, uint8_t data, uint8_t mode); ///< Function to encode a byte into expander writes
+static void lcd_send_burst(const uint8_t *data, uint32_t count, uint8_t mode); ///< Function to send bytes in one I2C transfer
 static void lcd_send(uint8_t data, uint8_t mode); ///< Function to send a byte (command/data) to the LCD
 static void lcd_write_command(uint8_t cmd); ///< Function to send a command to the LCD
-static void lcd_write_data(uint8_t data); ///< Function to send data (character) to the LCD
+static void lcd_refresh_tick(void *arg); ///< Function to queue a flush from the refresh timer
+static void lcd_refresh_work(void *arg); ///< Function to run a flush as deferred work
+static void lcd_init_tick(void *arg); ///< Function to queue the next init step from its timer
+static void lcd_init_work(void *arg); ///< Function to run the init steps as deferred work
+
+static struct deferred_work lcd_flush_work = DEFERRED_WORK_INIT(lcd_refresh_work, 0); ///< Flush bottom half
+static struct deferred_work lcd_init_step_work = DEFERRED_WORK_INIT(lcd_init_work, 0); ///< Init bottom half
 
 /**
- * @brief Writes a byte to the LCD over I2C.
+ * @brief Encodes a byte into the PCF8574 writes that clock it into the LCD.
  * 
- * This function sends a single byte to the LCD module through the I2C interface.
+ * Each nibble becomes three expander writes: set up the lines, raise ENABLE,
+ * lower ENABLE (the falling edge latches the nibble). The I2C bus provides the
+ * timing: one expander byte takes 9 SCL cycles (90µs at 100 kHz), well over the
+ * enable pulse width and the 37µs execution time of a write.
  * 
- * @param data Byte to send to the LCD.
+ * @param out  Destination, LCD_BYTES_PER_CHAR bytes.
+ * @param data The byte to send (command or data).
+ * @param mode Mode for the data: 0 for command, REGISTER_SELECT for data.
+ * @return     Number of bytes written to out.
  */
-static void lcd_write(uint8_t data)
+static uint32_t lcd_encode(uint8_t *out, uint8_t data, uint8_t mode)
 {
-    uint8_t status = 0;
+    uint8_t high_nibble = (data & 0xF0) | mode | backlight; ///< High nibble (upper 4 bits) with control lines
+    uint8_t low_nibble = ((data << 4) & 0xF0) | mode | backlight; ///< Low nibble (lower 4 bits) with control lines
 
-    data = data | backlight; ///< Add the backlight state to the data byte
-    status = i2c_write(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, &data, 1); ///< Send the data over I2C
-    if (status != 0)
-    {
-        // Handle errors (optional)
-    }
+    out[0] = high_nibble;           ///< Set up the high nibble
+    out[1] = high_nibble | ENABLE;  ///< ENABLE high
+    out[2] = high_nibble;           ///< ENABLE low: latch
+    out[3] = low_nibble;            ///< Set up the low nibble
+    out[4] = low_nibble | ENABLE;   ///< ENABLE high
+    out[5] = low_nibble;            ///< ENABLE low: latch
+
+    return LCD_BYTES_PER_CHAR;
 }
 
 /**
- * @brief Generates an enable pulse for the LCD.
+ * @brief Sends a sequence of bytes to the LCD.
  * 
- * This function sets the ENABLE pin high and then low to latch the data
- * sent to the LCD. It includes the necessary delays for the pulse width.
+ * The expander writes for the whole sequence are encoded into one buffer and sent
+ * as a single multi-byte I2C transfer (split every LCD_BURST_CHARS bytes).
  * 
- * @param data The data to send to the LCD with the ENABLE bit toggled.
+ * @param data  The bytes to send.
+ * @param count Number of bytes.
+ * @param mode  Mode for the data: 0 for command, REGISTER_SELECT for data.
  */
-static void lcd_pulse(uint8_t data)
+static void lcd_send_burst(const uint8_t *data, uint32_t count, uint8_t mode)
 {
-    lcd_write(data | ENABLE);  ///< Set ENABLE bit high
-    delay_micro_s(1);          ///< Wait for the enable pulse width
-    lcd_write(data & ~ENABLE); ///< Set ENABLE bit low
-    delay_micro_s(1);          ///< Wait for command to latch
+    uint8_t burst[LCD_BURST_CHARS * LCD_BYTES_PER_CHAR]; ///< Encoded expander writes
+    uint32_t length;
+    int status;
+
+    while (count)
+    {
+        length = 0;
+        while (count && (length < sizeof(burst)))
+        {
+            length += lcd_encode(&burst[length], *data++, mode); ///< Encode the next byte
+            count--;
+        }
+
+        status = i2c_write(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, burst, length); ///< Send the burst over I2C
+        if (status != I2C_OK)
+        {
+            // Handle errors (optional)
+        }
+    }
 }
 
 /**
  * @brief Sends a command or data to the LCD.
  * 
  * This function sends high and low nibbles of the given byte to the LCD,
- * controlling the RS pin and the backlight state.
+ * controlling the RS pin and the backlight state, in one I2C transfer.
  * 
  * @param data The byte to send (command or data).
  * @param mode Mode for the data: 0 for command, REGISTER_SELECT for data.
  */
 static void lcd_send(uint8_t data, uint8_t mode)
 {
-    uint8_t high_nibble = data & 0xF0; ///< Extract the high nibble (upper 4 bits)
-    uint8_t low_nibble = (data << 4) & 0xF0; ///< Extract the low nibble (lower 4 bits)
-
-    // Send high nibble
-    lcd_write(high_nibble | mode); ///< Prepare high nibble with the appropriate mode
-    lcd_pulse(high_nibble | mode); ///< Pulse to latch the high nibble
+    PROF_SCOPE(PROF_PROBE_LCD_SEND);
 
-    // Send low nibble
-    lcd_write(low_nibble | mode); ///< Prepare low nibble with the appropriate mode
-    lcd_pulse(low_nibble | mode); ///< Pulse to latch the low nibble
+    lcd_send_burst(&data, 1, mode); ///< Six expander writes, one transaction
 }
 
 /**
@@ -100,58 +165,95 @@ static void lcd_write_command(uint8_t cmd)
 }
 
 /**
- * @brief Sends data to the LCD.
+ * @brief Init step timer callback: queues the next step.
  * 
- * Data is displayed as characters on the LCD. The RS pin is set to indicate data mode.
+ * @param arg Unused.
+ */
+static void lcd_init_tick(void *arg)
+{
+    (void)arg;
+
+    deferred_work_schedule(&lcd_init_step_work); ///< The transfers sleep: not in IRQ context
+}
+
+/**
+ * @brief Deferred init step: sends the next command and arms the timer of its wait.
+ * 
+ * Falls back to sleeping in place when no timer is available, so the sequence
+ * always completes.
  * 
- * @param data Byte to send as data.
+ * @param arg Unused.
  */
-static void lcd_write_data(uint8_t data)
+static void lcd_init_work(void *arg)
 {
-    lcd_send(data, REGISTER_SELECT); ///< Send the data (mode REGISTER_SELECT indicates data mode)
+    const struct lcd_init_step *step;
+
+    (void)arg;
+
+    while (lcd_init_next < sizeof(lcd_init_steps) / sizeof(lcd_init_steps[0]))
+    {
+        step = &lcd_init_steps[lcd_init_next++];
+        lcd_write_command(step->cmd);
+
+        if (timer_add(TIMER_ONESHOT, step->wait_us, lcd_init_tick, 0) >= 0)
+        {
+            return; ///< Continued from the timer
+        }
+        sleep_us(step->wait_us);
+    }
+
+    // The display is set up and blank, like lcd_flushed: flushes may start
+    smp_wmb();
+    lcd_ready_ticks = local_timer_get_counter();
 }
 
 /**
- * @brief Initializes the 20x4 LCD module.
+ * @brief Starts the initialization of the 20x4 LCD module.
  * 
- * This function initializes the GPIO pins, configures the I2C interface,
- * and sets up the LCD module in 4-bit mode with the desired display settings.
+ * This function initializes the GPIO pins, configures the I2C interface and
+ * the shadow, then returns: the power-up wait and the HD44780 wake-up sequence
+ * (about 60 ms) run from timer callbacks and deferred work. Drawing can start
+ * at once; lcd_flush() sends nothing until lcd_ready_time() is set.
  */
-void lcd_init(void)
+SECTION_INIT void lcd_init(void)
 {
-    // Configure GPIO pins for I2C communication
-    gpio_set_pin_function(SDA_PIN, GPIO_ALT0); ///< Set SDA to I2C function
-    gpio_set_pin_function(SCL_PIN, GPIO_ALT0); ///< Set SCL to I2C function
-    gpio_pull_up_down(SDA_PIN, GPIO_PUD_UP); ///< Disable pull-up/down on SDA pin
-    gpio_pull_up_down(SCL_PIN, GPIO_PUD_UP); ///< Disable pull-up/down on SCL pin
+    // Configure GPIO pins for I2C communication: both in one GPFSEL write and one pull sequence
+    static const struct gpio_pin_config lcd_i2c_pins[] = {
+        { SDA_PIN, GPIO_ALT0, GPIO_PUD_UP }, ///< SDA: I2C function, pulled up
+        { SCL_PIN, GPIO_ALT0, GPIO_PUD_UP }, ///< SCL: I2C function, pulled up
+    };
+    gpio_config_pins(lcd_i2c_pins, sizeof(lcd_i2c_pins) / sizeof(lcd_i2c_pins[0]));
 
     // Initialize I2C controller for communication
-    i2c_init(I2C_CONTROLLER_1, LCD_I2C_DIVIDER); ///< Set I2C clock speed to 100 kHz
-
-    // Wait for LCD to power on and stabilize
-    delay_micro_s(50000); ///< Wait 50ms for power stabilization
-
-    // Initialize LCD in 4-bit mode using wake-up sequence
-    lcd_write_command(0x03); ///< Wake up sequence (HD44780-specific)
-    delay_micro_s(5000);  ///< Wait 5ms
-    lcd_write_command(0x03); ///< Repeat wake up sequence
-    delay_micro_s(160);   ///< Wait 160µs
-    lcd_write_command(0x03); ///< Final wake up sequence
-    delay_micro_s(160);   ///< Wait 160µs
-    lcd_write_command(LCD_CMD_FUNCTION_SET | LCD_4BIT_MODE); ///< Switch to 4-bit mode
-    delay_micro_s(160);   ///< Wait 160µs
-
-    // Configure LCD display settings
-    lcd_write_command(LCD_CMD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8DOTS); ///< 2-line, 5x8 font mode
-    delay_micro_s(160);   ///< Wait 160µs
-    lcd_write_command(LCD_CMD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF); ///< Display on, cursor off, blink off
-    delay_micro_s(160);   ///< Wait 160µs
-    lcd_write_command(LCD_CMD_CLEAR_DISPLAY); ///< Clear the display
-    delay_micro_s(2000);  ///< Wait 2ms for clear display
-    lcd_write_command(LCD_CMD_ENTRY_MODE_SET | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT); ///< Set entry mode
-    delay_micro_s(160);   ///< Wait 160µs
-    lcd_write_command(LCD_CMD_RETURN_HOME); ///< Send the clear display command
-    delay_micro_s(2000);
+    i2c_init(I2C_CONTROLLER_1, i2c_speed_to_div(LCD_I2C_SPEED)); ///< Set I2C clock speed to 100 kHz
+    i2c_set_device_speed(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, LCD_I2C_SPEED); ///< PCF8574 backpack: 100 kHz max
+
+    // The display will be blank: so are the shadow and its flushed copy
+    memset(lcd_shadow, ' ', sizeof(lcd_shadow));
+    memset(lcd_flushed, ' ', sizeof(lcd_flushed));
+    lcd_col = 0;
+    lcd_row = 0;
+    lcd_dirty = 0;
+    lcd_init_next = 0;
+    lcd_ready_ticks = 0;
+
+    // Wait for LCD to power on and stabilize, then run the wake-up sequence
+    if (timer_add(TIMER_ONESHOT, LCD_POWER_UP_US, lcd_init_tick, 0) < 0)
+    {
+        sleep_us(LCD_POWER_UP_US);
+        lcd_init_work(0);
+    }
+}
+
+/**
+ * @brief Returns the end time of the initialization.
+ * 
+ * @return The generic counter value (CNTPCT_EL0) when the init sequence ended,
+ *         0 while it is in progress.
+ */
+uint64_t lcd_ready_time(void)
+{
+    return lcd_ready_ticks;
 }
 
 /**
@@ -172,61 +274,269 @@ void lcd_backlight(uint8_t on)
     }
 
     lcd_write_command(0); ///< Update the backlight state
-    delay_micro_s(37); ///< Wait for the LCD to process the command
+    sleep_us(37); ///< Wait for the LCD to process the command
 }
 
 /**
  * @brief Clears the LCD display.
  * 
- * This function clears the display and resets the cursor to the home position.
+ * This function clears the shadow and resets the cursor to the home position.
+ * The next flush blanks only the cells that were not already blank.
  */
 void lcd_clear(void)
 {
-    lcd_write_command(LCD_CMD_CLEAR_DISPLAY); ///< Send the clear display command
-    delay_micro_s(2000); ///< Wait for the LCD to process the command
+    uint64_t flags;
+
+    flags = spin_lock_irqsave(&lcd_lock);
+    memset(lcd_shadow, ' ', sizeof(lcd_shadow)); ///< Blank every cell
+    lcd_col = 0;
+    lcd_row = 0;
+    lcd_dirty = 1;
+    spin_unlock_irqrestore(&lcd_lock, flags);
 }
 
 /**
  * @brief Moves the cursor to the home position on the LCD.
  * 
- * This function sends the "Return Home" command to the LCD, which resets the
- * cursor to the top-left corner (position 0,0) of the display. It also resets 
- * any shifted display settings to their default state.
+ * This function resets the shadow cursor to the top-left corner (position 0,0)
+ * of the display.
  */
 void lcd_home(void)
 {
-    lcd_write_command(LCD_CMD_RETURN_HOME); ///< Send the Return Home command
-    delay_micro_s(2000); ///< Wait for the LCD to process the command
+    lcd_set_cursor(0, 0);
 }
 
 
 /**
  * @brief Sets the cursor position on the LCD.
  * 
- * This function moves the cursor to the specified column and row.
+ * This function moves the shadow cursor to the specified column and row.
  * 
  * @param col The column position (0-19).
  * @param row The row position (0-3).
  */
 void lcd_set_cursor(uint8_t col, uint8_t row)
 {
-    if (row > 3) row = 3; // Cap to max row index
-    lcd_write_command(LCD_CMD_SET_DDRAM_ADDR | (col + row_offsets[row])); ///< Set DDRAM address based on column and row
-    delay_micro_s(50); ///< Wait for the LCD to process the command
+    uint64_t flags;
+
+    if (row > LCD_ROWS - 1) row = LCD_ROWS - 1; // Cap to max row index
+    if (col > LCD_COLUMNS) col = LCD_COLUMNS; // Past the last column: nothing is drawn
+
+    flags = spin_lock_irqsave(&lcd_lock);
+    lcd_col = col;
+    lcd_row = row;
+    spin_unlock_irqrestore(&lcd_lock, flags);
 }
 
 /**
  * @brief Prints a string to the LCD.
  * 
- * This function writes a null-terminated string to the LCD starting
- * from the current cursor position.
+ * This function writes a null-terminated string into the shadow starting
+ * from the current cursor position. Characters past the end of the row
+ * are dropped. Nothing is sent until the next lcd_flush().
  * 
  * @param str Pointer to the string to print.
  */
 void lcd_print(const char *str)
 {
-    while (*str)
+    uint64_t flags;
+
+    flags = spin_lock_irqsave(&lcd_lock);
+    while (*str && (lcd_col < LCD_COLUMNS))
+    {
+        if (lcd_shadow[lcd_row][lcd_col] != *str)
+        {
+            lcd_shadow[lcd_row][lcd_col] = *str; ///< Only a change makes the screen dirty
+            lcd_dirty = 1;
+        }
+        lcd_col++;
+        str++;
+    }
+    spin_unlock_irqrestore(&lcd_lock, flags);
+}
+
+/**
+ * @brief Sends the changed cells to the LCD.
+ * 
+ * The shadow is compared with the copy of the last flush. Each row with changes
+ * becomes one I2C transfer holding the cursor moves and the characters of its
+ * dirty runs; runs separated by at most LCD_FLUSH_MAX_GAP clean cells are merged
+ * (rewriting a clean cell costs the same as a cursor move). A cursor move is
+ * skipped when the LCD address already points at the run.
+ * 
+ * Must not be called from interrupt handlers: the transfers sleep. A flush that
+ * finds another one in progress returns at once; the shadow stays dirty and
+ * the next flush picks it up.
+ * 
+ * @return Number of characters sent.
+ */
+uint32_t lcd_flush(void)
+{
+    char snapshot[LCD_ROWS][LCD_COLUMNS]; ///< Shadow at the start of the flush
+    uint8_t burst[LCD_FLUSH_BURST_MAX]; ///< Encoded expander writes for one row
+    uint32_t length;
+    uint32_t sent = 0;
+    uint32_t row;
+    uint32_t col;
+    uint32_t end;
+    uint32_t gap;
+    uint32_t i;
+    uint8_t addr = 0xFF; ///< LCD address counter (unknown)
+    uint8_t target;
+    uint64_t flags;
+
+    if (lcd_ready_ticks == 0)
     {
-        lcd_write_data(*str++); ///< Write each character to the LCD
+        return 0; ///< Still initializing: the shadow stays dirty
     }
-}
\ No newline at end of file
+
+    if (!spin_trylock(&lcd_flush_lock))
+    {
+        return 0; ///< A flush is in progress
+    }
+
+    // Take a consistent snapshot; drawing can go on during the transfers
+    flags = spin_lock_irqsave(&lcd_lock);
+    if (!lcd_dirty)
+    {
+        spin_unlock_irqrestore(&lcd_lock, flags);
+        spin_unlock(&lcd_flush_lock);
+        return 0;
+    }
+    memcpy(snapshot, lcd_shadow, sizeof(snapshot));
+    lcd_dirty = 0;
+    spin_unlock_irqrestore(&lcd_lock, flags);
+
+    for (row = 0; row < LCD_ROWS; row++)
+    {
+        length = 0;
+        col = 0;
+        while (col < LCD_COLUMNS)
+        {
+            if (snapshot[row][col] == lcd_flushed[row][col])
+            {
+                col++;
+                continue;
+            }
+
+            // Extend the run over dirty cells and short clean gaps
+            end = col + 1;
+            gap = 0;
+            for (i = end; i < LCD_COLUMNS; i++)
+            {
+                if (snapshot[row][i] != lcd_flushed[row][i])
+                {
+                    end = i + 1;
+                    gap = 0;
+                }
+                else if (++gap > LCD_FLUSH_MAX_GAP)
+                {
+                    break;
+                }
+            }
+
+            // Cursor move, unless the address counter is already there
+            target = row_offsets[row] + col;
+            if (addr != target)
+            {
+                length += lcd_encode(&burst[length], LCD_CMD_SET_DDRAM_ADDR | target, LCD_CMD_MODE);
+            }
+
+            // Characters; the address counter follows
+            for (; col < end; col++)
+            {
+                length += lcd_encode(&burst[length], (uint8_t)snapshot[row][col], REGISTER_SELECT);
+                lcd_flushed[row][col] = snapshot[row][col];
+                sent++;
+            }
+            addr = row_offsets[row] + end;
+        }
+
+        if (length == 0)
+        {
+            continue;
+        }
+
+        if (i2c_write(I2C_CONTROLLER_1, LCD_I2C_ADDRESS, burst, length) != I2C_OK)
+        {
+            // The row state is unknown: rewrite it on the next flush
+            memset(lcd_flushed[row], 0, LCD_COLUMNS);
+            lcd_dirty = 1;
+            addr = 0xFF;
+        }
+    }
+
+    spin_unlock(&lcd_flush_lock);
+
+    return sent;
+}
+
+/**
+ * @brief Refresh timer callback: queues a flush when the shadow changed.
+ * 
+ * @param arg Unused.
+ */
+static void lcd_refresh_tick(void *arg)
+{
+    (void)arg;
+
+    if (lcd_dirty)
+    {
+        deferred_work_schedule(&lcd_flush_work); ///< The transfers sleep: not in IRQ context
+    }
+}
+
+/**
+ * @brief Deferred flush.
+ * 
+ * @param arg Unused.
+ */
+static void lcd_refresh_work(void *arg)
+{
+    (void)arg;
+
+    lcd_flush();
+}
+
+/**
+ * @brief Starts the periodic refresh of the LCD.
+ * 
+ * The shadow is flushed at most once per period, and only when it changed, so
+ * frequent updates cost a handful of bytes for each refresh instead of one
+ * transfer every call.
+ * 
+ * @param period_us Refresh period (µs), raised to LCD_REFRESH_MIN_US if shorter.
+ * 
+ * @return int 0, or -1 if no timer is available.
+ */
+int lcd_refresh_start(uint32_t period_us)
+{
+    if (period_us < LCD_REFRESH_MIN_US)
+    {
+        period_us = LCD_REFRESH_MIN_US;
+    }
+
+    return (timer_add(TIMER_PERIODIC, period_us, lcd_refresh_tick, 0) < 0) ? -1 : 0;
+}
+
+/**
+ * @brief Prints a formatted string to the LCD.
+ * 
+ * This function formats the string with the shared formatting core (same 
+ * conversions as uart_printf) and writes it from the current cursor position. 
+ * The output is truncated to one row (LCD_COLUMNS characters).
+ * 
+ * @param format The format string.
+ * @param ...    The values to format.
+ */
+void lcd_printf(const char *format, ...)
+{
+    char text[LCD_COLUMNS + 1]; ///< One row of text and the terminating NUL
+    va_list args;
+
+    va_start(args, format);
+    format_vsnprintf(text, sizeof(text), format, args); ///< Format into the row buffer
+    va_end(args);
+
+    lcd_print(text); ///< Write the formatted row to the LCD
+}
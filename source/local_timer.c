@@ -0,0 +1,122 @@
+/**
+ * @file        local_timer.c
+ * @brief       ARMv8 generic timer driver.
+ * @description This file implements the per-core tick based on the non-secure
+ *              physical timer of each Cortex-A53 core, and the fast time base used by
+ *              timer_get_ticks(). The counter and the System Timer are both clocked
+ *              from the 19.2MHz crystal, so once aligned at init they do not drift.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "local_timer.h"
+#include "timer.h"
+#include "utils.h"
+#include "irq.h"
+#include "sched.h"
+#include "sections.h"
+
+// Fixed-point shift of the counter to microseconds conversion
+#define US_SHIFT    40
+
+// Counter ticks to microseconds: us = (ticks * us_mult) >> US_SHIFT
+static uint64_t us_mult;
+
+// System Timer value minus counter microseconds, taken at init
+static uint64_t us_offset;
+
+// Counter ticks per tick period
+static uint32_t tick_reload;
+
+// Set once the time base is initialized
+static volatile uint8_t time_base_ready;
+
+// Ticks handled by each core
+static volatile uint64_t tick_count[NR_CORES];
+
+/**
+ * @brief Initializes the generic timer time base.
+ */
+SECTION_INIT void local_timer_init(void)
+{
+    uint64_t freq;
+
+    // Core timers clocked by the crystal, prescaler divide ratio of 1.
+    LOCAL->CONTROL = LOCAL_CONTROL_CRYSTAL;
+    LOCAL->PRESCALER = LOCAL_PRESCALER_DIV1;
+
+    // Conversion factors derived from the frequency programmed at EL3.
+    freq = local_timer_get_freq();
+    us_mult = ((uint64_t)1000000 << US_SHIFT) / freq;
+    tick_reload = (uint32_t)((freq * LOCAL_TIMER_TICK_US) / 1000000);
+
+    // Align on the System Timer epoch (timer_get_ticks still reads it here).
+    us_offset = 0;
+    us_offset = timer_get_ticks() - local_timer_get_us();
+
+    time_base_ready = 1;
+}
+
+/**
+ * @brief Starts the periodic tick of the calling core.
+ */
+void local_timer_core_init(void)
+{
+    uint8_t core = get_core_id();
+
+    // Arm the timer for the first period, interrupt unmasked.
+    local_timer_set_tval(tick_reload);
+    local_timer_set_ctl(CNTP_CTL_ENABLE);
+
+    // The tick handler is shared by all the cores and is never preempted.
+    irq_register(IRQ_LOCAL_CNTPNS, handle_local_timer, IRQ_PRIO_HIGHEST);
+
+    // Route the non-secure physical timer of this core to its IRQ line.
+    LOCAL->TIMER_IRQ_CTRL[core] = LOCAL_CNTPNSIRQ;
+}
+
+/**
+ * @brief Handles the tick interrupt of the calling core.
+ */
+SECTION_HOT void handle_local_timer(void)
+{
+    // Re-arming the timer also clears the timer condition.
+    local_timer_set_tval(tick_reload);
+
+    // Only this core writes its own counter.
+    tick_count[get_core_id()]++;
+
+    // End of the time slice of the running task
+    sched_tick();
+}
+
+/**
+ * @brief Tells whether the generic time base has been initialized.
+ */
+uint8_t local_timer_ready(void)
+{
+    return time_base_ready;
+}
+
+/**
+ * @brief Converts the physical counter to System Timer microseconds.
+ */
+uint64_t local_timer_get_us(void)
+{
+    // 64x64 -> 128-bit multiply (a single umulh on AArch64) avoids overflow.
+    return (uint64_t)(((__uint128_t)local_timer_get_counter() * us_mult) >> US_SHIFT) + us_offset;
+}
+
+/**
+ * @brief Returns the number of ticks handled by a core.
+ */
+uint64_t local_timer_get_tick_count(uint8_t core)
+{
+    if (core >= NR_CORES)
+    {
+        return 0;
+    }
+
+    return tick_count[core];
+}
@@ -0,0 +1,316 @@
+/**
+ * @file        mailbox.c
+ * @brief       VideoCore mailbox property interface.
+ * @description This file implements the property channel of the mailbox: requests
+ *              are built in a cache-line aligned buffer, handed to the firmware by bus
+ *              address and answered in place.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "mailbox.h"
+#include "mm.h"
+#include "dma.h"
+#include "atomic.h"
+#include "spinlock.h"
+
+// Message buffer shared with the firmware (16-byte aligned, whole cache lines)
+static volatile uint32_t mbox_buffer[MBOX_BUFFER_WORDS] __attribute__((aligned(64)));
+
+// One request at a time (the buffer and the mailbox are shared by the cores)
+static spinlock_t mbox_lock = SPINLOCK_INIT;
+
+/**
+ * @brief Posts the message buffer on a channel and waits for its answer.
+ * 
+ * @param channel Mailbox channel.
+ * @return        MBOX_OK, or MBOX_ERROR on timeout.
+ */
+static int mbox_call(uint8_t channel)
+{
+    // The firmware sees RAM through the same uncached bus alias as the DMA engine
+    uint32_t addr = dma_bus_addr(mbox_buffer);
+    uint32_t spins = 0;
+    uint32_t value;
+
+    // Wait for room in the ARM to VideoCore mailbox
+    while (MBOX->STATUS1 & MBOX_STATUS_FULL)
+    {
+        if (++spins == MBOX_SPIN_MAX)
+        {
+            return MBOX_ERROR;
+        }
+    }
+    MBOX->WRITE = addr | channel;
+
+    // Wait for the answer to this buffer on the same channel
+    spins = 0;
+    while (1)
+    {
+        while (MBOX->STATUS & MBOX_STATUS_EMPTY)
+        {
+            if (++spins == MBOX_SPIN_MAX)
+            {
+                return MBOX_ERROR;
+            }
+        }
+        value = MBOX->READ;
+        if (value == (addr | channel))
+        {
+            return MBOX_OK;
+        }
+    }
+}
+
+/**
+ * @brief Sends a property message and waits for the response.
+ * 
+ * @param msg   The message; word 0 holds its size in bytes. Receives the response.
+ * @param words Size of `msg` in words, at most MBOX_BUFFER_WORDS.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR if the firmware did not answer or rejected the request.
+ */
+int mbox_property(uint32_t *msg, uint32_t words)
+{
+    uint64_t flags;
+    uint32_t i;
+    int status;
+
+    if ((words < 3) || (words > MBOX_BUFFER_WORDS) || (msg[0] != words * 4))
+    {
+        return MBOX_ERROR;
+    }
+
+    flags = spin_lock_irqsave(&mbox_lock);
+
+    for (i = 0; i < words; i++)
+    {
+        mbox_buffer[i] = msg[i];
+    }
+
+    // Push the request to RAM, where the firmware reads it
+    smp_wmb();
+    dcache_clean_range((uint64_t)mbox_buffer, sizeof(mbox_buffer));
+
+    status = mbox_call(MBOX_CH_PROP);
+
+    // Drop the stale lines before reading the response
+    dcache_invalidate_range((uint64_t)mbox_buffer, sizeof(mbox_buffer));
+
+    if ((status == MBOX_OK) && (mbox_buffer[1] != MBOX_RESPONSE_OK))
+    {
+        status = MBOX_ERROR;
+    }
+    for (i = 0; i < words; i++)
+    {
+        msg[i] = mbox_buffer[i];
+    }
+
+    spin_unlock_irqrestore(&mbox_lock, flags);
+
+    return status;
+}
+
+/**
+ * @brief Queries the RAM given to the ARM (the rest belongs to the GPU, see gpu_mem).
+ * 
+ * @param[out] base Start of the ARM memory.
+ * @param[out] size Size of the ARM memory in bytes.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+int mbox_get_arm_memory(uint32_t *base, uint32_t *size)
+{
+    uint32_t values[2] = { 0, 0 };  // Base, size (response)
+
+    if (mbox_tag(MBOX_TAG_GET_ARM_MEMORY, values, 2, 0) != MBOX_OK)
+    {
+        return MBOX_ERROR;
+    }
+
+    *base = values[0];
+    *size = values[1];
+
+    return MBOX_OK;
+}
+
+/**
+ * @brief Sends a message holding a single tag and waits for the response.
+ * 
+ * @param tag       MBOX_TAG_* tag.
+ * @param values    Value buffer of the tag: the request on entry, the response on return.
+ * @param words     Size of the value buffer in words, at most MBOX_TAG_MAX_WORDS.
+ * @param req_words Words of the request in the value buffer.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR if the firmware did not answer the tag.
+ */
+int mbox_tag(uint32_t tag, uint32_t *values, uint32_t words, uint32_t req_words)
+{
+    // Size, request code, tag, value buffer size, request length, values, end tag
+    uint32_t msg[MBOX_TAG_MAX_WORDS + 6];
+    uint32_t total = words + 6;
+    uint32_t i;
+
+    if ((words > MBOX_TAG_MAX_WORDS) || (req_words > words))
+    {
+        return MBOX_ERROR;
+    }
+
+    msg[0] = total * 4;
+    msg[1] = MBOX_REQUEST;
+    msg[2] = tag;
+    msg[3] = words * 4;
+    msg[4] = req_words * 4;
+    for (i = 0; i < words; i++)
+    {
+        msg[5 + i] = values[i];
+    }
+    msg[5 + words] = MBOX_TAG_END;
+
+    // The firmware flags the tags it answered in their length word
+    if ((mbox_property(msg, total) != MBOX_OK) || !(msg[4] & MBOX_TAG_RESPONSE))
+    {
+        return MBOX_ERROR;
+    }
+
+    for (i = 0; i < words; i++)
+    {
+        values[i] = msg[5 + i];
+    }
+
+    return MBOX_OK;
+}
+
+/**
+ * @brief Queries the RAM kept by the VideoCore (gpu_mem in config.txt).
+ * 
+ * @param[out] base Start of the VideoCore memory.
+ * @param[out] size Size of the VideoCore memory in bytes.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+int mbox_get_vc_memory(uint32_t *base, uint32_t *size)
+{
+    uint32_t values[2] = { 0, 0 };  // Base, size (response)
+
+    if (mbox_tag(MBOX_TAG_GET_VC_MEMORY, values, 2, 0) != MBOX_OK)
+    {
+        return MBOX_ERROR;
+    }
+
+    *base = values[0];
+    *size = values[1];
+
+    return MBOX_OK;
+}
+
+/**
+ * @brief Queries the board revision code.
+ * 
+ * @param[out] revision Revision code.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+int mbox_get_board_revision(uint32_t *revision)
+{
+    uint32_t value = 0;             // Revision (response)
+
+    if (mbox_tag(MBOX_TAG_GET_BOARD_REVISION, &value, 1, 0) != MBOX_OK)
+    {
+        return MBOX_ERROR;
+    }
+
+    *revision = value;
+
+    return MBOX_OK;
+}
+
+/**
+ * @brief Queries one rate of a clock (current, maximum or minimum).
+ * 
+ * @param tag     MBOX_TAG_GET_*CLOCK_RATE tag.
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR (also for a clock that does not exist).
+ */
+static int mbox_clock_query(uint32_t tag, uint32_t clock, uint32_t *hz)
+{
+    uint32_t values[2] = { clock, 0 };  // Clock id, rate (response)
+
+    // The firmware answers an unknown clock with a rate of 0
+    if ((mbox_tag(tag, values, 2, 1) != MBOX_OK) || (values[1] == 0))
+    {
+        return MBOX_ERROR;
+    }
+
+    *hz = values[1];
+
+    return MBOX_OK;
+}
+
+/**
+ * @brief Queries the current rate of a clock.
+ * 
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK, or MBOX_ERROR (also for a clock that does not exist).
+ */
+int mbox_get_clock_rate(uint32_t clock, uint32_t *hz)
+{
+    return mbox_clock_query(MBOX_TAG_GET_CLOCK_RATE, clock, hz);
+}
+
+/**
+ * @brief Queries the highest rate the firmware allows for a clock.
+ * 
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+int mbox_get_max_clock_rate(uint32_t clock, uint32_t *hz)
+{
+    return mbox_clock_query(MBOX_TAG_GET_MAX_CLOCK_RATE, clock, hz);
+}
+
+/**
+ * @brief Queries the lowest rate the firmware allows for a clock.
+ * 
+ * @param clock   MBOX_CLOCK_* id.
+ * @param[out] hz Rate in Hz.
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+int mbox_get_min_clock_rate(uint32_t clock, uint32_t *hz)
+{
+    return mbox_clock_query(MBOX_TAG_GET_MIN_CLOCK_RATE, clock, hz);
+}
+
+/**
+ * @brief Sets the rate of a clock.
+ * 
+ * @param clock       MBOX_CLOCK_* id.
+ * @param hz          Requested rate in Hz.
+ * @param[out] actual Rate set by the firmware, in Hz (may be 0).
+ * 
+ * @return MBOX_OK or MBOX_ERROR.
+ */
+int mbox_set_clock_rate(uint32_t clock, uint32_t hz, uint32_t *actual)
+{
+    uint32_t values[3] = { clock, hz, 0 };  // Clock id, rate, skip turbo (0: adjust the voltage)
+
+    if ((mbox_tag(MBOX_TAG_SET_CLOCK_RATE, values, 3, 3) != MBOX_OK) || (values[1] == 0))
+    {
+        return MBOX_ERROR;
+    }
+
+    if (actual != 0)
+    {
+        *actual = values[1];
+    }
+
+    return MBOX_OK;
+}
@@ -15,7 +15,17 @@
 #include "gpio.h"
 #include "aux.h"
 #include "mini_uart.h"
+#include "ring_buffer.h"
+#include "page_alloc.h"
+#include "spinlock.h"
+#include "atomic.h"
+#include "irq.h"
+#include "sched.h"
+#include "clock.h"
+#include "sections.h"
 
+// Only the console UART is built (see uart.h)
+#if CONSOLE_UART == CONSOLE_UART_MINI
 
 /*
   +-------------------------+   
@@ -24,6 +34,154 @@
   +-------------------------+
 */
 
+// Mini UART Interrupt Enable values (bits 2 and 3 must be set to 1)
+#define MU_IER_RX_ONLY      0b1101      // Receive interrupt only
+#define MU_IER_RX_TX        0b1111      // Receive and transmit interrupts
+
+// Mini UART Line Status bits
+#define MU_LSR_DATA_READY   0x01        // The receive FIFO holds at least one byte
+#define MU_LSR_TX_EMPTY     0x20        // The transmit FIFO can accept at least one byte
+#define MU_LSR_TX_IDLE      0x40        // The transmit FIFO is empty and the transmitter idle
+
+// Mini UART Interrupt Identify bits [2:1]
+#define MU_IIR_TX_PENDING   0x02        // Transmit holding register empty
+#define MU_IIR_RX_PENDING   0x04        // Receiver holds a valid byte
+
+// Transmit ring: filled by uart_send, drained by the TX interrupt
+static struct ring_buffer uart_tx_ring;
+
+// Receive ring: filled by the RX interrupt, drained by uart_recv
+static struct ring_buffer uart_rx_ring;
+
+// Serializes the producers of the transmit ring (any core, any context)
+static spinlock_t uart_tx_prod_lock = SPINLOCK_INIT;
+
+// Serializes the consumers of the transmit ring (TX interrupt, flush, full-ring fallback)
+static spinlock_t uart_tx_cons_lock = SPINLOCK_INIT;
+
+// Serializes the producers of the receive ring (RX interrupt, polling fallback)
+static spinlock_t uart_rx_prod_lock = SPINLOCK_INIT;
+
+// Set once the Mini UART is configured; bytes sent before that are dropped
+static volatile uint8_t uart_ready;
+
+static void uart_tx_drain(uint32_t max);
+static void uart_rx_fill(void);
+static void uart_clock_changed(uint32_t event, uint32_t core_hz);
+
+/**
+ * @brief Moves bytes from the transmit ring to the transmit FIFO.
+ * 
+ * At most `max` bytes are written, and only while the FIFO has room, so the function
+ * never waits on the hardware. When the ring becomes empty the TX interrupt is masked;
+ * the ring is checked again afterwards so that a byte queued concurrently re-enables it.
+ * If another context is already draining, the function returns immediately.
+ * 
+ * @param max Maximum number of bytes to write.
+ */
+SECTION_HOT static void uart_tx_drain(uint32_t max)
+{
+    uint8_t c;
+
+    if (!spin_trylock(&uart_tx_cons_lock))
+    {
+        return;
+    }
+
+    while ((max > 0) && (AUX->MU_LSR_REG & MU_LSR_TX_EMPTY) && ring_buffer_get(&uart_tx_ring, &c))
+    {
+        // Write the byte into the transmit FIFO.
+        AUX->MU_IO_REG = c;
+        max--;
+    }
+
+    if (ring_buffer_empty(&uart_tx_ring))
+    {
+        // Nothing left to send: stop the TX-empty interrupt.
+        AUX->MU_IER_REG = MU_IER_RX_ONLY;
+
+        // A producer may have queued a byte before the interrupt was masked.
+        smp_mb();
+        if (!ring_buffer_empty(&uart_tx_ring))
+        {
+            AUX->MU_IER_REG = MU_IER_RX_TX;
+        }
+    }
+
+    spin_unlock(&uart_tx_cons_lock);
+}
+
+/**
+ * @brief Moves every byte of the receive FIFO into the receive ring.
+ * 
+ * Bytes are dropped when the ring is full. If another context is already filling
+ * the ring, the function returns immediately.
+ */
+SECTION_HOT static void uart_rx_fill(void)
+{
+    uint8_t received = 0;
+    uint8_t c;
+
+    if (!spin_trylock(&uart_rx_prod_lock))
+    {
+        return;
+    }
+
+    // Drain the whole receive FIFO in one pass.
+    while (AUX->MU_LSR_REG & MU_LSR_DATA_READY)
+    {
+        c = AUX->MU_IO_REG & 0xFF;
+        ring_buffer_put(&uart_rx_ring, c);
+        received = 1;
+    }
+
+    spin_unlock(&uart_rx_prod_lock);
+
+    // Wake the tasks blocked in uart_recv()
+    if (received)
+    {
+        sched_send_event();
+    }
+}
+
+
+/**
+ * @brief Core clock notifier: moves the baud divisor to the new core rate.
+ * 
+ * Before the change, the producers and the transmitter are stopped and the bytes
+ * already in the FIFO leave at the old rate; after it, the divisor is rewritten
+ * and the transmitter restarted on what was queued meanwhile. Both calls come
+ * from clock_set_core_hz() on the same core, with IRQs masked.
+ * 
+ * @param event   CLOCK_PRE_CHANGE or CLOCK_POST_CHANGE.
+ * @param core_hz Core rate in Hz.
+ */
+static void uart_clock_changed(uint32_t event, uint32_t core_hz)
+{
+    if (event == CLOCK_PRE_CHANGE)
+    {
+        // uart_send() waits on the producer lock, uart_tx_drain() gives up on the consumer one.
+        spin_lock(&uart_tx_prod_lock);
+        spin_lock(&uart_tx_cons_lock);
+        AUX->MU_IER_REG = MU_IER_RX_ONLY;
+
+        while (!(AUX->MU_LSR_REG & MU_LSR_TX_IDLE))
+        {
+            ;
+        }
+        return;
+    }
+
+    AUX->MU_BAUD_REG = MINI_UART_DIVISOR(core_hz);
+
+    if (!ring_buffer_empty(&uart_tx_ring))
+    {
+        AUX->MU_IER_REG = MU_IER_RX_TX;
+    }
+
+    spin_unlock(&uart_tx_cons_lock);
+    spin_unlock(&uart_tx_prod_lock);
+}
 
 /**
  * @brief Initializes the Mini UART on the Raspberry Pi for serial communication.
@@ -31,11 +189,14 @@
  * This function configures the necessary GPIO pins for UART (TX and RX), sets the
  * appropriate alternate function, configures the UART parameters (such as baud rate),
  * and enables the Mini UART for communication. It also ensures that the UART pins have
- * no pull-up or pull-down resistors enabled. After initialization, the function sends
+ * no pull-up or pull-down resistors enabled. The transmit and receive rings are reset
+ * and only the receive interrupt is enabled; the transmit interrupt is enabled
+ * whenever bytes are queued. After initialization, the function sends
  * an initial message to the UART terminal to indicate that the kernel initialization has started.
  * 
  * GPIO pins are configured to alternate function 5 (Mini UART) and the UART is set to 8 data bits,
- * no parity, and 1 stop bit, with a baud rate of 115200 (433 for 3.6864 MHz clock).
+ * no parity, and 1 stop bit, with a baud rate of MINI_UART_BAUD derived from the VPU core
+ * clock; the divisor is recomputed whenever clock_set_core_hz() changes that clock.
  * 
  * This function is intended to be called during the early stages of the Raspberry Pi bare metal
  * kernel initialization process.
@@ -45,38 +206,58 @@
  * 
  * @return void
  */
-void uart_init(void)
+SECTION_INIT void uart_init(void)
 {
-    // Set the GPIO pins for Mini UART TX (Transmit) and RX (Receive) to alternate function 5.
-    // This configuration enables the UART signals on the GPIO pins for communication.
-    gpio_set_pin_function(MINI_UART_TXD, GPIO_ALT5);  // Set the TXD pin to use alternate function 5
-    gpio_set_pin_function(MINI_UART_RXD, GPIO_ALT5);  // Set the RXD pin to use alternate function 5
+    // Both rings live in pages of the page allocator; without them the console stays off.
+    uint8_t *storage = page_alloc(UART_RING_PAGES);
+
+    if (storage == 0)
+    {
+        return;
+    }
 
-    // Configure pull-up/down resistors for the TX and RX pins.
-    // Setting both pins to '0' disables any pull-up or pull-down resistors.
-    gpio_pull_up_down(MINI_UART_TXD, GPIO_PUD_OFF);  // No pull-up or pull-down for TXD
-    gpio_pull_up_down(MINI_UART_RXD, GPIO_PUD_OFF);  // No pull-up or pull-down for RXD
+    // Set the GPIO pins for Mini UART TX (Transmit) and RX (Receive) to alternate function 5,
+    // with no pull-up or pull-down: one GPFSEL write and one pull sequence for both.
+    static const struct gpio_pin_config mini_uart_pins[] = {
+        { MINI_UART_TXD, GPIO_ALT5, GPIO_PUD_OFF },
+        { MINI_UART_RXD, GPIO_ALT5, GPIO_PUD_OFF },
+    };
+    gpio_config_pins(mini_uart_pins, sizeof(mini_uart_pins) / sizeof(mini_uart_pins[0]));
+
+    // Start with empty transmit and receive rings.
+    ring_buffer_init(&uart_tx_ring, storage, UART_TX_BUFFER_SIZE);
+    ring_buffer_init(&uart_rx_ring, storage + UART_TX_BUFFER_SIZE, UART_RX_BUFFER_SIZE);
 
     // Enable the Mini UART (AUX) by setting the relevant bit in the ENABLES register.
     AUX->ENABLES = 1;           // Enable the AUX (Mini UART) peripheral
 
     // Configure Mini UART control registers.
     AUX->MU_CNTL_REG = 0;       // Disable Mini UART to configure it safely
-    AUX->MU_IER_REG = 0b1101;   // Configure Mini UART Interrupt Enable Register (MU_IER_REG)
+    AUX->MU_IER_REG = MU_IER_RX_ONLY;   // Configure Mini UART Interrupt Enable Register (MU_IER_REG)
                                 // - Enable Receiver Interrupt (bit 0)
-                                // - Disable Transmitter Interrupt (bit 1)
+                                // - Disable Transmitter Interrupt (bit 1) until bytes are queued
                                 // - Must be set to 1 (bit 2 and bit 3)
 
     AUX->MU_LCR_REG = 3;        // Set Line Control Register to 3 (8 data bits, no parity, 1 stop bit)
     AUX->MU_MCR_REG = 0;        // Set Modem Control Register to 0 (no control)
 
-    // Set the baud rate for the Mini UART.
-    // The baud rate is set to 433 (typically used for 115200 baud with a 3.6864 MHz clock).
-    AUX->MU_BAUD_REG = 433;     // Set the baud rate to 115200 (433 for 3.6864 MHz clock)
+    // Set the baud rate for the Mini UART from the current VPU core clock
+    // (core / (8 * (divisor + 1)), 433 for 115200 baud at 400 MHz).
+    AUX->MU_BAUD_REG = MINI_UART_DIVISOR(clock_get_core_hz());
 
     // Enable the Mini UART for use.
     AUX->MU_CNTL_REG = 3;       // Re-enable the Mini UART with TX and RX enabled
 
+    // Take the Mini UART interrupt (RX and TX-empty); RX must not wait behind long handlers.
+    irq_register(IRQ_AUX, handle_uart_irq, IRQ_PRIO_HIGH);
+
+    // Follow the changes of the core clock.
+    clock_register_notifier(uart_clock_changed);
+
+    // From now on uart_send queues bytes instead of dropping them.
+    smp_wmb();
+    uart_ready = 1;
+
     // Send a carriage return and newline characters to the UART terminal to indicate initialization is complete.
     uart_send('\n');            // Send a newline
     uart_send('\n');            // Send another newline for separation
@@ -86,85 +267,132 @@ void uart_init(void)
 /**
  * @brief Receives a character from the Mini UART.
  *
- * This function waits until data is available to read from the UART, 
- * and then retrieves the received character from the UART data register.
+ * This function waits until a character is available in the receive ring and 
+ * returns it. While the ring is empty the receive FIFO is also polled, so the 
+ * function works with IRQs masked; a task sleeps in sched_wait_event() between 
+ * polls until the RX interrupt wakes it.
  *
  * @return The character received from the Mini UART.
  */
 char uart_recv(void)
 {
-    // Wait until the UART has received data.
-    // The Data Ready Flag (bit 0) in the AUX_MU_LCR_REG register is checked 
-    // to see if new data has been received and is ready to be read.
-    while(!(AUX->MU_LSR_REG & 0x01)) 
+    char c;
+
+    // Wait until the RX interrupt (or the polling fallback) has queued a byte.
+    while (!uart_try_recv(&c))
     {
-        // Busy-wait loop: does nothing while waiting for the Data Ready Flag to be set.
-        // This ensures that the function doesn't read from the UART until new data is available.
-        ;
+        uart_rx_fill();
+
+        // A task blocks until the RX interrupt queues a byte; elsewhere the FIFO is polled
+        if (!irq_in_handler() && ring_buffer_empty(&uart_rx_ring))
+        {
+            sched_wait_event();
+        }
     }
 
-    // Retrieve the received character from the UART data register.
-    // The character is stored in the lower 8 bits of the AUX_MU_LCR_REG register.
-    // The `& 0xFF` operation ensures that only the 8 least significant bits (the character) are returned.
-    return (AUX->MU_IO_REG & 0xFF);
+    return c;
+}
+
+/**
+ * @brief Receives a character from the Mini UART without waiting.
+ *
+ * @param c Filled with the received character.
+ *
+ * @return 1 if a character was received, 0 if the receive ring is empty.
+ */
+uint8_t uart_try_recv(char *c)
+{
+    uint8_t byte;
+
+    if (!ring_buffer_get(&uart_rx_ring, &byte))
+    {
+        return 0;
+    }
+
+    *c = (char)byte;
+
+    return 1;
 }
 
 /**
  * @brief Sends a character over the Mini UART.
  *
- * This function waits for the UART transmitter to be ready by checking the 
- * appropriate control register bit, and then sends the character `c` 
- * through the UART data register.
+ * This function queues the character `c` in the transmit ring and enables the 
+ * TX-empty interrupt, which moves it to the hardware. It only waits when the ring 
+ * is full; the ring is then drained synchronously, which also works with IRQs masked.
+ * Characters sent before uart_init() are dropped.
  *
  * @param c The character to send via the Mini UART.
  */
 void uart_send(char c)
 {
-    // Wait until the UART transmitter is ready to send data.
-    // The Transmitter Empty Flag (bit 5) in the AUX_MU_LCR_REG register 
-    // is checked to determine if the UART can accept new data.
-    while(!(AUX->MU_LSR_REG & 0x20)) 
+    uint64_t flags;
+
+    if (!uart_ready)
     {
-        // Busy-wait loop: does nothing while waiting for the flag to be set.
-        // This ensures that we don't attempt to send data until the UART is ready.
-        ;
+        return;
     }
 
-    // Transmit the character `c` by writing it to the UART's data register.
-    // The character will be sent out through the Mini UART hardware.
-    AUX->MU_IO_REG = c;
+    // One producer at a time; IRQs off so an interrupt handler on this core can print too.
+    flags = spin_lock_irqsave(&uart_tx_prod_lock);
+
+    while (ring_buffer_put(&uart_tx_ring, (uint8_t)c) != 0)
+    {
+        // Ring full: push bytes to the FIFO ourselves until a slot frees up.
+        uart_tx_drain(UART_FIFO_DEPTH);
+    }
+
+    // Let the TX-empty interrupt drain the ring.
+    AUX->MU_IER_REG = MU_IER_RX_TX;
+
+    spin_unlock_irqrestore(&uart_tx_prod_lock, flags);
 }
 
 /**
- * @brief Sends a null-terminated string over the UART.
- * 
- * This function sends a string of characters to the UART one by one. If a newline 
- * character ('\n') is encountered, a carriage return ('\r') is first sent, as required
- * by many terminal emulators to properly handle newlines in serial communication.
- * The function continues sending characters until the null terminator ('\0') is reached, 
- * which marks the end of the string.
- * 
- * @param str A pointer to the null-terminated string to be sent over UART.
- * 
- * @return void
+ * @brief Sends every queued character and waits for the transmitter to be idle.
+ *
+ * Intended for panic paths and for code that must not return before its output 
+ * is on the wire. Does not rely on interrupts.
  */
-void uart_send_string(char *str)
+void uart_flush(void)
 {
-    // Loop through each character of the string
-    // Continue looping until we reach the null terminator ('\0')
-    while(*str) {
-        // If the character is a newline, send a carriage return first for proper formatting
-        if (*str == '\n') 
-        {
-            uart_send('\r');  // Send carriage return before newline for proper display on UART terminal
-        }
+    if (!uart_ready)
+    {
+        return;
+    }
 
-        // Send the current character
-        uart_send(*str);
-        
-        // Move to the next character in the string
-        str++;
+    // Empty the transmit ring by polling the FIFO.
+    while (!ring_buffer_empty(&uart_tx_ring))
+    {
+        uart_tx_drain(UART_FIFO_DEPTH);
+    }
+
+    // Wait until the last byte has left the shift register.
+    while (!(AUX->MU_LSR_REG & MU_LSR_TX_IDLE))
+    {
+        ;
     }
 }
 
+/**
+ * @brief Handles the Mini UART interrupt.
+ *
+ * The whole receive FIFO is moved into the receive ring, and up to one FIFO worth 
+ * of bytes (UART_FIFO_DEPTH) is moved from the transmit ring to the hardware.
+ */
+SECTION_HOT void handle_uart_irq(void)
+{
+    uint32_t iir = AUX->MU_IIR_REG;
+
+    if (iir & MU_IIR_RX_PENDING)
+    {
+        uart_rx_fill();
+    }
+
+    if (iir & MU_IIR_TX_PENDING)
+    {
+        uart_tx_drain(UART_FIFO_DEPTH);
+    }
+}
 
+#endif /* CONSOLE_UART == CONSOLE_UART_MINI */
@@ -0,0 +1,237 @@
+/**
+ * @file        page_alloc.c
+ * @brief       Physical page-frame allocator.
+ * @description This file implements a bitmap allocator over the pages between
+ *              PAGE_ALLOC_START and the end of the ARM memory. A set bit is a used
+ *              page; full 64-bit words are skipped, so a scan costs one load per
+ *              256KB of allocated memory.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "page_alloc.h"
+#include "mailbox.h"
+#include "spinlock.h"
+#include "sections.h"
+
+// Allocation bitmap (one bit per page, set when used) at PAGE_ALLOC_START
+static uint64_t *page_bitmap;
+
+// Number of managed pages, of free pages, and first page of the next search
+static uint32_t page_count;
+static uint32_t page_nr_free;
+static uint32_t page_hint;
+
+// Protects the bitmap and the counters
+static spinlock_t page_lock = SPINLOCK_INIT;
+
+/**
+ * @brief Tells whether a page is used.
+ * 
+ * @param page Page index.
+ * @return     1 if used, 0 if free.
+ */
+static inline uint32_t page_test(uint32_t page)
+{
+    return (page_bitmap[page / 64] >> (page % 64)) & 1;
+}
+
+/**
+ * @brief Marks a run of pages as used or free.
+ * 
+ * @param first First page index.
+ * @param count Number of pages.
+ * @param used  1 to mark used, 0 to mark free.
+ */
+static void page_mark(uint32_t first, uint32_t count, uint32_t used)
+{
+    uint32_t page;
+
+    for (page = first; page < first + count; page++)
+    {
+        if (used)
+        {
+            page_bitmap[page / 64] |= (1ULL << (page % 64));
+        }
+        else
+        {
+            page_bitmap[page / 64] &= ~(1ULL << (page % 64));
+        }
+    }
+}
+
+/**
+ * @brief Searches a run of free pages in [from, to).
+ * 
+ * @param from  First page index to consider.
+ * @param to    End of the search (exclusive).
+ * @param count Length of the run.
+ * 
+ * @return The first page of the run, or page_count if there is none.
+ */
+static uint32_t page_search(uint32_t from, uint32_t to, uint32_t count)
+{
+    uint32_t page = from;
+    uint32_t run = 0;
+
+    while (page < to)
+    {
+        // A full word cannot hold a free page
+        if (((page % 64) == 0) && (page_bitmap[page / 64] == ~0ULL))
+        {
+            run = 0;
+            page += 64;
+            continue;
+        }
+
+        if (page_test(page))
+        {
+            run = 0;
+        }
+        else if (++run == count)
+        {
+            return page + 1 - count;
+        }
+        page++;
+    }
+
+    return page_count;
+}
+
+/**
+ * @brief Initializes the page allocator.
+ * 
+ * Queries the ARM memory size through the mailbox (identity-mapped RAM ends at
+ * PIBASE at most) and marks the pages of the bitmap as used. Must run before any
+ * allocation, with the MMU and the data cache on.
+ */
+SECTION_INIT void page_alloc_init(void)
+{
+    uint64_t end = PAGE_ALLOC_DEFAULT_END;
+    uint32_t base;
+    uint32_t size;
+    uint32_t bitmap_pages;
+    uint32_t i;
+
+    if (mbox_get_arm_memory(&base, &size) == MBOX_OK)
+    {
+        end = (uint64_t)base + size;
+    }
+    if (end > PIBASE)
+    {
+        end = PIBASE;
+    }
+
+    page_count = (uint32_t)((end - PAGE_ALLOC_START) >> PAGE_SHIFT);
+    page_bitmap = (uint64_t *)PAGE_ALLOC_START;
+
+    // Every page starts free, except the bitmap itself
+    bitmap_pages = ((page_count + 63) / 64 * 8 + PAGE_SIZE - 1) / PAGE_SIZE;
+    for (i = 0; i < (page_count + 63) / 64; i++)
+    {
+        page_bitmap[i] = 0;
+    }
+    page_mark(0, bitmap_pages, 1);
+
+    page_nr_free = page_count - bitmap_pages;
+    page_hint = bitmap_pages;
+}
+
+/**
+ * @brief Allocates physically contiguous pages.
+ * 
+ * @param count Number of pages.
+ * @return      Address of the first page, or NULL if no run of `count` free pages exists.
+ */
+void *page_alloc(uint32_t count)
+{
+    uint64_t flags;
+    uint32_t page;
+
+    if ((count == 0) || (count > page_count))
+    {
+        return 0;
+    }
+
+    flags = spin_lock_irqsave(&page_lock);
+
+    page = page_count;
+    if (count <= page_nr_free)
+    {
+        // After the last allocation first, then from the start of the range
+        page = page_search(page_hint, page_count, count);
+        if ((page == page_count) && (page_hint > 0))
+        {
+            page = page_search(0, page_count, count);
+        }
+    }
+
+    if (page != page_count)
+    {
+        page_mark(page, count, 1);
+        page_nr_free -= count;
+        page_hint = page + count;
+    }
+
+    spin_unlock_irqrestore(&page_lock, flags);
+
+    if (page == page_count)
+    {
+        return 0;
+    }
+
+    return (void *)(PAGE_ALLOC_START + ((uint64_t)page << PAGE_SHIFT));
+}
+
+/**
+ * @brief Releases pages allocated with page_alloc().
+ * 
+ * @param addr  Address returned by page_alloc().
+ * @param count Number of pages given to page_alloc().
+ */
+void page_free(void *addr, uint32_t count)
+{
+    uint64_t flags;
+    uint32_t page;
+
+    if ((uint64_t)addr < PAGE_ALLOC_START)
+    {
+        return;
+    }
+
+    page = (uint32_t)(((uint64_t)addr - PAGE_ALLOC_START) >> PAGE_SHIFT);
+
+    flags = spin_lock_irqsave(&page_lock);
+
+    page_mark(page, count, 0);
+    page_nr_free += count;
+
+    // Reuse low pages first: keeps the used range compact
+    if (page < page_hint)
+    {
+        page_hint = page;
+    }
+
+    spin_unlock_irqrestore(&page_lock, flags);
+}
+
+/**
+ * @brief Returns the number of free pages.
+ * 
+ * @return Free pages.
+ */
+uint32_t page_free_count(void)
+{
+    return page_nr_free;
+}
+
+/**
+ * @brief Returns the number of pages managed by the allocator.
+ * 
+ * @return Managed pages, including the bitmap.
+ */
+uint32_t page_total_count(void)
+{
+    return page_count;
+}
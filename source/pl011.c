@@ -0,0 +1,464 @@
+/**
+ * @file        pl011.c
+ * @brief       Implementation of the PL011 UART console.
+ * @description This file provides the console functions of uart.h on the PL011
+ *              (UART0): interrupt-driven transmit and receive rings on top of the
+ *              16-byte FIFOs, programmable FIFO levels, the receive timeout, and DMA
+ *              transmit paced by the UART DREQ. The baud rate derives from the UART
+ *              reference clock, not from the VPU core clock.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "gpio.h"
+#include "pl011.h"
+#include "ring_buffer.h"
+#include "page_alloc.h"
+#include "spinlock.h"
+#include "atomic.h"
+#include "irq.h"
+#include "sched.h"
+#include "sections.h"
+
+// Only the console UART is built (see uart.h)
+#if CONSOLE_UART == CONSOLE_UART_PL011
+
+/*
+  +-------------------------+
+  |  GPIO 14 (TXD)   Pin 8  |
+  |  GPIO 15 (RXD)   Pin 10 |
+  +-------------------------+
+*/
+
+// Interrupt masks: receive (level, timeout, overrun) only, or with transmit
+#define PL011_IMSC_RX_ONLY  (PL011_INT_RX | PL011_INT_RT | PL011_INT_OE)
+#define PL011_IMSC_RX_TX    (PL011_IMSC_RX_ONLY | PL011_INT_TX)
+
+// Transmit ring: filled by uart_send, drained by the TX interrupt
+static struct ring_buffer uart_tx_ring;
+
+// Receive ring: filled by the RX interrupt, drained by uart_recv
+static struct ring_buffer uart_rx_ring;
+
+// Serializes the producers of the transmit ring (any core, any context)
+static spinlock_t uart_tx_prod_lock = SPINLOCK_INIT;
+
+// Serializes the consumers of the transmit ring (TX interrupt, flush, full-ring fallback)
+static spinlock_t uart_tx_cons_lock = SPINLOCK_INIT;
+
+// Serializes the producers of the receive ring (RX interrupt, polling fallback)
+static spinlock_t uart_rx_prod_lock = SPINLOCK_INIT;
+
+// Set once the PL011 is configured; bytes sent before that are dropped
+static volatile uint8_t uart_ready;
+
+// DMA transmit in progress: the ring is not drained meanwhile
+static volatile uint32_t pl011_dma_busy;
+static int pl011_dma_channel;
+static dma_callback_t pl011_dma_callback;
+static void *pl011_dma_arg;
+
+static void uart_tx_drain(uint32_t max);
+static void uart_rx_fill(void);
+static void pl011_dma_done(int channel, int status, void *arg);
+
+/**
+ * @brief Moves bytes from the transmit ring to the transmit FIFO.
+ * 
+ * At most `max` bytes are written, and only while the FIFO has room, so the function
+ * never waits on the hardware. When the ring becomes empty the TX interrupt is masked;
+ * the ring is checked again afterwards so that a byte queued concurrently re-enables it.
+ * If another context is already draining, or a DMA transmit owns the FIFO, the
+ * function returns immediately.
+ * 
+ * @param max Maximum number of bytes to write.
+ */
+SECTION_HOT static void uart_tx_drain(uint32_t max)
+{
+    uint8_t c;
+
+    if (pl011_dma_busy)
+    {
+        // The FIFO belongs to the DMA: pl011_dma_done() drains the ring afterwards.
+        PL011->IMSC = PL011_IMSC_RX_ONLY;
+        return;
+    }
+
+    if (!spin_trylock(&uart_tx_cons_lock))
+    {
+        return;
+    }
+
+    while ((max > 0) && !(PL011->FR & PL011_FR_TXFF) && ring_buffer_get(&uart_tx_ring, &c))
+    {
+        // Write the byte into the transmit FIFO.
+        PL011->DR = c;
+        max--;
+    }
+
+    if (ring_buffer_empty(&uart_tx_ring))
+    {
+        // Nothing left to send: stop the TX interrupt.
+        PL011->IMSC = PL011_IMSC_RX_ONLY;
+
+        // A producer may have queued a byte before the interrupt was masked.
+        smp_mb();
+        if (!ring_buffer_empty(&uart_tx_ring))
+        {
+            PL011->IMSC = PL011_IMSC_RX_TX;
+        }
+    }
+
+    spin_unlock(&uart_tx_cons_lock);
+}
+
+/**
+ * @brief Moves every byte of the receive FIFO into the receive ring.
+ * 
+ * Bytes are dropped when the ring is full, as are the error flags of DR. If another
+ * context is already filling the ring, the function returns immediately.
+ */
+SECTION_HOT static void uart_rx_fill(void)
+{
+    uint8_t received = 0;
+    uint8_t c;
+
+    if (!spin_trylock(&uart_rx_prod_lock))
+    {
+        return;
+    }
+
+    // Drain the whole receive FIFO in one pass.
+    while (!(PL011->FR & PL011_FR_RXFE))
+    {
+        c = PL011->DR & 0xFF;
+        ring_buffer_put(&uart_rx_ring, c);
+        received = 1;
+    }
+
+    spin_unlock(&uart_rx_prod_lock);
+
+    // Wake the tasks blocked in uart_recv()
+    if (received)
+    {
+        sched_send_event();
+    }
+}
+
+/**
+ * @brief Initializes the PL011 for serial communication.
+ * 
+ * GPIO 14 and 15 are switched to alternate function 0 (PL011) without pulls, the
+ * UART is set to 8 data bits, no parity, 1 stop bit at PL011_BAUD, with the FIFOs
+ * enabled at the PL011_TX_LEVEL / PL011_RX_LEVEL interrupt levels. Only the receive
+ * interrupts (level, timeout, overrun) are enabled; the transmit interrupt is
+ * enabled whenever bytes are queued.
+ */
+SECTION_INIT void uart_init(void)
+{
+    // Both rings live in pages of the page allocator; without them the console stays off.
+    uint8_t *storage = page_alloc(UART_RING_PAGES);
+
+    if (storage == 0)
+    {
+        return;
+    }
+
+    // Route the PL011 signals to the pins (Bluetooth uses the mini UART, see config.txt).
+    static const struct gpio_pin_config pl011_pins[] = {
+        { PL011_TXD, GPIO_ALT0, GPIO_PUD_OFF },
+        { PL011_RXD, GPIO_ALT0, GPIO_PUD_OFF },
+    };
+    gpio_config_pins(pl011_pins, sizeof(pl011_pins) / sizeof(pl011_pins[0]));
+
+    // Start with empty transmit and receive rings.
+    ring_buffer_init(&uart_tx_ring, storage, UART_TX_BUFFER_SIZE);
+    ring_buffer_init(&uart_rx_ring, storage + UART_TX_BUFFER_SIZE, UART_RX_BUFFER_SIZE);
+
+    // Disable the UART and let the firmware's last byte out before reprogramming it.
+    PL011->CR = 0;
+    while (PL011->FR & PL011_FR_BUSY)
+    {
+        ;
+    }
+    PL011->LCRH = 0;                            // Flush the FIFOs
+    PL011->ICR = PL011_INT_ALL;                 // Clear every pending interrupt
+    PL011->DMACR = 0;
+
+    // Baud divisor, latched by the LCRH write that follows.
+    PL011->IBRD = PL011_DIVISOR >> 6;
+    PL011->FBRD = PL011_DIVISOR & 0x3F;
+    PL011->LCRH = PL011_LCRH_WLEN_8 | PL011_LCRH_FEN;  // 8N1, FIFOs on
+
+    PL011->IFLS = PL011_IFLS(PL011_TX_LEVEL, PL011_RX_LEVEL);
+    PL011->IMSC = PL011_IMSC_RX_ONLY;
+
+    PL011->CR = PL011_CR_UARTEN | PL011_CR_TXE | PL011_CR_RXE;
+
+    // RX must not wait behind long handlers.
+    irq_register(IRQ_PL011, handle_uart_irq, IRQ_PRIO_HIGH);
+
+    // From now on uart_send queues bytes instead of dropping them.
+    smp_wmb();
+    uart_ready = 1;
+
+    // Separate the kernel output from the firmware's.
+    uart_send('\n');
+    uart_send('\n');
+    uart_send('\r');
+}
+
+/**
+ * @brief Sets the FIFO interrupt levels.
+ * 
+ * @param tx_level PL011_FIFO_* level of the transmit interrupt.
+ * @param rx_level PL011_FIFO_* level of the receive interrupt.
+ */
+void pl011_set_fifo_levels(uint8_t tx_level, uint8_t rx_level)
+{
+    PL011->IFLS = PL011_IFLS(tx_level & 0x7, rx_level & 0x7);
+}
+
+/**
+ * @brief Receives a character from the PL011.
+ * 
+ * This function waits until a character is available in the receive ring and
+ * returns it. While the ring is empty the receive FIFO is also polled, so the
+ * function works with IRQs masked; a task sleeps in sched_wait_event() between
+ * polls until the RX interrupt wakes it.
+ * 
+ * @return The character received from the PL011.
+ */
+char uart_recv(void)
+{
+    char c;
+
+    // Wait until the RX interrupt (or the polling fallback) has queued a byte.
+    while (!uart_try_recv(&c))
+    {
+        uart_rx_fill();
+
+        // A task blocks until the RX interrupt queues a byte; elsewhere the FIFO is polled
+        if (!irq_in_handler() && ring_buffer_empty(&uart_rx_ring))
+        {
+            sched_wait_event();
+        }
+    }
+
+    return c;
+}
+
+/**
+ * @brief Receives a character from the PL011 without waiting.
+ * 
+ * @param c Filled with the received character.
+ * 
+ * @return 1 if a character was received, 0 if the receive ring is empty.
+ */
+uint8_t uart_try_recv(char *c)
+{
+    uint8_t byte;
+
+    if (!ring_buffer_get(&uart_rx_ring, &byte))
+    {
+        return 0;
+    }
+
+    *c = (char)byte;
+
+    return 1;
+}
+
+/**
+ * @brief Sends a character over the PL011.
+ * 
+ * This function queues the character `c` in the transmit ring and enables the
+ * TX interrupt, which moves it to the hardware. That interrupt fires when the FIFO
+ * drains through its level, so an idle FIFO is primed directly. The function only
+ * waits when the ring is full; the ring is then drained synchronously, which also
+ * works with IRQs masked. A DMA transmit that owns the FIFO is waited for with the
+ * producer lock released. Characters sent before uart_init() are dropped.
+ * 
+ * @param c The character to send via the PL011.
+ */
+void uart_send(char c)
+{
+    uint64_t flags;
+
+    if (!uart_ready)
+    {
+        return;
+    }
+
+    // One producer at a time; IRQs off so an interrupt handler on this core can print too.
+    flags = spin_lock_irqsave(&uart_tx_prod_lock);
+
+    while (ring_buffer_put(&uart_tx_ring, (uint8_t)c) != 0)
+    {
+        // Ring full: let a DMA transmit finish, then push bytes to the FIFO ourselves.
+        if (pl011_dma_busy)
+        {
+            // Not under the lock: the completion interrupt must be able to run.
+            spin_unlock_irqrestore(&uart_tx_prod_lock, flags);
+            dma_wait(pl011_dma_channel);
+            flags = spin_lock_irqsave(&uart_tx_prod_lock);
+            continue;
+        }
+        uart_tx_drain(PL011_FIFO_DEPTH);
+    }
+
+    // Let the TX interrupt drain the ring (after a DMA transmit, pl011_dma_done() does).
+    smp_mb();
+    if (!pl011_dma_busy)
+    {
+        PL011->IMSC = PL011_IMSC_RX_TX;
+
+        // An empty FIFO will not cross its level: prime it.
+        if (PL011->FR & PL011_FR_TXFE)
+        {
+            uart_tx_drain(PL011_FIFO_DEPTH);
+        }
+    }
+
+    spin_unlock_irqrestore(&uart_tx_prod_lock, flags);
+}
+
+/**
+ * @brief Sends every queued character and waits for the transmitter to be idle.
+ * 
+ * Intended for panic paths and for code that must not return before its output
+ * is on the wire. Does not rely on interrupts.
+ */
+void uart_flush(void)
+{
+    if (!uart_ready)
+    {
+        return;
+    }
+
+    // A DMA transmit goes first (polled by dma_wait() when IRQs are masked).
+    if (pl011_dma_busy)
+    {
+        dma_wait(pl011_dma_channel);
+    }
+
+    // Empty the transmit ring by polling the FIFO.
+    while (!ring_buffer_empty(&uart_tx_ring))
+    {
+        uart_tx_drain(PL011_FIFO_DEPTH);
+    }
+
+    // Wait until the last byte has left the shift register.
+    while (PL011->FR & PL011_FR_BUSY)
+    {
+        ;
+    }
+}
+
+/**
+ * @brief Completion of a DMA transmit: hands the FIFO back to the ring.
+ * 
+ * @param channel The DMA channel.
+ * @param status  DMA_OK or DMA_EBUS.
+ * @param arg     Unused.
+ */
+static void pl011_dma_done(int channel, int status, void *arg)
+{
+    dma_callback_t callback = pl011_dma_callback;
+    void *callback_arg = pl011_dma_arg;
+
+    (void)arg;
+
+    PL011->DMACR = 0;                           // Stop the transmit DREQ
+    pl011_dma_busy = 0;
+    smp_mb();
+
+    // Characters queued during the transfer
+    uart_tx_drain(PL011_FIFO_DEPTH);
+
+    if (callback)
+    {
+        callback(channel, status, callback_arg);
+    }
+}
+
+/**
+ * @brief Sends a buffer with DMA, paced by the transmit DREQ.
+ * 
+ * @param channel  An allocated DMA channel.
+ * @param words    One character per 32-bit word (low byte), untouched until completion.
+ * @param count    Number of characters.
+ * @param callback Called on completion (IRQ context), or NULL.
+ * @param arg      Passed to the callback.
+ * 
+ * @return DMA_OK, DMA_EINVAL or DMA_EBUSY (a DMA transmit is already running).
+ */
+int pl011_send_dma(int channel, const uint32_t *words, uint32_t count, dma_callback_t callback, void *arg)
+{
+    int status;
+
+    if (!uart_ready || (count == 0))
+    {
+        return DMA_EINVAL;
+    }
+    if (atomic_cmpxchg(&pl011_dma_busy, 0, 1) != 0)
+    {
+        return DMA_EBUSY;
+    }
+
+    // The ring goes out first, then the FIFO belongs to the DMA (pl011_dma_busy).
+    while (!ring_buffer_empty(&uart_tx_ring))
+    {
+        spin_lock(&uart_tx_cons_lock);
+        while (!(PL011->FR & PL011_FR_TXFF) && !ring_buffer_empty(&uart_tx_ring))
+        {
+            uint8_t c;
+
+            ring_buffer_get(&uart_tx_ring, &c);
+            PL011->DR = c;
+        }
+        spin_unlock(&uart_tx_cons_lock);
+    }
+
+    pl011_dma_channel = channel;
+    pl011_dma_callback = callback;
+    pl011_dma_arg = arg;
+
+    PL011->DMACR = PL011_DMACR_TXDMAE;          // Transmit DREQ on
+    status = dma_fifo_write(channel, &PL011->DR, words, count * 4, DMA_DREQ_UART_TX, pl011_dma_done, 0);
+    if (status != DMA_OK)
+    {
+        PL011->DMACR = 0;
+        smp_wmb();
+        pl011_dma_busy = 0;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Handles the PL011 interrupt.
+ * 
+ * The whole receive FIFO is moved into the receive ring on the level, timeout and
+ * overrun interrupts, and up to one FIFO worth of bytes (PL011_FIFO_DEPTH) is moved
+ * from the transmit ring to the hardware.
+ */
+SECTION_HOT void handle_uart_irq(void)
+{
+    uint32_t mis = PL011->MIS;
+
+    if (mis & PL011_IMSC_RX_ONLY)
+    {
+        // Clear first: a byte or timeout arriving during the drain signals again
+        PL011->ICR = mis & PL011_IMSC_RX_ONLY;  // The timeout and overrun stay set until cleared
+        uart_rx_fill();
+    }
+
+    if (mis & PL011_INT_TX)
+    {
+        uart_tx_drain(PL011_FIFO_DEPTH);
+    }
+}
+
+#endif /* CONSOLE_UART == CONSOLE_UART_PL011 */
@@ -0,0 +1,151 @@
+/**
+ * @file        pool.c
+ * @brief       Fixed-size object pools.
+ * @description This file implements the pools declared in pool.h. A free object
+ *              stores the next free object in its first word while it is on the
+ *              shared list; the per-core caches are arrays, touched with IRQs masked
+ *              on their core only.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "pool.h"
+#include "page_alloc.h"
+#include "irq.h"
+#include "utils.h"
+
+/**
+ * @brief Carves a new page into objects on the shared free list.
+ * 
+ * Called with the pool lock held.
+ * 
+ * @param pool The pool.
+ * @return     0 on success, -1 if no page is left.
+ */
+static int pool_grow(struct pool *pool)
+{
+    uint8_t *page = page_alloc(1);
+    uint32_t offset;
+
+    if (page == 0)
+    {
+        return -1;
+    }
+
+    for (offset = 0; offset + pool->object_size <= PAGE_SIZE; offset += pool->object_size)
+    {
+        *(void **)(page + offset) = pool->free_list;
+        pool->free_list = page + offset;
+        pool->nr_objects++;
+    }
+    pool->nr_pages++;
+
+    return 0;
+}
+
+/**
+ * @brief Moves up to POOL_CACHE_BATCH objects from the shared list to a core cache.
+ * 
+ * @param pool  The pool.
+ * @param cache Cache of the calling core (IRQs masked).
+ */
+static void pool_refill(struct pool *pool, struct pool_cache *cache)
+{
+    void *object;
+
+    spin_lock(&pool->lock);
+
+    if ((pool->free_list != 0) || (pool_grow(pool) == 0))
+    {
+        while ((cache->count < POOL_CACHE_BATCH) && (pool->free_list != 0))
+        {
+            object = pool->free_list;
+            pool->free_list = *(void **)object;
+            cache->objects[cache->count++] = object;
+        }
+    }
+
+    spin_unlock(&pool->lock);
+}
+
+/**
+ * @brief Moves POOL_CACHE_BATCH objects from a core cache to the shared list.
+ * 
+ * @param pool  The pool.
+ * @param cache Cache of the calling core (IRQs masked), full.
+ */
+static void pool_drain(struct pool *pool, struct pool_cache *cache)
+{
+    void *object;
+    uint32_t i;
+
+    spin_lock(&pool->lock);
+
+    for (i = 0; i < POOL_CACHE_BATCH; i++)
+    {
+        object = cache->objects[--cache->count];
+        *(void **)object = pool->free_list;
+        pool->free_list = object;
+    }
+
+    spin_unlock(&pool->lock);
+}
+
+/**
+ * @brief Allocates an object.
+ * 
+ * @param pool The pool.
+ * @return     The object, or NULL if no memory is left.
+ */
+void *pool_alloc(struct pool *pool)
+{
+    struct pool_cache *cache;
+    void *object = 0;
+    uint64_t flags;
+
+    // The cache belongs to this core: only an IRQ handler on it can race with us
+    flags = irq_save();
+    cache = &pool->cache[get_core_id()];
+
+    if (cache->count == 0)
+    {
+        pool_refill(pool, cache);
+    }
+    if (cache->count > 0)
+    {
+        object = cache->objects[--cache->count];
+    }
+
+    irq_restore(flags);
+
+    return object;
+}
+
+/**
+ * @brief Returns an object to its pool.
+ * 
+ * @param pool   The pool the object was allocated from.
+ * @param object The object (NULL is ignored).
+ */
+void pool_free(struct pool *pool, void *object)
+{
+    struct pool_cache *cache;
+    uint64_t flags;
+
+    if (object == 0)
+    {
+        return;
+    }
+
+    flags = irq_save();
+    cache = &pool->cache[get_core_id()];
+
+    if (cache->count == POOL_CACHE_SIZE)
+    {
+        pool_drain(pool, cache);
+    }
+    cache->objects[cache->count++] = object;
+
+    irq_restore(flags);
+}
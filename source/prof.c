@@ -0,0 +1,240 @@
+/**
+ * @file        prof.c
+ * @brief       PMU cycle profiling and hot-path trace.
+ * @description This file implements the probes declared in prof.h. The trace ring
+ *              and the statistics of a core have a single writer, the core itself
+ *              (IRQs are masked while they are updated, so an interrupt cannot
+ *              interleave with the scope it interrupted); prof_dump() reads them
+ *              without stopping the writers, so a dump taken under load may show a
+ *              few records overwritten while it prints.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "prof.h"
+
+#if PROFILE
+
+#include "base.h"
+#include "mm.h"
+#include "irq.h"
+#include "atomic.h"
+#include "spinlock.h"
+#include "utils.h"
+#include "uart_printf.h"
+
+/**
+ * @brief Profiling state of one core.
+ */
+struct prof_core {
+    volatile uint32_t head;                         // Records written so far
+    struct prof_record records[PROF_RING_SIZE];     // Last PROF_RING_SIZE records
+    struct prof_stats stats[PROF_NR_PROBES];
+};
+
+// One state per core
+static struct prof_core prof_cores[NR_CORES];
+
+// Events of the counters, programmed by prof_core_init()
+static volatile uint32_t prof_events[PROF_NR_EVENTS] = {
+    PMU_EV_L1D_CACHE_REFILL,
+    PMU_EV_L2D_CACHE_REFILL,
+    PMU_EV_BR_MIS_PRED,
+    PMU_EV_STALL_LOAD,
+};
+
+// Only one core dumps at a time
+static spinlock_t prof_dump_lock = SPINLOCK_INIT;
+
+// Probe names, indexed by PROF_PROBE_*
+static const char *const prof_probe_names[PROF_NR_PROBES] = {
+    "irq",
+    "i2c_write",
+    "lcd_send",
+    "dht22_read",
+    "uart_printf",
+};
+
+/**
+ * @brief Appends a record to the trace ring of a core (IRQs masked).
+ * 
+ * @param core   State of the calling core.
+ * @param probe  PROF_PROBE_*.
+ * @param type   PROF_TRACE_*.
+ * @param cycles Cycle stamp.
+ */
+static void prof_trace(struct prof_core *core, uint32_t probe, uint32_t type, uint64_t cycles)
+{
+    struct prof_record *rec = &core->records[core->head & (PROF_RING_SIZE - 1)];
+
+    // The ring keeps the latest records: the oldest one is overwritten
+    rec->cycles = cycles;
+    rec->probe = probe;
+    rec->type = type;
+    smp_wmb();
+    core->head++;
+}
+
+/**
+ * @brief Enables the PMU of the calling core with the configured events.
+ */
+void prof_core_init(void)
+{
+    struct prof_core *core = &prof_cores[get_core_id()];
+    uint32_t i;
+
+    memset(core, 0, sizeof(*core));
+
+    for (i = 0; i < PROF_NR_EVENTS; i++)
+    {
+        prof_pmu_set_event(i, prof_events[i]);
+    }
+    prof_pmu_enable();
+}
+
+/**
+ * @brief Selects the event of a counter.
+ */
+int prof_set_event(uint32_t counter, uint32_t event)
+{
+    if (counter >= PROF_NR_EVENTS)
+    {
+        return -1;
+    }
+
+    prof_events[counter] = event;
+    prof_pmu_set_event(counter, event);
+
+    return 0;
+}
+
+/**
+ * @brief Opens a scope: records its entry and samples the counters.
+ */
+struct prof_scope prof_begin(uint32_t probe)
+{
+    struct prof_scope scope;
+    uint64_t flags;
+
+    scope.probe = probe;
+
+    flags = irq_save();
+    prof_read_events(scope.events);
+    scope.cycles = prof_read_cycles();
+    prof_trace(&prof_cores[get_core_id()], probe, PROF_TRACE_BEGIN, scope.cycles);
+    irq_restore(flags);
+
+    return scope;
+}
+
+/**
+ * @brief Closes a scope: records its exit and adds its cost to the statistics.
+ */
+void prof_end(struct prof_scope *scope)
+{
+    struct prof_core *core;
+    struct prof_stats *stats;
+    uint32_t events[PROF_NR_EVENTS];
+    uint64_t cycles;
+    uint64_t flags;
+    uint32_t i;
+
+    // Counters first, so the bookkeeping below is not charged to the scope
+    cycles = prof_read_cycles();
+    prof_read_events(events);
+
+    flags = irq_save();
+
+    core = &prof_cores[get_core_id()];
+    prof_trace(core, scope->probe, PROF_TRACE_END, cycles);
+
+    stats = &core->stats[scope->probe];
+    cycles -= scope->cycles;
+    stats->count++;
+    stats->cycles += cycles;
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+    for (i = 0; i < PROF_NR_EVENTS; i++)
+    {
+        // 32-bit counters: the difference is right across one wrap
+        stats->events[i] += (uint32_t)(events[i] - scope->events[i]);
+    }
+
+    irq_restore(flags);
+}
+
+/**
+ * @brief Prints the statistics of the probes (all cores) and the trace of each core.
+ */
+void prof_dump(void)
+{
+    struct prof_core *core;
+    struct prof_record *rec;
+    struct prof_stats total;
+    uint32_t head;
+    uint32_t start;
+    uint32_t probe;
+    uint32_t i;
+    int c;
+
+    if (!spin_trylock(&prof_dump_lock))
+    {
+        return;
+    }
+
+    uart_printf("prof: events %x %x %x %x\n", prof_events[0], prof_events[1], prof_events[2], prof_events[3]);
+
+    // Statistics, summed over the cores
+    for (probe = 0; probe < PROF_NR_PROBES; probe++)
+    {
+        memset(&total, 0, sizeof(total));
+        for (c = 0; c < NR_CORES; c++)
+        {
+            core = &prof_cores[c];
+            total.count += core->stats[probe].count;
+            total.cycles += core->stats[probe].cycles;
+            if (core->stats[probe].max_cycles > total.max_cycles)
+            {
+                total.max_cycles = core->stats[probe].max_cycles;
+            }
+            for (i = 0; i < PROF_NR_EVENTS; i++)
+            {
+                total.events[i] += core->stats[probe].events[i];
+            }
+        }
+
+        if (total.count == 0)
+        {
+            continue;
+        }
+
+        uart_printf("prof: %s count=%u avg=%llu max=%llu ev=%llu %llu %llu %llu\n",
+                    prof_probe_names[probe], total.count, total.cycles / total.count,
+                    total.max_cycles, total.events[0], total.events[1], total.events[2],
+                    total.events[3]);
+    }
+
+    // Latest records of each core, oldest first
+    for (c = 0; c < NR_CORES; c++)
+    {
+        core = &prof_cores[c];
+        head = core->head;
+        smp_rmb();
+        start = (head > PROF_RING_SIZE) ? (head - PROF_RING_SIZE) : 0;
+
+        for (i = start; i < head; i++)
+        {
+            rec = &core->records[i & (PROF_RING_SIZE - 1)];
+            uart_printf("prof: core %d %llu %c %s\n", c, rec->cycles,
+                        (rec->type == PROF_TRACE_BEGIN) ? 'B' : 'E',
+                        (rec->probe < PROF_NR_PROBES) ? prof_probe_names[rec->probe] : "?");
+        }
+    }
+
+    spin_unlock(&prof_dump_lock);
+}
+
+#endif /* PROFILE */
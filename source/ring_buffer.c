@@ -0,0 +1,107 @@
+/**
+ * @file        ring_buffer.c
+ * @brief       Lock-free single-producer/single-consumer byte ring buffer.
+ * @description This file implements the ring buffer declared in ring_buffer.h.
+ *              The producer stores the byte before publishing the new head; the
+ *              consumer reads the byte before releasing the slot with the new tail.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "ring_buffer.h"
+#include "atomic.h"
+#include "sections.h"
+
+/**
+ * @brief Initializes an empty ring buffer over caller-provided storage.
+ * 
+ * @param rb      Pointer to the ring buffer.
+ * @param storage Backing storage.
+ * @param size    Size of the storage in bytes (must be a power of two).
+ */
+void ring_buffer_init(struct ring_buffer *rb, uint8_t *storage, uint32_t size)
+{
+    rb->head = 0;
+    rb->tail = 0;
+    rb->mask = size - 1;
+    rb->data = storage;
+}
+
+/**
+ * @brief Appends a byte (producer side).
+ * 
+ * @param rb Pointer to the ring buffer.
+ * @param c  Byte to append.
+ * 
+ * @return 0 on success, -1 if the ring is full.
+ */
+SECTION_HOT int ring_buffer_put(struct ring_buffer *rb, uint8_t c)
+{
+    uint32_t head = rb->head;
+
+    // Full when the producer is a whole ring ahead of the consumer.
+    if ((head - rb->tail) > rb->mask)
+    {
+        return -1;
+    }
+
+    // Store the byte, then publish it.
+    rb->data[head & rb->mask] = c;
+    smp_wmb();
+    rb->head = head + 1;
+
+    return 0;
+}
+
+/**
+ * @brief Removes the oldest byte (consumer side).
+ * 
+ * @param rb Pointer to the ring buffer.
+ * @param c  Filled with the removed byte.
+ * 
+ * @return 1 if a byte was removed, 0 if the ring is empty.
+ */
+SECTION_HOT int ring_buffer_get(struct ring_buffer *rb, uint8_t *c)
+{
+    uint32_t tail = rb->tail;
+
+    if (tail == rb->head)
+    {
+        return 0;
+    }
+
+    // Read the byte only after observing the head that published it.
+    smp_rmb();
+    *c = rb->data[tail & rb->mask];
+
+    // Finish the read before handing the slot back to the producer.
+    smp_mb();
+    rb->tail = tail + 1;
+
+    return 1;
+}
+
+/**
+ * @brief Returns the number of bytes currently stored.
+ * 
+ * @param rb Pointer to the ring buffer.
+ * 
+ * @return The number of bytes that can be read.
+ */
+uint32_t ring_buffer_count(struct ring_buffer *rb)
+{
+    return rb->head - rb->tail;
+}
+
+/**
+ * @brief Tells whether the ring is empty.
+ * 
+ * @param rb Pointer to the ring buffer.
+ * 
+ * @return 1 if the ring is empty, 0 otherwise.
+ */
+uint8_t ring_buffer_empty(struct ring_buffer *rb)
+{
+    return (rb->head == rb->tail) ? 1 : 0;
+}
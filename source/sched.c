@@ -0,0 +1,446 @@
+/**
+ * @file        sched.c
+ * @brief       Preemptive priority scheduler of kernel tasks.
+ * @description This file implements the tasks of SCHED_CORE: one FIFO run queue per
+ *              priority, the event wait list of sched_wait_event(), task creation and
+ *              exit, and the switch points (voluntary and on IRQ return). Only
+ *              SCHED_CORE switches tasks, with IRQs masked; the lock protects the
+ *              queues against wakeups from the other cores.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "sched.h"
+#include "mm.h"
+#include "page_alloc.h"
+#include "pool.h"
+#include "irq.h"
+#include "utils.h"
+#include "spinlock.h"
+#include "atomic.h"
+#include "sections.h"
+
+volatile uint32_t sched_need_resched[NR_CORES];
+
+// Boot context of SCHED_CORE, run when no task is ready
+static struct task sched_idle_task;
+
+// Running task of SCHED_CORE
+static struct task *sched_running_task;
+
+// Ready tasks, by priority
+static struct task *sched_rq_head[SCHED_NR_PRIO];
+static struct task *sched_rq_tail[SCHED_NR_PRIO];
+
+// Tasks blocked in sched_wait_event()
+static struct task *sched_waiters;
+
+// Incremented by every sched_send_event()
+static volatile uint32_t sched_event_gen;
+
+// Exited task whose stack is still in use, freed by the next task to run
+static struct task *sched_zombie;
+
+// Set once sched_init() has run
+static volatile uint8_t sched_ready;
+
+// Protects the run queues, the wait list and the task states
+static spinlock_t sched_lock = SPINLOCK_INIT;
+
+// Task structures
+static struct pool sched_task_pool = POOL_INIT(sizeof(struct task));
+
+static void sched_task_start(void) __attribute__((noreturn));
+
+/**
+ * @brief Appends a task to the run queue of its priority (lock held).
+ * 
+ * @param task The task.
+ */
+static void sched_enqueue(struct task *task)
+{
+    task->state = TASK_READY;
+    task->next = 0;
+    if (sched_rq_tail[task->priority])
+    {
+        sched_rq_tail[task->priority]->next = task;
+    }
+    else
+    {
+        sched_rq_head[task->priority] = task;
+    }
+    sched_rq_tail[task->priority] = task;
+}
+
+/**
+ * @brief Removes the first task of the highest non-empty priority (lock held).
+ * 
+ * @return The task, or NULL if no task is ready.
+ */
+static struct task *sched_dequeue(void)
+{
+    struct task *task;
+    uint32_t prio;
+
+    for (prio = 0; prio < SCHED_NR_PRIO; prio++)
+    {
+        task = sched_rq_head[prio];
+        if (task)
+        {
+            sched_rq_head[prio] = task->next;
+            if (sched_rq_head[prio] == 0)
+            {
+                sched_rq_tail[prio] = 0;
+            }
+            return task;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Tells whether a task of at least the given priority is ready (lock optional).
+ * 
+ * @param priority Lowest priority to consider.
+ * @return         1 if such a task is ready, 0 otherwise.
+ */
+static uint8_t sched_ready_at(uint8_t priority)
+{
+    uint32_t prio;
+
+    for (prio = 0; (prio <= priority) && (prio < SCHED_NR_PRIO); prio++)
+    {
+        if (sched_rq_head[prio])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Frees the task that exited before the current one was resumed.
+ */
+static void sched_reap(void)
+{
+    struct task *zombie = sched_zombie;
+
+    if (zombie && (zombie != sched_running_task))
+    {
+        sched_zombie = 0;
+        page_free(zombie->stack, TASK_STACK_PAGES);
+        pool_free(&sched_task_pool, zombie);
+    }
+}
+
+/**
+ * @brief Picks the next task and switches to it.
+ * 
+ * A running task goes back to the tail of its run queue; a waiting or dead one does
+ * not. Called on SCHED_CORE with IRQs masked. Returns once the calling task is
+ * resumed.
+ */
+SECTION_HOT static void sched_switch(void)
+{
+    struct task *prev = sched_running_task;
+    struct task *next;
+
+    spin_lock(&sched_lock);
+
+    if ((prev->state == TASK_RUNNING) && (prev != &sched_idle_task))
+    {
+        sched_enqueue(prev);
+    }
+
+    next = sched_dequeue();
+    if (next == 0)
+    {
+        next = &sched_idle_task;
+    }
+    next->state = TASK_RUNNING;
+    sched_need_resched[SCHED_CORE] = 0;
+
+    spin_unlock(&sched_lock);
+
+    if (next != prev)
+    {
+        // Only this core runs tasks: prev cannot be resumed before the switch completes
+        sched_running_task = next;
+        cpu_switch_to(prev, next);
+        sched_reap();
+    }
+}
+
+/**
+ * @brief Tells whether the caller is a task that can switch now.
+ * 
+ * @return 1 on SCHED_CORE, in task context with IRQs enabled, 0 otherwise.
+ */
+static uint8_t sched_can_switch(void)
+{
+    return sched_ready && (get_core_id() == SCHED_CORE) && !irq_in_handler();
+}
+
+/**
+ * @brief First code of a new task: enables interrupts and runs its entry point.
+ */
+static void sched_task_start(void)
+{
+    struct task *task = sched_running_task;
+
+    sched_reap();
+
+    // Switched to with IRQs (and possibly FIQs) masked
+    irq_enable();
+    fiq_enable();
+
+    task->fn(task->arg);
+
+    task_exit();
+}
+
+/**
+ * @brief Initializes the scheduler; the calling context (SCHED_CORE) becomes the idle task.
+ */
+SECTION_INIT void sched_init(void)
+{
+    sched_idle_task.name = "idle";
+    sched_idle_task.priority = SCHED_NR_PRIO;
+    sched_idle_task.state = TASK_RUNNING;
+    sched_running_task = &sched_idle_task;
+
+    smp_wmb();
+    sched_ready = 1;
+}
+
+/**
+ * @brief Creates a ready task.
+ * 
+ * @param name     Name of the task (kept, not copied).
+ * @param fn       Entry point; returning from it ends the task.
+ * @param arg      Argument of the entry point.
+ * @param priority TASK_PRIO_*.
+ * 
+ * @return The task, or NULL if there is no memory left or the priority is invalid.
+ */
+struct task *task_create(const char *name, task_fn_t fn, void *arg, uint8_t priority)
+{
+    struct task *task;
+    uint8_t *stack;
+    uint64_t flags;
+
+    if ((priority >= SCHED_NR_PRIO) || (fn == 0))
+    {
+        return 0;
+    }
+
+    task = pool_alloc(&sched_task_pool);
+    stack = page_alloc(TASK_STACK_PAGES);
+    if ((task == 0) || (stack == 0))
+    {
+        pool_free(&sched_task_pool, task);
+        page_free(stack, TASK_STACK_PAGES);
+        return 0;
+    }
+
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->fn = fn;
+    task->arg = arg;
+    task->priority = priority;
+    task->stack = stack;
+
+    // cpu_switch_to() "returns" to sched_task_start on the empty stack
+    task->context.sp = (uint64_t)stack + TASK_STACK_PAGES * PAGE_SIZE;
+    task->context.pc = (uint64_t)sched_task_start;
+
+    flags = spin_lock_irqsave(&sched_lock);
+    task->event_gen = sched_event_gen;
+    sched_enqueue(task);
+    if (priority < sched_running_task->priority)
+    {
+        sched_need_resched[SCHED_CORE] = 1;
+    }
+    spin_unlock_irqrestore(&sched_lock, flags);
+
+    return task;
+}
+
+/**
+ * @brief Ends the calling task. Its stack is freed by the next task to run.
+ */
+void task_exit(void)
+{
+    irq_save();
+
+    spin_lock(&sched_lock);
+    sched_running_task->state = TASK_DEAD;
+    sched_zombie = sched_running_task;
+    spin_unlock(&sched_lock);
+
+    sched_switch();
+
+    // Never resumed
+    while (1)
+    {
+    }
+}
+
+/**
+ * @brief Returns the running task of SCHED_CORE.
+ * 
+ * @return The current task (the idle task outside of the tasks).
+ */
+struct task *sched_current(void)
+{
+    return sched_running_task;
+}
+
+/**
+ * @brief Lets the other ready tasks of the same or a higher priority run.
+ */
+void sched_yield(void)
+{
+    uint64_t flags;
+
+    if (!sched_can_switch())
+    {
+        return;
+    }
+
+    flags = irq_save();
+    sched_switch();
+    irq_restore(flags);
+}
+
+/**
+ * @brief Blocks the calling task until the next sched_send_event().
+ */
+void sched_wait_event(void)
+{
+    struct task *task;
+    uint64_t flags;
+
+    if (!sched_can_switch() || (sched_running_task == &sched_idle_task))
+    {
+        cpu_wait_event();
+        return;
+    }
+
+    flags = irq_save();
+    spin_lock(&sched_lock);
+
+    task = sched_running_task;
+    if (task->event_gen != sched_event_gen)
+    {
+        // An event arrived since the last wait: like WFE with the event register set
+        task->event_gen = sched_event_gen;
+        spin_unlock(&sched_lock);
+        irq_restore(flags);
+        return;
+    }
+
+    task->state = TASK_WAITING;
+    task->next = sched_waiters;
+    sched_waiters = task;
+
+    spin_unlock(&sched_lock);
+
+    sched_switch();
+
+    irq_restore(flags);
+}
+
+/**
+ * @brief Wakes every task blocked in sched_wait_event() and executes SEV.
+ */
+void sched_send_event(void)
+{
+    struct task *task;
+    uint64_t flags;
+
+    if (sched_ready)
+    {
+        flags = spin_lock_irqsave(&sched_lock);
+
+        sched_event_gen++;
+        while (sched_waiters)
+        {
+            task = sched_waiters;
+            sched_waiters = task->next;
+            task->event_gen = sched_event_gen;
+            sched_enqueue(task);
+            if (task->priority < sched_running_task->priority)
+            {
+                sched_need_resched[SCHED_CORE] = 1;
+            }
+        }
+
+        spin_unlock_irqrestore(&sched_lock, flags);
+    }
+
+    cpu_send_event();
+}
+
+/**
+ * @brief Idle task body: runs the ready tasks, then waits for an event.
+ */
+void sched_idle(void)
+{
+    uint64_t flags;
+
+    if (sched_can_switch() && (sched_running_task == &sched_idle_task))
+    {
+        flags = irq_save();
+        sched_switch();
+        irq_restore(flags);
+    }
+
+    // A wakeup after the switch set the event register: WFE returns at once
+    cpu_wait_event();
+}
+
+/**
+ * @brief Scheduler part of the per-core tick (IRQ context).
+ */
+SECTION_HOT void sched_tick(void)
+{
+    if (!sched_ready || (get_core_id() != SCHED_CORE))
+    {
+        return;
+    }
+
+    // Time slice over: rotate among the tasks of the same priority
+    if (sched_ready_at(sched_running_task->priority))
+    {
+        sched_need_resched[SCHED_CORE] = 1;
+    }
+}
+
+/**
+ * @brief Switches tasks on the return of the outermost IRQ (called by irq_exit).
+ * 
+ * In FPU builds the FP/SIMD registers of the interrupted task are live and not in
+ * its IRQ frame: they are saved around the switch, so this function must not use
+ * them itself.
+ */
+SECTION_HOT FPSIMD_GENERAL_REGS_ONLY void sched_preempt(void)
+{
+    if (!sched_ready || (get_core_id() != SCHED_CORE))
+    {
+        return;
+    }
+
+#if FPU
+    fpsimd_save_state(sched_running_task->fpsimd);
+#endif
+
+    sched_switch();
+
+#if FPU
+    fpsimd_restore_state(sched_running_task->fpsimd);
+#endif
+}
@@ -0,0 +1,156 @@
+/**
+ * @file        smp.c
+ * @brief       Secondary core bring-up and cross-core work dispatch.
+ * @description This file releases cores 1 to 3 through the spin table of the armstub
+ *              and implements the per-core and shared work queues they serve.
+ *              A released core re-enters _start, drops to EL1 like core 0, picks its
+ *              own stack and enables the MMU with the tables built by core 0.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "smp.h"
+#include "mm.h"
+#include "irq.h"
+#include "atomic.h"
+#include "utils.h"
+#include "local_timer.h"
+#include "prof.h"
+#include "sections.h"
+
+// Kernel entry point, defined in boot.S
+extern char _start[];
+
+// Work queued for a specific core
+static struct work_queue core_queue[NR_CORES];
+
+// Work that may run on any core
+static struct work_queue shared_queue;
+
+// Set by each core once it is ready to run work
+static volatile uint32_t core_online[NR_CORES];
+
+/**
+ * @brief Releases the secondary cores.
+ */
+SECTION_INIT void smp_init(void)
+{
+    volatile uint64_t *spin_table = (volatile uint64_t *)SPIN_TABLE_BASE;
+    uint8_t core;
+
+    // Prepare the queues before any core can use them.
+    for (core = 0; core < NR_CORES; core++)
+    {
+        work_queue_init(&core_queue[core]);
+    }
+    work_queue_init(&shared_queue);
+    core_online[SMP_MASTER_CORE] = 1;
+
+    for (core = 1; core < NR_CORES; core++)
+    {
+        // Publish the entry point in the slot of the core.
+        spin_table[core] = (uint64_t)_start;
+    }
+
+    // The parked cores read the table with their caches off: push it to memory.
+    dcache_clean_range(SPIN_TABLE_BASE, NR_CORES * sizeof(uint64_t));
+
+    // Wake the cores waiting in WFE.
+    cpu_send_event();
+}
+
+/**
+ * @brief Main loop of a secondary core.
+ */
+void secondary_main(void)
+{
+    uint8_t core = get_core_id();
+
+    // Install the exception vectors on this core.
+    irq_init();
+
+    // Count cycles and PMU events for the profiling probes.
+    prof_core_init();
+
+    // Start the private tick of this core and take its interrupts.
+    local_timer_core_init();
+    irq_enable();
+
+    // Announce that the core is ready to run work.
+    smp_wmb();
+    core_online[core] = 1;
+
+    while (1)
+    {
+        // Sleep until a producer signals new work.
+        if (smp_poll() == 0)
+        {
+            cpu_wait_event();
+        }
+    }
+}
+
+/**
+ * @brief Queues a function to run on a given core.
+ */
+int smp_call(uint8_t core, work_fn_t fn, void *arg)
+{
+    if (core >= NR_CORES)
+    {
+        return -1;
+    }
+
+    if (work_queue_push(&core_queue[core], fn, arg) != 0)
+    {
+        return -1;
+    }
+
+    // Wake the target core if it is sleeping in WFE.
+    cpu_send_event();
+
+    return 0;
+}
+
+/**
+ * @brief Queues a function to run on the first available core.
+ */
+int smp_queue_work(work_fn_t fn, void *arg)
+{
+    if (work_queue_push(&shared_queue, fn, arg) != 0)
+    {
+        return -1;
+    }
+
+    // Wake the idle cores; the first one to take the lock runs the item.
+    cpu_send_event();
+
+    return 0;
+}
+
+/**
+ * @brief Runs the work pending for the calling core and the shared work.
+ */
+uint32_t smp_poll(void)
+{
+    uint32_t count;
+
+    // Work targeted at this core first, then the shared work.
+    count = work_queue_run(&core_queue[get_core_id()]);
+    count += work_queue_run(&shared_queue);
+
+    return count;
+}
+
+/**
+ * @brief Tells whether a core has been brought up.
+ */
+uint8_t smp_core_online(uint8_t core)
+{
+    if (core >= NR_CORES)
+    {
+        return 0;
+    }
+
+    return core_online[core] ? 1 : 0;
+}
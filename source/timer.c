@@ -12,15 +12,54 @@
 
 
 #include "timer.h"
-#include "mini_uart.h"
+#include "uart.h"
 #include "uart_printf.h"
 #include "irq.h"
-#include "act_led.h"
+#include "local_timer.h"
+#include "spinlock.h"
+#include "utils.h"
+#include "sched.h"
+#include "sections.h"
+
+/**
+ * @brief A software timer.
+ */
+struct soft_timer {
+    uint64_t deadline;              // Expiry time (System Timer µs)
+    uint32_t period;                // Period of a periodic timer, 0 for a one-shot timer
+    uint32_t heap_idx;              // Position in timer_heap, TIMER_MAX_SOFT when not armed
+    uint32_t generation;            // Incremented when the slot is released (stale ids)
+    timer_callback_t callback;      // Function called on expiry
+    void *arg;                      // Argument passed to the callback
+};
+
+// Software timer slots and the min-heap of armed timers, ordered by deadline
+static struct soft_timer timer_slots[TIMER_MAX_SOFT];
+static struct soft_timer *timer_heap[TIMER_MAX_SOFT];
+static uint32_t timer_heap_size;
+
+// Protects the slots, the heap and the compare register
+static spinlock_t timer_lock = SPINLOCK_INIT;
+
+// System Timer compare channel driving the software timers
+static uint8_t timer_channel = TIMER_1;
+
+// Set once timer_init() has run: sleep_until() may arm timers
+static volatile uint8_t timer_ready;
 
 static uint32_t timer_get_lower(void);
 static uint32_t timer_get_higher(void);
+static uint64_t timer_read_counter(void);
 static void timer_set_compare(uint8_t compare_idx, uint32_t value);
 static void timer_clear_interrupt(uint8_t timer_idx);
+static void timer_handle_irq(void);
+static void timer_heap_swap(uint32_t a, uint32_t b);
+static void timer_heap_up(uint32_t idx);
+static void timer_heap_down(uint32_t idx);
+static void timer_heap_insert(struct soft_timer *timer);
+static void timer_heap_remove(struct soft_timer *timer);
+static void timer_program(void);
+static void sleep_wake(void *arg);
 
 /**
  * @brief Retrieves the lower 32 bits of the system timer counter.
@@ -73,23 +112,27 @@ static void timer_set_compare(uint8_t compare_idx, uint32_t value)
  */
 static void timer_clear_interrupt(uint8_t timer_idx)
 {
-    // Clear the interrupt flag by writing to the control/status register.
-    TIMER->CS |= 1 << timer_idx;
+    // Clear the interrupt flag by writing 1 to its bit (a read-modify-write would
+    // also clear the pending matches of the other channels).
+    TIMER->CS = 1 << timer_idx;
 }
 
 /**
- * @brief       Get the current timer value (ticks).
- * @description This function reads the lower and higher 32 bits of the system timer 
- *              to return a 64-bit value representing the current timer ticks.
+ * @brief Reads the 64-bit System Timer counter.
+ * @description Reads the higher, lower, then higher 32 bits again, and re-reads both
+ *              if a carry happened in between.
  * 
- * @return      A 64-bit value representing the current timer ticks.
+ * @return The System Timer counter (µs).
  */
-uint64_t timer_get_ticks(void) 
+static uint64_t timer_read_counter(void)
 {
+    uint32_t hi;
+    uint32_t lo;
+
     // Get the higher 32 bits of the timer.
-    uint32_t hi = timer_get_higher();
+    hi = timer_get_higher();
     // Get the lower 32 bits of the timer.
-    uint32_t lo = timer_get_lower();
+    lo = timer_get_lower();
 
     // Double-check if the high value has changed after reading it.
     if (hi != timer_get_higher())
@@ -104,54 +147,477 @@ uint64_t timer_get_ticks(void)
 }
 
 /**
- * @brief Initializes the specified system timer.
- * @description This function configures the specified system timer based on the timer index.
- *              It prepares the timer for use by setting up necessary control registers and 
- *              interrupt settings.
+ * @brief       Get the current timer value (ticks).
+ * @description This function returns a 64-bit value representing the current System 
+ *              Timer ticks (microseconds). Once local_timer_init() has aligned the 
+ *              generic timer on the System Timer, the value is derived from CNTPCT_EL0 
+ *              (one system-register read). Before that, the lower and higher 32 bits 
+ *              of the System Timer are read directly.
  * 
- * @param timer_idx The index of the timer to initialize (e.g., TIMER_1, TIMER_3).
+ * @return      A 64-bit value representing the current timer ticks.
  */
-void timer_init(uint8_t timer_idx)
+uint64_t timer_get_ticks(void) 
 {
-    uint32_t current_val;
+    // Fast path: the generic timer runs on the same crystal as the System Timer.
+    if (local_timer_ready())
+    {
+        return local_timer_get_us();
+    }
 
-    if (TIMER_1 == timer_idx) 
+    return timer_read_counter();
+}
+
+/**
+ * @brief Swaps two entries of the timer heap.
+ * 
+ * @param a Index of the first entry.
+ * @param b Index of the second entry.
+ */
+static void timer_heap_swap(uint32_t a, uint32_t b)
+{
+    struct soft_timer *tmp = timer_heap[a];
+
+    timer_heap[a] = timer_heap[b];
+    timer_heap[b] = tmp;
+    // Keep the back-references used by timer_cancel() up to date
+    timer_heap[a]->heap_idx = a;
+    timer_heap[b]->heap_idx = b;
+}
+
+/**
+ * @brief Moves a heap entry up until its parent expires first.
+ * 
+ * @param idx Index of the entry.
+ */
+static void timer_heap_up(uint32_t idx)
+{
+    while (idx > 0)
     {
-        // Calculate the next compare value.
-        current_val = timer_get_lower() + ARM_CLOCK_FREQUENCY_HZ/2;
-        // Set the compare value for the timer.
-        timer_set_compare(timer_idx, current_val);
-        // Toggle the ACT LED as part of initialization.
-        act_led_toggle();
+        uint32_t parent = (idx - 1) / 2;
+
+        if (timer_heap[parent]->deadline <= timer_heap[idx]->deadline)
+        {
+            break;
+        }
+        timer_heap_swap(parent, idx);
+        idx = parent;
     }
+}
 
-    if (TIMER_3 == timer_idx) {
-        // Timer 3 is not currently used.
+/**
+ * @brief Moves a heap entry down until both children expire later.
+ * 
+ * @param idx Index of the entry.
+ */
+static void timer_heap_down(uint32_t idx)
+{
+    while (1)
+    {
+        uint32_t child = 2 * idx + 1;
+
+        if (child >= timer_heap_size)
+        {
+            break;
+        }
+        // Pick the child that expires first
+        if ((child + 1 < timer_heap_size) &&
+            (timer_heap[child + 1]->deadline < timer_heap[child]->deadline))
+        {
+            child++;
+        }
+        if (timer_heap[idx]->deadline <= timer_heap[child]->deadline)
+        {
+            break;
+        }
+        timer_heap_swap(idx, child);
+        idx = child;
     }
 }
 
+/**
+ * @brief Inserts an armed timer into the heap.
+ * 
+ * @param timer Timer with its deadline set.
+ */
+static void timer_heap_insert(struct soft_timer *timer)
+{
+    timer->heap_idx = timer_heap_size;
+    timer_heap[timer_heap_size++] = timer;
+    timer_heap_up(timer->heap_idx);
+}
+
+/**
+ * @brief Removes a timer from the heap.
+ * 
+ * @param timer Armed timer.
+ */
+static void timer_heap_remove(struct soft_timer *timer)
+{
+    uint32_t idx = timer->heap_idx;
+    struct soft_timer *moved;
+
+    timer->heap_idx = TIMER_MAX_SOFT;
+    timer_heap_size--;
+    if (idx == timer_heap_size)
+    {
+        return;
+    }
+    // Move the last entry into the hole and restore the heap order around it
+    moved = timer_heap[timer_heap_size];
+    timer_heap[idx] = moved;
+    moved->heap_idx = idx;
+    timer_heap_up(idx);
+    timer_heap_down(moved->heap_idx);
+}
+
+/**
+ * @brief Programs the compare register for the nearest deadline.
+ * @description The match is exact on the lower 32 bits of the counter, so a value the
+ *              counter has already passed would only fire after a 2^32 µs wrap. The
+ *              value is kept at least TIMER_MIN_DELTA_US ahead and read back against
+ *              the counter; if the counter got there first, a later value is written.
+ *              Must be called with timer_lock held.
+ */
+static void timer_program(void)
+{
+    uint64_t now;
+    uint64_t target;
+    uint32_t delta = TIMER_MIN_DELTA_US;
+
+    // Nothing armed: leave the channel idle
+    if (0 == timer_heap_size)
+    {
+        return;
+    }
+
+    while (1)
+    {
+        now = timer_read_counter();
+        target = timer_heap[0]->deadline;
+
+        // Far deadline: wake up once on the way, before the 32-bit compare wraps
+        if (target > now + TIMER_MAX_SLEEP_US)
+        {
+            target = now + TIMER_MAX_SLEEP_US;
+        }
+        // Due or nearly due deadline: fire as soon as the write is safe
+        if (target < now + delta)
+        {
+            target = now + delta;
+        }
+        timer_set_compare(timer_channel, (uint32_t)target);
+
+        // The counter must still be before the compare value once it is written
+        if ((int32_t)((uint32_t)target - timer_get_lower()) > 0)
+        {
+            break;
+        }
+        delta *= 2;
+    }
+}
+
+/**
+ * @brief Initializes the software timers on the specified System Timer channel.
+ * @description This function clears the timer slots, selects the compare channel and
+ *              registers its interrupt. The compare register is only programmed once a
+ *              timer is armed.
+ * 
+ * @param timer_idx The compare channel used by the software timers (TIMER_1 or TIMER_3).
+ */
+SECTION_INIT void timer_init(uint8_t timer_idx)
+{
+    uint64_t flags;
+    uint32_t i;
+
+    // Channels 0 and 2 are used by the VideoCore
+    if ((TIMER_1 != timer_idx) && (TIMER_3 != timer_idx))
+    {
+        return;
+    }
+
+    flags = spin_lock_irqsave(&timer_lock);
+    for (i = 0; i < TIMER_MAX_SOFT; i++)
+    {
+        timer_slots[i].heap_idx = TIMER_MAX_SOFT;
+        timer_slots[i].callback = 0;
+    }
+    timer_heap_size = 0;
+    timer_channel = timer_idx;
+    spin_unlock_irqrestore(&timer_lock, flags);
+
+    // Clear a stale match and route the channel to the IRQ dispatcher
+    timer_clear_interrupt(timer_idx);
+    irq_register(IRQ_GPU(timer_idx), timer_handle_irq, IRQ_PRIO_NORMAL);
+    timer_ready = 1;
+}
+
+/**
+ * @brief System Timer interrupt of the software timer channel.
+ */
+SECTION_HOT static void timer_handle_irq(void)
+{
+    handle_timer(timer_channel);
+}
+
 /**
  * @brief Handles the specified timer interrupt.
- * @description This function processes the interrupt for the specified timer. It clears 
- *              the interrupt flag and performs any necessary actions, such as resetting 
- *              the timer or executing related tasks.
+ * @description This function clears the interrupt flag of the channel, then runs every
+ *              software timer whose deadline has passed. A periodic timer is re-armed
+ *              before its callback runs, on its original phase (missed periods are
+ *              skipped, not replayed). The lock is released around each callback so
+ *              that it can add or cancel timers. The compare register is then
+ *              programmed for the next deadline.
  * 
  * @param timer_idx The index of the timer whose interrupt is being handled (e.g., TIMER_1, TIMER_3).
  */
 void handle_timer(uint8_t timer_idx)
 {
-    // Re-initialize the timer.
-    timer_init(timer_idx);
+    struct soft_timer *timer;
+    timer_callback_t callback;
+    void *arg;
+    uint64_t flags;
+    uint64_t now;
+
     // Clear the interrupt flag for the specified timer.
     timer_clear_interrupt(timer_idx);
+
+    flags = spin_lock_irqsave(&timer_lock);
+    now = timer_read_counter();
+    while ((timer_heap_size > 0) && (timer_heap[0]->deadline <= now))
+    {
+        timer = timer_heap[0];
+        callback = timer->callback;
+        arg = timer->arg;
+
+        timer_heap_remove(timer);
+        if (timer->period != 0)
+        {
+            // Re-arm on the original phase, skipping the periods already missed
+            do
+            {
+                timer->deadline += timer->period;
+            } while (timer->deadline <= now);
+            timer_heap_insert(timer);
+        }
+        else
+        {
+            // Release the one-shot slot and invalidate its identifier
+            timer->callback = 0;
+            timer->generation++;
+        }
+
+        spin_unlock_irqrestore(&timer_lock, flags);
+        callback(arg);
+        flags = spin_lock_irqsave(&timer_lock);
+
+        now = timer_read_counter();
+    }
+    timer_program();
+    spin_unlock_irqrestore(&timer_lock, flags);
 }
 
-void delay_micro_s(uint32_t µs)
+/**
+ * @brief Arms a software timer.
+ * 
+ * @param mode      TIMER_ONESHOT or TIMER_PERIODIC.
+ * @param µs        Delay before the first expiry, and period of a periodic timer (µs).
+ * @param callback  Function called on expiry.
+ * @param arg       Argument passed to the callback.
+ * 
+ * @return A timer identifier (>= 0), or -1 if all timers are in use or the period is 0.
+ */
+int timer_add(uint8_t mode, uint32_t µs, timer_callback_t callback, void *arg)
+{
+    struct soft_timer *timer = 0;
+    uint64_t flags;
+    uint32_t i;
+    int id;
+
+    // A zero period would re-arm forever in the interrupt handler
+    if ((0 == callback) || ((TIMER_PERIODIC == mode) && (0 == µs)))
+    {
+        return -1;
+    }
+
+    flags = spin_lock_irqsave(&timer_lock);
+
+    // Find a free slot
+    for (i = 0; i < TIMER_MAX_SOFT; i++)
+    {
+        if (0 == timer_slots[i].callback)
+        {
+            timer = &timer_slots[i];
+            break;
+        }
+    }
+    if (0 == timer)
+    {
+        spin_unlock_irqrestore(&timer_lock, flags);
+        return -1;
+    }
+
+    timer->deadline = timer_read_counter() + µs;
+    timer->period = (TIMER_PERIODIC == mode) ? µs : 0;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer_heap_insert(timer);
+
+    // Only a new nearest deadline moves the compare register
+    if (timer_heap[0] == timer)
+    {
+        timer_program();
+    }
+
+    // Identifier: slot index in the low byte, slot generation above it
+    id = (int)(((timer->generation & 0x7FFFFF) << 8) | i);
+    spin_unlock_irqrestore(&timer_lock, flags);
+
+    return id;
+}
+
+/**
+ * @brief Cancels a software timer.
+ * 
+ * @param id Identifier returned by timer_add().
+ * 
+ * @return 0 if the timer was cancelled, -1 if it is not armed.
+ */
+int timer_cancel(int id)
+{
+    struct soft_timer *timer;
+    uint32_t idx = (uint32_t)id & 0xFF;
+    uint64_t flags;
+
+    if ((id < 0) || (idx >= TIMER_MAX_SOFT))
+    {
+        return -1;
+    }
+    timer = &timer_slots[idx];
+
+    flags = spin_lock_irqsave(&timer_lock);
+    if ((timer->heap_idx == TIMER_MAX_SOFT) ||
+        ((timer->generation & 0x7FFFFF) != ((uint32_t)id >> 8)))
+    {
+        spin_unlock_irqrestore(&timer_lock, flags);
+        return -1;
+    }
+
+    // An early wake-up is harmless: the compare register is left as it is
+    timer_heap_remove(timer);
+    timer->callback = 0;
+    timer->generation++;
+    spin_unlock_irqrestore(&timer_lock, flags);
+
+    return 0;
+}
+
+/**
+ * @brief Software timer callback of sleep_until(): wakes the sleeping core.
+ * 
+ * @param arg Pointer to the sleeper's completion flag.
+ */
+static void sleep_wake(void *arg)
+{
+    *(volatile uint32_t *)arg = 1;
+    // The sleeper may be a task, or on another core in WFE
+    sched_send_event();
+}
+
+/**
+ * @brief Sleeps until a deadline.
+ * @description The completion flag lives on the sleeper's stack, so the function only
+ *              returns once the armed timer has fired. A core woken early (by another
+ *              event or interrupt) goes back to sleep; a task blocks in
+ *              sched_wait_event() so the other tasks run meanwhile.
+ * 
+ * @param deadline Deadline in timer_get_ticks() units (µs).
+ */
+void sleep_until(uint64_t deadline)
+{
+    volatile uint32_t fired;
+    uint64_t now = timer_get_ticks();
+    uint64_t sleep;
+
+    // Sleeping needs the timer interrupt: otherwise spin the whole wait
+    if (timer_ready && !irq_in_handler())
+    {
+        while (deadline > now + SLEEP_SPIN_US)
+        {
+            // Wake up SLEEP_SPIN_US early and spin the rest, for accuracy
+            sleep = deadline - now - SLEEP_SPIN_US;
+            if (sleep > TIMER_MAX_SLEEP_US)
+            {
+                sleep = TIMER_MAX_SLEEP_US;
+            }
+
+            fired = 0;
+            if (timer_add(TIMER_ONESHOT, (uint32_t)sleep, sleep_wake, (void *)&fired) < 0)
+            {
+                // No free timer: spin
+                break;
+            }
+            while (!fired)
+            {
+                // Other tasks run meanwhile
+                sched_wait_event();
+            }
+            now = timer_get_ticks();
+        }
+    }
+
+    // Spin the last microseconds
+    while (timer_get_ticks() < deadline)
+    {
+
+    }
+}
+
+/**
+ * @brief Sleeps for a number of microseconds.
+ * 
+ * @param µs Duration of the wait (µs).
+ */
+void sleep_us(uint32_t µs)
 {
-    uint64_t start = timer_get_ticks();
+    sleep_until(timer_get_ticks() + µs);
+}
 
-    while(timer_get_ticks() < start + µs) 
+/**
+ * @brief Busy-waits for a number of microseconds.
+ * 
+ * @param µs Duration of the wait (µs).
+ */
+void spin_us(uint32_t µs)
+{
+    uint64_t start;
+    uint64_t ticks;
+
+    if (local_timer_ready())
     {
+        // Generic timer: one system-register read per iteration, no MMIO
+        ticks = ((uint64_t)µs * local_timer_get_freq() + 999999) / 1000000;
+        start = local_timer_get_counter();
+        while ((local_timer_get_counter() - start) < ticks)
+        {
 
+        }
+        return;
     }
+
+    // Early boot: spin on the System Timer (1 MHz), one extra tick to round up
+    start = timer_read_counter();
+    while ((timer_read_counter() - start) <= µs)
+    {
+
+    }
+}
+
+/**
+ * @brief Waits for a number of microseconds.
+ * 
+ * @param µs Duration of the wait (µs).
+ */
+void delay_micro_s(uint32_t µs)
+{
+    sleep_us(µs);
 }
@@ -0,0 +1,106 @@
+/**
+ * @file        workqueue.c
+ * @brief       Cross-core work queue implementation.
+ * @description This file implements the bounded FIFO of work items declared in
+ *              workqueue.h. The head and tail indexes run freely and are masked
+ *              with WORK_QUEUE_SIZE - 1 when the storage is accessed.
+ * 
+ * @version     1.0
+ * @date        2026-10-14
+ */
+
+#include "workqueue.h"
+
+/**
+ * @brief Initializes an empty work queue.
+ * 
+ * @param wq Pointer to the work queue.
+ */
+void work_queue_init(struct work_queue *wq)
+{
+    // Release the lock and empty the queue.
+    wq->lock.lock = 0;
+    wq->head = 0;
+    wq->tail = 0;
+}
+
+/**
+ * @brief Appends a work item to a queue.
+ * 
+ * @param wq  Pointer to the work queue.
+ * @param fn  Function to run.
+ * @param arg Argument passed to the function.
+ * 
+ * @return 0 on success, -1 if the queue is full.
+ */
+int work_queue_push(struct work_queue *wq, work_fn_t fn, void *arg)
+{
+    uint64_t flags;
+    int ret = -1;
+
+    // Interrupt handlers may push too: keep IRQs off while holding the lock.
+    flags = spin_lock_irqsave(&wq->lock);
+
+    if ((wq->tail - wq->head) < WORK_QUEUE_SIZE)
+    {
+        // Store the item in the next free slot.
+        wq->items[wq->tail & (WORK_QUEUE_SIZE - 1)].fn = fn;
+        wq->items[wq->tail & (WORK_QUEUE_SIZE - 1)].arg = arg;
+        wq->tail++;
+        ret = 0;
+    }
+
+    spin_unlock_irqrestore(&wq->lock, flags);
+
+    return ret;
+}
+
+/**
+ * @brief Removes the oldest work item of a queue.
+ * 
+ * @param wq   Pointer to the work queue.
+ * @param item Filled with the removed item.
+ * 
+ * @return 1 if an item was removed, 0 if the queue is empty.
+ */
+int work_queue_pop(struct work_queue *wq, struct work_item *item)
+{
+    uint64_t flags;
+    int ret = 0;
+
+    flags = spin_lock_irqsave(&wq->lock);
+
+    if (wq->head != wq->tail)
+    {
+        // Copy the oldest item out and free its slot.
+        *item = wq->items[wq->head & (WORK_QUEUE_SIZE - 1)];
+        wq->head++;
+        ret = 1;
+    }
+
+    spin_unlock_irqrestore(&wq->lock, flags);
+
+    return ret;
+}
+
+/**
+ * @brief Runs all the items currently pending in a queue.
+ * 
+ * @param wq Pointer to the work queue.
+ * 
+ * @return The number of items run.
+ */
+uint32_t work_queue_run(struct work_queue *wq)
+{
+    struct work_item item;
+    uint32_t count = 0;
+
+    // Pop one item at a time so the lock is not held while the work runs.
+    while (work_queue_pop(wq, &item))
+    {
+        item.fn(item.arg);
+        count++;
+    }
+
+    return count;
+}